@@ -0,0 +1,548 @@
+/*
+ HEADLESS BENCHMARK
+ Renders every supported orbital at a set of grid resolutions and render modes in a hidden window (into an offscreen
+ framebuffer), flying the same scripted camera path each time instead of reading the keyboard, and reports:
+    startup: wall-clock time of grid evaluation, mesh generation and upload
+    frames:  frame time percentiles (CPU + GPU, every frame is finished with glFinish) and the GPU time of the spheres
+    memory:  resident set size at the start and the end of the run (and its peak during the run on Linux, the peak of
+             the process so far elsewhere) and the bytes uploaded to GPU buffers and textures
+
+ USAGE: orbital_benchmark [--modes baked,instanced,lod,gpu,impostor,volume,compact] [--grids 16,32,64] [--frames 300]
+                          [--max-n 3] [--no-culling] [--assets DIR] [--csv FILE]
+ The shaders and brick.png are read from DIR (by default the Debug folder next to the folder of the executable, like
+ the simulator). With --csv every run is also written as one CSV row.
+ */
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+#include "glad.h"
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Texture.h"
+#include "shaderClass.h"
+#include "VAO.h"
+#include "VBO.h"
+#include "EBO.h"
+#include "Camera.h"
+#include "Sphere.h"
+#include "Orbitals.h"
+#include "GpuDensity.h"
+#include "SphereLOD.h"
+#include "SphereChunks.h"
+#include "Profiler.h"
+#include "Assets.h"
+
+// Same view as the simulator
+const unsigned int WIDTH = 1700;
+const unsigned int HEIGHT = 1000;
+const float FOV = 45.0f;
+// Frames rendered before the measured ones (shader compilation, driver warm up)
+const int NUM_WARMUP_FRAMES = 10;
+
+// Render modes of the simulator (RenderMode in main.cpp); lod is INSTANCED with useSphereLODs, compact is BAKED_MESH with compactVertices
+const char* const MODE_NAMES[] = { "baked", "instanced", "lod", "gpu", "impostor", "volume", "compact" };
+enum BenchmarkMode { BENCH_BAKED_MESH, BENCH_INSTANCED, BENCH_INSTANCED_LODS, BENCH_GPU_DENSITY, BENCH_IMPOSTOR, BENCH_VOLUME, BENCH_BAKED_COMPACT, NUM_BENCH_MODES };
+
+// Camera quad and box of the impostor and volume modes (same as main.cpp)
+GLfloat impostorQuadVertices[] = { -1.0f, -1.0f,  1.0f, -1.0f,  1.0f, 1.0f,  -1.0f, 1.0f };
+GLuint impostorQuadIndices[] = { 0, 1, 2,  2, 3, 0 };
+GLuint volumeBoxIndices[] = { 4, 6, 2,  2, 0, 4,  1, 3, 7,  7, 5, 1,  1, 5, 4,  4, 0, 1,
+                              2, 6, 7,  7, 3, 2,  2, 3, 1,  1, 0, 2,  4, 5, 7,  7, 6, 4 };
+
+// Everything measured in one run
+struct BenchmarkResult
+{
+    int n, l, ml, numSpheres_per_side;
+    BenchmarkMode mode;
+    size_t numSpheres;
+    double evaluateMs = 0, meshMs = 0, uploadMs = 0;
+    double frameP50 = 0, frameP90 = 0, frameP99 = 0, frameMax = 0, gpuP50 = 0;
+    size_t avgInstances = 0, avgTriangles = 0;
+    double rssStartMB = 0, rssEndMB = 0, peakRSSMB = 0, gpuMB = 0;
+};
+
+// Camera position at t in [0, 1): one orbit around the nucleus that dives from outside the grid into it and back
+void followCameraPath(Camera& camera, float t)
+{
+    const float angle = 2 * PI * t;
+    const float distance = 4.0f + 6.0f * (0.5f + 0.5f * cos(angle));
+    camera.Position = glm::vec3(distance * sin(angle), 3.0f * sin(angle), distance * cos(angle));
+    camera.Orientation = glm::normalize(-camera.Position);
+}
+
+// Value below which fraction of the sorted values are
+double percentile(const std::vector<double>& sorted, double fraction)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = std::min(sorted.size() - 1, (size_t)(fraction * sorted.size()));
+    return sorted[index];
+}
+
+// Resident set size of the process right now in MB
+double currentRSSMB()
+{
+#ifdef __APPLE__
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t infoCount = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &infoCount) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.resident_size / (1024.0 * 1024.0);
+#else
+    // Total and resident pages
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0, residentPages = 0;
+    statm >> totalPages >> residentPages;
+    return residentPages * (double)sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+#endif
+}
+
+// Starts a new peak for peakRSSMB (Linux only, elsewhere the peak is always that of the whole process)
+void resetPeakRSS()
+{
+#ifdef __linux__
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+// Peak resident set size in MB since resetPeakRSS on Linux (VmHWM), of the process elsewhere
+// (ru_maxrss is in bytes on macOS and in KB elsewhere)
+double peakRSSMB()
+{
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::stod(line.substr(6)) / 1024.0;
+        }
+    }
+#endif
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+    return usage.ru_maxrss / 1024.0;
+#endif
+}
+
+// Splits "a,b,c" at the commas
+std::vector<std::string> splitList(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Uniforms every lit sphere shader needs (same light as the simulator)
+void setLightUniforms(Shader& shader)
+{
+    const glm::mat4 model = glm::mat4(1.0f);
+    shader.Activate();
+    glUniformMatrix4fv(shader.Uniform("model"), 1, GL_FALSE, glm::value_ptr(model));
+    glUniform4f(shader.Uniform("lightColor"), 1.0f, 1.0f, 1.0f, 1.0f);
+    glUniform3f(shader.Uniform("lightPos"), 5.0f, 5.0f, 5.0f);
+    glUniform1i(shader.Uniform("tex0"), 0);
+}
+
+// Sets up, renders numFrames frames along the camera path and deletes one (orbital, grid resolution, mode)
+BenchmarkResult runBenchmark(const Orbital& orbital, int numSpheres_per_side, BenchmarkMode mode, int numFrames, bool frustumCulling, const std::string& assetDir)
+{
+    BenchmarkResult result;
+    result.n = orbital.n;
+    result.l = orbital.l;
+    result.ml = orbital.ml;
+    result.numSpheres_per_side = numSpheres_per_side;
+    result.mode = mode;
+    result.numSpheres = (size_t)numSpheres_per_side * numSpheres_per_side * numSpheres_per_side;
+    Profiler profiler;
+    size_t gpuBytes = 0;
+    // Memory of this run only, not of the largest run before it
+    resetPeakRSS();
+    result.rssStartMB = currentRSSMB();
+
+    //------------------------------------ STARTUP ------------------------------------//
+    std::vector<SphereInstance> spheres;
+    std::vector<GLfloat> densityVolume;
+    {
+        CpuScope scope(profiler, "Grid evaluation");
+        if (mode == BENCH_VOLUME) {
+            densityVolume.resize(result.numSpheres);
+            evaluateDensityVolume(orbital, numSpheres_per_side, densityVolume.data());
+        } else if (mode != BENCH_GPU_DENSITY) {
+            spheres.resize(result.numSpheres);
+            orbital.evaluate(orbital, numSpheres_per_side, spheres.data());
+        }
+    }
+
+    std::vector<GLfloat> meshVertices;
+    std::vector<CompactVertex> compactVertices;
+    std::vector<GLuint> meshIndices;
+    {
+        CpuScope scope(profiler, "Sphere mesh generation");
+        if (mode == BENCH_BAKED_MESH) {
+            std::vector<GLuint> sphereIndices = generateSphereIndices();
+            meshVertices.resize(result.numSpheres * NUM_VERTICES_PER_SPHERE * NUM_FLOATS_PER_VERTEX);
+            writeSphereMeshVertices(spheres.data(), result.numSpheres, meshVertices.data());
+            meshIndices.resize(result.numSpheres * sphereIndices.size());
+            writeSphereMeshIndices(sphereIndices, result.numSpheres, meshIndices.data());
+        } else if (mode == BENCH_BAKED_COMPACT) {
+            std::vector<GLuint> sphereIndices = generateSphereIndices();
+            compactVertices.resize(result.numSpheres * NUM_VERTICES_PER_SPHERE);
+            writeCompactSphereMeshVertices(spheres.data(), result.numSpheres, compactVertices.data());
+            meshIndices.resize(result.numSpheres * sphereIndices.size());
+            writeSphereMeshIndices(sphereIndices, result.numSpheres, meshIndices.data());
+        } else if (mode == BENCH_IMPOSTOR) {
+            meshVertices.assign(std::begin(impostorQuadVertices), std::end(impostorQuadVertices));
+            meshIndices.assign(std::begin(impostorQuadIndices), std::end(impostorQuadIndices));
+        } else if (mode == BENCH_VOLUME) {
+            for (int corner = 0; corner < 8; corner++) {
+                meshVertices.push_back((corner & 1) ? GRID_HALF_EXTENT : -GRID_HALF_EXTENT);
+                meshVertices.push_back((corner & 2) ? GRID_HALF_EXTENT : -GRID_HALF_EXTENT);
+                meshVertices.push_back((corner & 4) ? GRID_HALF_EXTENT : -GRID_HALF_EXTENT);
+            }
+            meshIndices.assign(std::begin(volumeBoxIndices), std::end(volumeBoxIndices));
+        } else {
+            meshVertices = generateUnitSphereVertices();
+            meshIndices = generateSphereIndices();
+        }
+    }
+
+    CpuScope uploadScope(profiler, "Sphere upload");
+    const bool usesInstanceVBO = mode == BENCH_INSTANCED || mode == BENCH_IMPOSTOR;
+    const bool usesSphereChunks = usesInstanceVBO && frustumCulling;
+    VAO sphereVAO;
+    sphereVAO.Bind();
+    VBO meshVBO((mode == BENCH_BAKED_COMPACT) ? (GLfloat*)compactVertices.data() : meshVertices.data(),
+                meshVertices.size() * sizeof(GLfloat) + compactVertices.size() * sizeof(CompactVertex));
+    EBO meshEBO(meshIndices.data(), meshIndices.size() * sizeof(GLuint));
+    VBO instanceVBO((GLfloat*)spheres.data(), (usesInstanceVBO && !usesSphereChunks) ? spheres.size() * sizeof(SphereInstance) : 0);
+    gpuBytes += meshVertices.size() * sizeof(GLfloat) + compactVertices.size() * sizeof(CompactVertex) + meshIndices.size() * sizeof(GLuint);
+    if (mode == BENCH_BAKED_MESH) {
+        sphereVAO.LinkAttrib(meshVBO, 0, 3, GL_FLOAT, 11 * sizeof(float), (void*)0);
+        sphereVAO.LinkAttrib(meshVBO, 1, 3, GL_FLOAT, 11 * sizeof(float), (void*)(3 * sizeof(float)));
+        sphereVAO.LinkAttrib(meshVBO, 2, 2, GL_FLOAT, 11 * sizeof(float), (void*)(6 * sizeof(float)));
+        sphereVAO.LinkAttrib(meshVBO, 3, 3, GL_FLOAT, 11 * sizeof(float), (void*)(8 * sizeof(float)));
+    } else if (mode == BENCH_BAKED_COMPACT) {
+        sphereVAO.LinkAttrib(meshVBO, 0, 3, GL_SHORT, sizeof(CompactVertex), (void*)offsetof(CompactVertex, x), 0, GL_TRUE);
+        sphereVAO.LinkAttrib(meshVBO, 1, 4, GL_UNSIGNED_BYTE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, color), 0, GL_TRUE);
+        sphereVAO.LinkAttrib(meshVBO, 3, 2, GL_BYTE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, normal), 0, GL_TRUE);
+    } else if (mode == BENCH_IMPOSTOR) {
+        sphereVAO.LinkAttrib(meshVBO, 0, 2, GL_FLOAT, 2 * sizeof(float), (void*)0);
+    } else {
+        sphereVAO.LinkAttrib(meshVBO, 0, 3, GL_FLOAT, 3 * sizeof(float), (void*)0);
+    }
+    if (usesInstanceVBO) {
+        sphereVAO.LinkAttrib(instanceVBO, 1, 3, GL_FLOAT, sizeof(SphereInstance), (void*)offsetof(SphereInstance, red), 1);
+        sphereVAO.LinkAttrib(instanceVBO, 4, 4, GL_FLOAT, sizeof(SphereInstance), (void*)offsetof(SphereInstance, x), 1);
+    }
+    sphereVAO.Unbind();
+    meshVBO.Unbind();
+    meshEBO.Unbind();
+
+    SphereChunks sphereChunks;
+    if (usesSphereChunks) {
+        sphereChunks.Build(spheres.data(), spheres.size(), instanceVBO);
+        // The grouped source buffer and the visible buffer
+        gpuBytes += 2 * spheres.size() * sizeof(SphereInstance);
+    } else if (usesInstanceVBO) {
+        gpuBytes += spheres.size() * sizeof(SphereInstance);
+    }
+    SphereLODs sphereLODs;
+    sphereLODs.frustumCulling = frustumCulling;
+    if (mode == BENCH_INSTANCED_LODS) {
+        gpuBytes += spheres.size() * sizeof(SphereInstance);
+    }
+
+    const GLsizei volumeSize = (mode == BENCH_VOLUME) ? numSpheres_per_side : 0;
+    Texture volumeTex(densityVolume.data(), volumeSize, volumeSize, volumeSize, GL_TEXTURE1);
+    // GL_R16F
+    gpuBytes += densityVolume.size() * 2;
+    glFinish();
+    uploadScope.End();
+
+    //------------------------------------ SHADERS ------------------------------------//
+    Shader shader = (mode == BENCH_BAKED_MESH) ? Shader(assetDir + "/default.vert", assetDir + "/default.frag")
+                  : (mode == BENCH_GPU_DENSITY) ? Shader(assetDir + "/gpuDensity.vert", assetDir + "/default.frag")
+                  : (mode == BENCH_IMPOSTOR) ? Shader(assetDir + "/impostor.vert", assetDir + "/impostor.frag")
+                  : (mode == BENCH_VOLUME) ? Shader(assetDir + "/volume.vert", assetDir + "/volume.frag")
+                  : (mode == BENCH_BAKED_COMPACT) ? Shader(assetDir + "/compact.vert", assetDir + "/default.frag")
+                  : Shader(assetDir + "/instanced.vert", assetDir + "/default.frag");
+    setLightUniforms(shader);
+    if (mode == BENCH_GPU_DENSITY) {
+        setDensityUniforms(shader, orbital, numSpheres_per_side);
+    }
+    if (mode == BENCH_BAKED_COMPACT) {
+        shader.Activate();
+        glUniform1f(shader.Uniform("positionScale"), COMPACT_POSITION_SCALE);
+    }
+    if (mode == BENCH_VOLUME) {
+        shader.Activate();
+        glUniform1i(shader.Uniform("volume"), 1);
+        glUniform1i(shader.Uniform("volumeSize"), numSpheres_per_side);
+        glUniform1f(shader.Uniform("gridHalfExtent"), GRID_HALF_EXTENT);
+        glUniform1i(shader.Uniform("numSteps"), (int)(2 * sqrt(3.0f) * numSpheres_per_side));
+        glUniform1f(shader.Uniform("opacityScale"), 2.0f);
+    }
+
+    //------------------------------------ FRAMES ------------------------------------//
+    Camera camera(WIDTH, HEIGHT, glm::vec3(0.0f, 0.0f, 6.0f));
+    std::vector<double> frameTimes, gpuTimes;
+    size_t sumInstances = 0, sumTriangles = 0;
+    const size_t numIndices = meshIndices.size();
+    for (int frame = 0; frame < NUM_WARMUP_FRAMES + numFrames; frame++) {
+        const std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+        profiler.BeginFrame();
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        followCameraPath(camera, (float)std::max(0, frame - NUM_WARMUP_FRAMES) / numFrames);
+        camera.updateMatrix(FOV, 0.1f, 100.0f);
+        size_t numDrawnSpheres = result.numSpheres;
+        if (usesSphereChunks) {
+            sphereChunks.Cull(camera, instanceVBO);
+            numDrawnSpheres = sphereChunks.visibleCount;
+        }
+
+        profiler.BeginGpu("spheres");
+        shader.Activate();
+        glUniform3f(shader.Uniform("camPos"), camera.Position.x, camera.Position.y, camera.Position.z);
+        camera.Matrix(shader, "camMatrix");
+        sphereVAO.Bind();
+        if (mode == BENCH_INSTANCED_LODS) {
+            sphereLODs.Update(spheres.data(), spheres.size(), camera, FOV, frame == 0);
+            sphereLODs.Draw();
+            profiler.CountDraw(sphereLODs.lodCounts[0] + sphereLODs.lodCounts[1] + sphereLODs.lodCounts[2], sphereLODs.DrawnTriangles());
+        } else if (mode == BENCH_INSTANCED || mode == BENCH_IMPOSTOR) {
+            glDrawElementsInstanced(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, 0, numDrawnSpheres);
+            profiler.CountDraw(numDrawnSpheres, numDrawnSpheres * (numIndices / 3));
+        } else if (mode == BENCH_GPU_DENSITY) {
+            glDrawElementsInstanced(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, 0, result.numSpheres);
+            profiler.CountDraw(result.numSpheres, result.numSpheres * (numIndices / 3));
+        } else if (mode == BENCH_VOLUME) {
+            volumeTex.Bind();
+            glEnable(GL_CULL_FACE);
+            glCullFace(GL_FRONT);
+            glDisable(GL_DEPTH_TEST);
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, 0);
+            glDisable(GL_BLEND);
+            glEnable(GL_DEPTH_TEST);
+            glDisable(GL_CULL_FACE);
+            profiler.CountDraw(1, numIndices / 3);
+        } else {
+            glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, 0);
+            profiler.CountDraw(result.numSpheres, numIndices / 3);
+        }
+        profiler.EndGpu();
+
+        // Every frame is finished before the next one, so the frame time is the whole CPU + GPU cost
+        glFinish();
+        profiler.EndFrame();
+        const double frameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+        if (frame >= NUM_WARMUP_FRAMES) {
+            frameTimes.push_back(frameMs);
+            sumInstances += profiler.instances;
+            sumTriangles += profiler.triangles;
+        }
+        // The GPU times lag NUM_QUERY_FRAMES frames behind
+        if (frame >= NUM_WARMUP_FRAMES + NUM_QUERY_FRAMES) {
+            gpuTimes.push_back(profiler.gpuMs);
+        }
+    }
+
+    //------------------------------------ RESULTS ------------------------------------//
+    for (const std::pair<std::string, double>& cpuTime : profiler.cpuTimes) {
+        if (cpuTime.first == "Grid evaluation") result.evaluateMs = cpuTime.second;
+        if (cpuTime.first == "Sphere mesh generation") result.meshMs = cpuTime.second;
+        if (cpuTime.first == "Sphere upload") result.uploadMs = cpuTime.second;
+    }
+    std::sort(frameTimes.begin(), frameTimes.end());
+    std::sort(gpuTimes.begin(), gpuTimes.end());
+    result.frameP50 = percentile(frameTimes, 0.50);
+    result.frameP90 = percentile(frameTimes, 0.90);
+    result.frameP99 = percentile(frameTimes, 0.99);
+    result.frameMax = frameTimes.empty() ? 0 : frameTimes.back();
+    result.gpuP50 = percentile(gpuTimes, 0.50);
+    result.avgInstances = sumInstances / std::max(1, numFrames);
+    result.avgTriangles = sumTriangles / std::max(1, numFrames);
+    // While everything the run allocated is still alive
+    result.rssEndMB = currentRSSMB();
+    result.peakRSSMB = peakRSSMB();
+    result.gpuMB = gpuBytes / (1024.0 * 1024.0);
+
+    sphereVAO.Delete();
+    meshVBO.Delete();
+    meshEBO.Delete();
+    instanceVBO.Delete();
+    sphereChunks.Delete();
+    sphereLODs.Delete();
+    volumeTex.Delete();
+    shader.Delete();
+    profiler.Delete();
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    // Before anything runs the kernels, so that an AVX2 build says why instead of crashing on an older CPU
+    if (!cpuSupportsLanes()) {
+        std::cout << "This build needs a CPU with AVX2 and FMA. Rebuild with -DORBITAL_AVX2=OFF.\n";
+        return 1;
+    }
+    //------------------------------------ ARGUMENTS ------------------------------------//
+    // baked is left out by default: at 64^3 its mesh alone is over a GB
+    std::vector<std::string> modeNames = { "instanced", "lod", "gpu", "impostor", "volume" };
+    std::vector<int> grids = { 16, 32, 64 };
+    int numFrames = 300;
+    int maxN = 3;
+    bool frustumCulling = true;
+    std::string assetDir = dataDir() + "/Debug";
+    std::string csvPath;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        std::string value = (i + 1 < argc) ? argv[i + 1] : "";
+        if (arg == "--modes") { modeNames = splitList(value); i++; }
+        else if (arg == "--grids") { grids.clear(); for (const std::string& grid : splitList(value)) grids.push_back(std::stoi(grid)); i++; }
+        else if (arg == "--frames") { numFrames = std::stoi(value); i++; }
+        else if (arg == "--max-n") { maxN = std::stoi(value); i++; }
+        else if (arg == "--no-culling") { frustumCulling = false; }
+        else if (arg == "--assets") { assetDir = value; i++; }
+        else if (arg == "--csv") { csvPath = value; i++; }
+        else {
+            std::cout << "Unknown argument " << arg << ". See the top of benchmark.cpp for the usage.\n";
+            return 1;
+        }
+    }
+    std::vector<BenchmarkMode> modes;
+    for (const std::string& name : modeNames) {
+        const char* const* found = std::find(std::begin(MODE_NAMES), std::end(MODE_NAMES), name);
+        if (found == std::end(MODE_NAMES)) {
+            std::cout << "Unknown render mode " << name << ".\n";
+            return 1;
+        }
+        modes.push_back((BenchmarkMode)(found - std::begin(MODE_NAMES)));
+    }
+    for (int grid : grids) {
+        if (grid < 2) {
+            std::cout << "The grid needs at least 2 spheres per side.\n";
+            return 1;
+        }
+    }
+
+    //------------------------------------ HEADLESS CONTEXT ------------------------------------//
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    // The window is never shown; everything is drawn into the framebuffer below
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Orbital Benchmark", NULL, NULL);
+    if (window == NULL)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    gladLoadGL();
+    // Frames are never presented, so they are not limited by vsync either
+    glfwSwapInterval(0);
+
+    // Offscreen color and depth buffers the size of the simulator window (a hidden window's own pixels may be dropped)
+    GLuint framebuffer, colorBuffer, depthBuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WIDTH, HEIGHT);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, WIDTH, HEIGHT);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "Failed to create the offscreen framebuffer" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glViewport(0, 0, WIDTH, HEIGHT);
+    glEnable(GL_DEPTH_TEST);
+
+    // The unused brick texture of the simulator, which the sphere shaders still sample
+    Texture brickTex(assetDir + "/brick.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    brickTex.Bind();
+
+    //------------------------------------ RUNS ------------------------------------//
+    std::ofstream csv;
+    if (!csvPath.empty()) {
+        csv.open(csvPath);
+        csv << "n,l,ml,N,mode,spheres,evaluate_ms,mesh_ms,upload_ms,frame_p50_ms,frame_p90_ms,frame_p99_ms,frame_max_ms,"
+               "gpu_p50_ms,instances,triangles,rss_start_mb,rss_end_mb,rss_delta_mb,peak_rss_mb,gpu_mb\n";
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    for (int n = 1; n <= maxN; n++) {
+        for (int l = 0; l < n; l++) {
+            for (int ml = 0; ml <= l; ml++) {
+                const Orbital orbital = findOrbital(n, l, ml);
+                for (int grid : grids) {
+                    for (BenchmarkMode mode : modes) {
+                        std::cout << "\n(" << n << ", " << l << ", " << ml << ") N = " << grid << ", " << MODE_NAMES[mode] << ":\n";
+                        BenchmarkResult result = runBenchmark(orbital, grid, mode, numFrames, frustumCulling, assetDir);
+                        std::cout << "frame p50 " << result.frameP50 << " ms, p90 " << result.frameP90 << " ms, p99 " << result.frameP99
+                                  << " ms, max " << result.frameMax << " ms | GPU p50 " << result.gpuP50 << " ms | "
+                                  << result.avgInstances << " instances, " << result.avgTriangles << " triangles | RSS "
+                                  << result.rssStartMB << " -> " << result.rssEndMB << " MB (" << std::showpos
+                                  << result.rssEndMB - result.rssStartMB << std::noshowpos << " MB), peak "
+                                  << result.peakRSSMB << " MB, GPU buffers " << result.gpuMB << " MB\n";
+                        if (csv.is_open()) {
+                            csv << n << "," << l << "," << ml << "," << grid << "," << MODE_NAMES[mode] << "," << result.numSpheres << ","
+                                << result.evaluateMs << "," << result.meshMs << "," << result.uploadMs << ","
+                                << result.frameP50 << "," << result.frameP90 << "," << result.frameP99 << "," << result.frameMax << ","
+                                << result.gpuP50 << "," << result.avgInstances << "," << result.avgTriangles << ","
+                                << result.rssStartMB << "," << result.rssEndMB << "," << result.rssEndMB - result.rssStartMB << ","
+                                << result.peakRSSMB << "," << result.gpuMB << "\n";
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    brickTex.Delete();
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
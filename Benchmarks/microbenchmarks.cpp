@@ -0,0 +1,312 @@
+/*
+ MICROBENCHMARKS
+ Times the density and geometry kernels over grids of N^3 points and checks every fast variant against its
+ scalar reference. For each kernel and grid size it prints ns/point, million points/sec and, for the variants,
+ the largest difference from the reference relative to the largest reference value on the grid.
+    coordinates: r_of, theta_of and phi_of of every grid point
+    densities:   every _nlm_eq (scalar reference, with the coordinates above), densityBatch (SIMD) and
+                 evaluateGrid (SIMD + threads); the general engine per point and its cached grid loop
+    spheres:     the trigonometry of every vertex of every sphere (scalar reference), writeSphereVertices (the scale and
+                 move of the unit sphere template), writeSphereMeshVertices (threaded) and
+                 writeCompactSphereMeshVertices (threaded, quantized, decoded back to compare), per vertex
+ GPU variants are measured end to end by orbital_benchmark, which needs a GL context.
+
+ USAGE: orbital_microbenchmarks [--grids 16,32,64,128] [--repeats 3]
+ Every time is the fastest of the repeats.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Sphere.h"
+#include "Orbitals.h"
+#include "DensityKernels.h"
+#include "Wavefunction.h"
+
+// Scalar reference and batch kernel of one hand-fitted orbital
+struct DensityKernel
+{
+    int n, l, ml;
+    GLfloat (*scalar)(GLfloat r, GLfloat theta, GLfloat phi);
+    void (*batch)(const GLfloat* x, const GLfloat* y, const GLfloat* z, GLfloat* density, size_t count, GLfloat bohrPerUnit);
+};
+
+const DensityKernel kernels[] =
+{
+    { 1, 0, 0, _100_eq, densityBatch<1,0,0> },
+    { 2, 0, 0, _200_eq, densityBatch<2,0,0> },
+    { 2, 1, 0, _210_eq, densityBatch<2,1,0> },
+    { 2, 1, 1, _211_eq, densityBatch<2,1,1> },
+    { 3, 0, 0, _300_eq, densityBatch<3,0,0> },
+    { 3, 1, 0, _310_eq, densityBatch<3,1,0> },
+    { 3, 1, 1, _311_eq, densityBatch<3,1,1> },
+    { 3, 2, 0, _320_eq, densityBatch<3,2,0> },
+    { 3, 2, 1, _321_eq, densityBatch<3,2,1> },
+    { 3, 2, 2, _322_eq, densityBatch<3,2,2> },
+};
+
+// Higher orbitals that only the general engine evaluates
+const int generalOrbitals[][3] = { { 4, 2, 1 }, { 6, 3, 2 }, { 10, 5, 3 } };
+
+// Reference for writeSphereVertices: recomputes the sines and cosines of every vertex of the sphere
+void writeSphereVerticesTrig(const SphereInstance& sphere, GLfloat* vertices)
+{
+    const GLfloat sectorStep = 2 * M_PI / sectorCount;
+    const GLfloat stackStep = M_PI / stackCount;
+    for (int i_local = 0; i_local <= stackCount; ++i_local) {
+        const GLfloat stackAngle = M_PI / 2 - i_local * stackStep;
+        const GLfloat xy_unit = cosf(stackAngle), z_unit = sinf(stackAngle);
+        for (int j_local = 0; j_local <= sectorCount; ++j_local) {
+            const GLfloat sectorAngle = j_local * sectorStep;
+            const GLfloat normal[3] = { xy_unit * cosf(sectorAngle), xy_unit * sinf(sectorAngle), z_unit };
+            *vertices++ = sphere.x + sphere.radius * normal[0];
+            *vertices++ = sphere.y + sphere.radius * normal[1];
+            *vertices++ = sphere.z + sphere.radius * normal[2];
+            *vertices++ = sphere.red;
+            *vertices++ = sphere.green;
+            *vertices++ = sphere.blue;
+            *vertices++ = 0.0f;
+            *vertices++ = 0.0f;
+            *vertices++ = normal[0];
+            *vertices++ = normal[1];
+            *vertices++ = normal[2];
+        }
+    }
+}
+
+// Fastest wall-clock time of repeats calls of body, in ns
+double fastestNs(int repeats, const std::function<void()>& body)
+{
+    double fastest = 1e300;
+    for (int repeat = 0; repeat < repeats; repeat++) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        body();
+        fastest = std::min(fastest, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+    return fastest;
+}
+
+// Largest |value - reference| relative to the largest |reference|
+double relativeError(const std::vector<GLfloat>& value, const std::vector<GLfloat>& reference)
+{
+    double largestReference = 0, largestDifference = 0;
+    for (size_t i = 0; i < reference.size(); i++) {
+        largestReference = std::max(largestReference, (double)std::fabs(reference[i]));
+        largestDifference = std::max(largestDifference, (double)std::fabs(value[i] - reference[i]));
+    }
+    return largestReference > 0 ? largestDifference / largestReference : largestDifference;
+}
+
+// Decodes compact vertices back into the NUM_FLOATS_PER_VERTEX layout of writeSphereVertices the way compact.vert
+// and default.frag do (snorm16 positions, RGBA8 colors, octahedral normals normalized); compact vertices carry no
+// texcoord so it is taken from reference, which leaves only the quantization error to compare
+std::vector<GLfloat> decodeCompactVertices(const std::vector<CompactVertex>& compact, const std::vector<GLfloat>& reference)
+{
+    std::vector<GLfloat> vertices(compact.size() * NUM_FLOATS_PER_VERTEX);
+    for (size_t v = 0; v < compact.size(); v++) {
+        const CompactVertex& vertex = compact[v];
+        GLfloat* decoded = &vertices[v * NUM_FLOATS_PER_VERTEX];
+        // COORDINATES:
+        decoded[0] = std::max(vertex.x / 32767.0f, -1.0f) * COMPACT_POSITION_SCALE;
+        decoded[1] = std::max(vertex.y / 32767.0f, -1.0f) * COMPACT_POSITION_SCALE;
+        decoded[2] = std::max(vertex.z / 32767.0f, -1.0f) * COMPACT_POSITION_SCALE;
+        // COLORS:
+        decoded[3] = vertex.color[0] / 255.0f;
+        decoded[4] = vertex.color[1] / 255.0f;
+        decoded[5] = vertex.color[2] / 255.0f;
+        // TEXCOORDS:
+        decoded[6] = reference[v * NUM_FLOATS_PER_VERTEX + 6];
+        decoded[7] = reference[v * NUM_FLOATS_PER_VERTEX + 7];
+        // NORMALS: unfolded from the octahedron
+        GLfloat nx = std::max(vertex.normal[0] / 127.0f, -1.0f), ny = std::max(vertex.normal[1] / 127.0f, -1.0f);
+        const GLfloat nz = 1.0f - std::fabs(nx) - std::fabs(ny);
+        if (nz < 0) {
+            const GLfloat fx = (1.0f - std::fabs(ny)) * (nx >= 0 ? 1.0f : -1.0f);
+            ny = (1.0f - std::fabs(nx)) * (ny >= 0 ? 1.0f : -1.0f);
+            nx = fx;
+        }
+        const GLfloat length = std::sqrt(nx * nx + ny * ny + nz * nz);
+        decoded[8] = nx / length;
+        decoded[9] = ny / length;
+        decoded[10] = nz / length;
+    }
+    return vertices;
+}
+
+// Prints one result line; a negative error means the kernel is a reference
+void report(const std::string& name, int numPoints_per_side, double ns, size_t count, double error)
+{
+    std::cout << std::left << std::setw(34) << name << std::right << std::setw(6) << numPoints_per_side
+              << std::fixed << std::setprecision(2) << std::setw(12) << ns / count
+              << std::setw(12) << count / ns * 1e3;
+    if (error >= 0) {
+        std::cout << std::scientific << std::setprecision(2) << std::setw(12) << error;
+    }
+    std::cout << std::defaultfloat << "\n";
+}
+
+// Splits "a,b,c" at the commas
+std::vector<int> splitInts(const std::string& list)
+{
+    std::vector<int> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(std::stoi(item));
+        }
+    }
+    return items;
+}
+
+int main(int argc, char** argv)
+{
+    // Before anything runs the kernels, so that an AVX2 build says why instead of crashing on an older CPU
+    if (!cpuSupportsLanes()) {
+        std::cout << "This build needs a CPU with AVX2 and FMA. Rebuild with -DORBITAL_AVX2=OFF.\n";
+        return 1;
+    }
+    std::vector<int> grids = { 16, 32, 64, 128 };
+    int repeats = 3;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        std::string value = (i + 1 < argc) ? argv[i + 1] : "";
+        if (arg == "--grids") { grids = splitInts(value); i++; }
+        else if (arg == "--repeats") { repeats = std::max(1, std::stoi(value)); i++; }
+        else {
+            std::cout << "Unknown argument " << arg << ". See the top of microbenchmarks.cpp for the usage.\n";
+            return 1;
+        }
+    }
+
+    std::cout << std::left << std::setw(34) << "kernel" << std::right << std::setw(6) << "N" << std::setw(12) << "ns/point"
+              << std::setw(12) << "Mpoints/s" << std::setw(12) << "rel. error" << "\n";
+    for (int N : grids) {
+        if (N < 2) {
+            continue;
+        }
+        const size_t count = (size_t)N * N * N;
+        const GLfloat step = 2 * GRID_HALF_EXTENT / (N - 1);
+
+        // Grid points in scene units, in grid order ((i * N + j) * N + k)
+        std::vector<GLfloat> x(count), y(count), z(count);
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                for (int k = 0; k < N; k++) {
+                    const size_t index = ((size_t)i * N + j) * N + k;
+                    x[index] = -GRID_HALF_EXTENT + i * step;
+                    y[index] = -GRID_HALF_EXTENT + j * step;
+                    z[index] = -GRID_HALF_EXTENT + k * step;
+                }
+            }
+        }
+        std::vector<GLfloat> r(count), theta(count), phi(count);
+        std::vector<GLfloat> reference(count), density(count);
+        std::vector<SphereInstance> spheres(count);
+
+        //------------------------------------ COORDINATES ------------------------------------//
+        double ns = fastestNs(repeats, [&]() {
+            for (size_t p = 0; p < count; p++) {
+                r[p] = r_of(x[p], y[p], z[p]);
+                theta[p] = theta_of(x[p], y[p], z[p]);
+                phi[p] = phi_of(x[p], y[p], z[p]);
+            }
+        });
+        report("r_of + theta_of + phi_of", N, ns, count, -1);
+
+        //------------------------------------ HAND-FITTED DENSITIES ------------------------------------//
+        for (const DensityKernel& kernel : kernels) {
+            const Orbital orbital = findOrbital(kernel.n, kernel.l, kernel.ml);
+            const GLfloat bohrPerUnit = orbital.extentBohr / GRID_HALF_EXTENT;
+            const std::string name = "_" + std::to_string(kernel.n) + std::to_string(kernel.l) + std::to_string(kernel.ml) + "_eq";
+
+            // Scalar reference, coordinates included
+            ns = fastestNs(repeats, [&]() {
+                for (size_t p = 0; p < count; p++) {
+                    const GLfloat X = x[p] * bohrPerUnit, Y = y[p] * bohrPerUnit, Z = z[p] * bohrPerUnit;
+                    reference[p] = kernel.scalar(r_of(X, Y, Z), theta_of(X, Y, Z), phi_of(X, Y, Z));
+                }
+            });
+            report(name + " (scalar)", N, ns, count, -1);
+
+            ns = fastestNs(repeats, [&]() {
+                kernel.batch(x.data(), y.data(), z.data(), density.data(), count, bohrPerUnit);
+            });
+            report(name + " densityBatch (" + std::to_string(LANES) + " lanes)", N, ns, count, relativeError(density, reference));
+
+            ns = fastestNs(repeats, [&]() {
+                orbital.evaluate(orbital, N, spheres.data());
+            });
+            // The grid stores radius = step/1.5 * density / peakDensity
+            for (size_t p = 0; p < count; p++) {
+                density[p] = spheres[p].radius / (step / 1.5f) * orbital.peakDensity;
+            }
+            report(name + " evaluateGrid (threads)", N, ns, count, relativeError(density, reference));
+        }
+
+        //------------------------------------ GENERAL ENGINE ------------------------------------//
+        for (const int* quantumNumbers : generalOrbitals) {
+            const Orbital orbital = findOrbital(quantumNumbers[0], quantumNumbers[1], quantumNumbers[2]);
+            const std::string name = "(" + std::to_string(orbital.n) + "," + std::to_string(orbital.l) + "," + std::to_string(orbital.ml) + ")";
+
+            // Per point reference
+            ns = fastestNs(repeats, [&]() {
+                evaluateGeneralDensities(orbital, x.data(), y.data(), z.data(), reference.data(), count);
+            });
+            report(name + " general per point", N, ns, count, -1);
+
+            ns = fastestNs(repeats, [&]() {
+                orbital.evaluate(orbital, N, spheres.data());
+            });
+            for (size_t p = 0; p < count; p++) {
+                density[p] = spheres[p].radius / (step / 1.5f) * orbital.peakDensity;
+            }
+            report(name + " general cached grid", N, ns, count, relativeError(density, reference));
+        }
+
+        //------------------------------------ SPHERE GEOMETRY ------------------------------------//
+        // Per vertex; only the N^2 spheres of the middle slab of the grid so that the baked mesh stays small
+        const Orbital orbital = findOrbital(2, 1, 0);
+        orbital.evaluate(orbital, N, spheres.data());
+        const SphereInstance* slab = &spheres[(size_t)(N / 2) * N * N];
+        const size_t numSpheres = (size_t)N * N;
+        const size_t numVertices = numSpheres * NUM_VERTICES_PER_SPHERE;
+        std::vector<GLfloat> trigMesh(numVertices * NUM_FLOATS_PER_VERTEX);
+        std::vector<GLfloat> scalarMesh(numVertices * NUM_FLOATS_PER_VERTEX), threadedMesh(numVertices * NUM_FLOATS_PER_VERTEX);
+
+        ns = fastestNs(repeats, [&]() {
+            for (size_t s = 0; s < numSpheres; s++) {
+                writeSphereVerticesTrig(slab[s], &trigMesh[s * NUM_VERTICES_PER_SPHERE * NUM_FLOATS_PER_VERTEX]);
+            }
+        });
+        report("sphere vertices (trig per vertex)", N, ns, numVertices, -1);
+
+        ns = fastestNs(repeats, [&]() {
+            for (size_t s = 0; s < numSpheres; s++) {
+                writeSphereVertices(slab[s], &scalarMesh[s * NUM_VERTICES_PER_SPHERE * NUM_FLOATS_PER_VERTEX]);
+            }
+        });
+        report("writeSphereVertices (template)", N, ns, numVertices, relativeError(scalarMesh, trigMesh));
+
+        ns = fastestNs(repeats, [&]() {
+            writeSphereMeshVertices(slab, numSpheres, threadedMesh.data());
+        });
+        report("writeSphereMeshVertices (threads)", N, ns, numVertices, relativeError(threadedMesh, scalarMesh));
+
+        std::vector<CompactVertex> compactMesh(numVertices);
+        ns = fastestNs(repeats, [&]() {
+            writeCompactSphereMeshVertices(slab, numSpheres, compactMesh.data());
+        });
+        // Bounded by the quantization: half a step of snorm16 (of COMPACT_POSITION_SCALE), RGBA8 and the snorm8 normals
+        report("writeCompactSphereMeshVertices", N, ns, numVertices, relativeError(decodeCompactVertices(compactMesh, scalarMesh), scalarMesh));
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#ifndef ADAPTIVE_GRID_H
+#define ADAPTIVE_GRID_H
+
+#include"glad.h"
+#include<vector>
+
+#include"Sphere.h"
+#include"Orbitals.h"
+
+// Controls where the octree of evaluateAdaptive is refined
+// Densities are relative to the peak density of the orbital (1 = largest sphere)
+struct AdaptiveSettings
+{
+    // Every cell is split at least minDepth times (8^minDepth cells), so small lobes are not missed
+    int minDepth;
+    // No cell is split more than maxDepth times (the finest cells are 2^maxDepth per side)
+    int maxDepth;
+    // Cells whose largest sampled density is below this are empty and emit no sphere
+    GLfloat emptyThreshold;
+    // Cells are split while their sampled densities differ by more than this (nodal shells, lobe edges)
+    GLfloat refineThreshold;
+};
+
+// Settings whose finest cells are at least as small as the spacing of a numSpheres_per_side^3 grid
+AdaptiveSettings adaptiveSettingsFor(int numSpheres_per_side);
+
+// Samples an orbital onto an octree spanning the cube of the axes, writing one sphere per non-empty leaf cell
+// into sphereInstances (which is resized to the number of spheres). Each sphere's maximum radius follows its cell size.
+void evaluateAdaptive(const Orbital& orbital, const AdaptiveSettings& settings, std::vector<SphereInstance>& sphereInstances);
+
+#endif
@@ -0,0 +1,20 @@
+#pragma once
+
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include<string>
+
+// Folder of the running executable (the working directory if it cannot be found)
+std::string executableDir();
+// Folder the simulator keeps its files in, the parent of executableDir()
+// Its Debug folder holds the shaders and textures (where both the Xcode and the CMake builds copy them) and its
+// Cache folder the cached grids and programs, wherever the simulator is started from
+std::string dataDir();
+
+// GLSL source of a shader built into the executable (the CMake build embeds the Shaders folder), NULL if it is not
+const char* embeddedShaderSource(const std::string& name);
+// Source of the shader file at path: the embedded shader of the same name if there is one, otherwise the file
+std::string shaderSource(const std::string& path);
+
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+
+#ifndef ASYNC_FILE_WRITER_CLASS_H
+#define ASYNC_FILE_WRITER_CLASS_H
+
+#include<condition_variable>
+#include<cstddef>
+#include<cstdint>
+#include<fstream>
+#include<mutex>
+#include<string>
+#include<thread>
+#include<vector>
+
+// Bytes of each of the two buffers of an AsyncFileWriter
+const size_t ASYNC_WRITE_BUFFER_SIZE = 8 * 1024 * 1024;
+
+// Binary file written on a thread of its own, so that the caller can evaluate the next chunk while the last one is
+// written to disk. Write copies into one of two buffers; once it is full it is handed to the thread and Write goes on
+// filling the other one, only waiting if the thread is still busy with it.
+class AsyncFileWriter
+{
+public:
+    // Whether every byte so far was written (false once the file could not be created or a write failed)
+    bool good = false;
+    // Bytes passed to Write so far
+    uint64_t size = 0;
+
+    // Creates (or truncates) the file at path
+    AsyncFileWriter(const std::string& path);
+
+    // Appends bytes bytes of data to the file
+    void Write(const void* data, size_t bytes);
+    // Writes what is left, waits for the thread and closes the file; returns good
+    bool Close();
+private:
+    std::ofstream file;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable handedOver;
+    // The buffer the caller fills and the one the thread writes (empty when it is idle)
+    std::vector<char> filling, writing;
+    // Set by Close to make the thread return once writing is empty
+    bool closing = false;
+
+    // Hands filling to the thread, waiting until it is done with the buffer before
+    void flush();
+    // Body of the thread
+    void run();
+};
+
+#endif
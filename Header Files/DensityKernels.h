@@ -0,0 +1,174 @@
+#pragma once
+
+#ifndef DENSITY_KERNELS_H
+#define DENSITY_KERNELS_H
+
+#include"glad.h"
+#include<cmath>
+#include<cstddef>
+
+#if defined(__AVX2__)
+#include<immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include<arm_neon.h>
+#endif
+
+//------------------------------------ FLOAT LANES -------------------------------------------------//
+// A pack of LANES floats that is processed with one instruction: 8 with AVX2, 4 with NEON, 1 otherwise
+// +, - and * work directly on Lanes, everything else goes through the lanes* helpers
+#if defined(__AVX2__)
+typedef __m256 Lanes;
+const int LANES = 8;
+inline Lanes lanesSet(float v) { return _mm256_set1_ps(v); }
+inline Lanes lanesLoad(const float* p) { return _mm256_loadu_ps(p); }
+inline void lanesStore(float* p, Lanes v) { _mm256_storeu_ps(p, v); }
+inline Lanes lanesSqrt(Lanes v) { return _mm256_sqrt_ps(v); }
+inline Lanes lanesMax(Lanes a, Lanes b) { return _mm256_max_ps(a, b); }
+inline Lanes lanesFloor(Lanes v) { return _mm256_floor_ps(v); }
+// 2^n for integral n
+inline Lanes lanesPow2(Lanes n) { return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23)); }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+typedef float32x4_t Lanes;
+const int LANES = 4;
+inline Lanes lanesSet(float v) { return vdupq_n_f32(v); }
+inline Lanes lanesLoad(const float* p) { return vld1q_f32(p); }
+inline void lanesStore(float* p, Lanes v) { vst1q_f32(p, v); }
+inline Lanes lanesSqrt(Lanes v) { return vsqrtq_f32(v); }
+inline Lanes lanesMax(Lanes a, Lanes b) { return vmaxq_f32(a, b); }
+inline Lanes lanesFloor(Lanes v) { return vrndmq_f32(v); }
+// 2^n for integral n
+inline Lanes lanesPow2(Lanes n) { return vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23)); }
+#else
+typedef float Lanes;
+const int LANES = 1;
+inline Lanes lanesSet(float v) { return v; }
+inline Lanes lanesLoad(const float* p) { return *p; }
+inline void lanesStore(float* p, Lanes v) { *p = v; }
+inline Lanes lanesSqrt(Lanes v) { return std::sqrt(v); }
+inline Lanes lanesMax(Lanes a, Lanes b) { return std::fmax(a, b); }
+inline Lanes lanesFloor(Lanes v) { return std::floor(v); }
+// 2^n for integral n
+inline Lanes lanesPow2(Lanes n) { return std::ldexp(1.0f, (int)n); }
+#endif
+
+// e^x for x <= 0 (Cephes expf polynomial, about 1 ulp)
+inline Lanes lanesExp(Lanes x)
+{
+    x = lanesMax(x, lanesSet(-87.0f));
+    // e^x = 2^n * e^g with |g| <= ln(2)/2
+    Lanes n = lanesFloor(x * lanesSet(1.44269504088896341f) + lanesSet(0.5f));
+    Lanes g = x - n * lanesSet(0.693359375f) - n * lanesSet(-2.12194440e-4f);
+
+    Lanes p = lanesSet(1.9875691500e-4f);
+    p = p * g + lanesSet(1.3981999507e-3f);
+    p = p * g + lanesSet(8.3334519073e-3f);
+    p = p * g + lanesSet(4.1665795894e-2f);
+    p = p * g + lanesSet(1.6666665459e-1f);
+    p = p * g + lanesSet(5.0000001201e-1f);
+    p = p * (g * g) + g + lanesSet(1.0f);
+    return p * lanesPow2(n);
+}
+
+// Whether this CPU has the instructions the lanes were compiled for (AVX2 builds need Haswell or later)
+inline bool cpuSupportsLanes()
+{
+#if defined(__AVX2__) && (defined(__GNUC__) || defined(__clang__))
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+    return true;
+#endif
+}
+//---------------------------------- END FLOAT LANES -----------------------------------------------//
+
+//------------------------------- CARTESIAN DENSITIES ----------------------------------------------//
+// CartesianDensity<n, l, |ml|> is _nlm_eq rewritten in x, y, z and r (all in Bohr), with cos(theta) = z/r and
+// r sin(theta) = sqrt(x^2 + y^2), so that no acos/atan2 is needed:
+//     density = amplitude2 * polynomial(x, y, z, r) * e^(-decay * r)
+// amplitude2 is the square of the constants of _nlm_eq (including 1 / max_prob_amp)
+template<int N, int L, int ML> struct CartesianDensity;
+
+template<> struct CartesianDensity<1,0,0> {
+    static constexpr float amplitude2 = 1.0f / M_PI;
+    static constexpr float decay = 2.0f;
+    static Lanes polynomial(Lanes /*x*/, Lanes /*y*/, Lanes /*z*/, Lanes /*r*/) { return lanesSet(1.0f); }
+};
+template<> struct CartesianDensity<2,0,0> {
+    static constexpr float amplitude2 = (10.0f / 8) * (10.0f / 8) / (2 * M_PI);
+    static constexpr float decay = 1.0f;
+    static Lanes polynomial(Lanes /*x*/, Lanes /*y*/, Lanes /*z*/, Lanes r) { Lanes p = lanesSet(2.0f) - r; return p * p; }
+};
+template<> struct CartesianDensity<2,1,0> {
+    static constexpr float amplitude2 = 1.0f / (0.87f * 0.87f);
+    static constexpr float decay = 1.0f;
+    static Lanes polynomial(Lanes /*x*/, Lanes /*y*/, Lanes z, Lanes /*r*/) { return z * z; }
+};
+template<> struct CartesianDensity<2,1,1> {
+    static constexpr float amplitude2 = 1.0f / (0.75f * 0.75f);
+    static constexpr float decay = 1.0f;
+    static Lanes polynomial(Lanes x, Lanes y, Lanes /*z*/, Lanes /*r*/) { return x * x + y * y; }
+};
+template<> struct CartesianDensity<3,0,0> {
+    static constexpr float amplitude2 = 1.0f / (2.5f * 2.5f);
+    static constexpr float decay = 1.0f;
+    static Lanes polynomial(Lanes /*x*/, Lanes /*y*/, Lanes /*z*/, Lanes r) { Lanes p = lanesSet(27.0f) - lanesSet(18.0f) * r + lanesSet(2.0f) * r * r; return p * p; }
+};
+template<> struct CartesianDensity<3,1,0> {
+    static constexpr float amplitude2 = 1.0f / (4.0f * 4.0f);
+    static constexpr float decay = 2.0f / 3;
+    static Lanes polynomial(Lanes /*x*/, Lanes /*y*/, Lanes z, Lanes r) { Lanes p = (lanesSet(6.0f) - r) * z; return p * p; }
+};
+template<> struct CartesianDensity<3,1,1> {
+    static constexpr float amplitude2 = 1.0f / (4.5f * 4.5f);
+    static constexpr float decay = 2.0f / 3;
+    static Lanes polynomial(Lanes x, Lanes y, Lanes /*z*/, Lanes r) { Lanes p = lanesSet(6.0f) - r; return p * p * (x * x + y * y); }
+};
+template<> struct CartesianDensity<3,2,0> {
+    static constexpr float amplitude2 = 1.0f / (9.2f * 9.2f);
+    static constexpr float decay = 2.0f / 3;
+    static Lanes polynomial(Lanes /*x*/, Lanes /*y*/, Lanes z, Lanes r) { Lanes p = lanesSet(3.0f) * z * z - r * r; return p * p; }
+};
+template<> struct CartesianDensity<3,2,1> {
+    static constexpr float amplitude2 = 1.0f / (2.5f * 2.5f);
+    static constexpr float decay = 2.0f / 3;
+    static Lanes polynomial(Lanes x, Lanes y, Lanes z, Lanes /*r*/) { return (x * x + y * y) * z * z; }
+};
+template<> struct CartesianDensity<3,2,2> {
+    static constexpr float amplitude2 = 1.0f / (4.8f * 4.8f);
+    static constexpr float decay = 2.0f / 3;
+    static Lanes polynomial(Lanes x, Lanes y, Lanes /*z*/, Lanes /*r*/) { Lanes p = x * x + y * y; return p * p; }
+};
+//----------------------------- END CARTESIAN DENSITIES --------------------------------------------//
+
+// Evaluates the (n, l, |ml|) probability density at count points, LANES points at a time
+// x, y, z are in scene units and are converted to Bohr with bohrPerUnit
+template<int N, int L, int ML>
+void densityBatch(const GLfloat* x, const GLfloat* y, const GLfloat* z, GLfloat* density, size_t count, GLfloat bohrPerUnit)
+{
+    typedef CartesianDensity<N, L, ML> D;
+    const Lanes scale = lanesSet(bohrPerUnit);
+    const Lanes amplitude2 = lanesSet(D::amplitude2);
+    const Lanes decay = lanesSet(-D::decay);
+
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        Lanes X = lanesLoad(x + i) * scale;
+        Lanes Y = lanesLoad(y + i) * scale;
+        Lanes Z = lanesLoad(z + i) * scale;
+        Lanes R = lanesSqrt(X * X + Y * Y + Z * Z);
+        lanesStore(density + i, amplitude2 * D::polynomial(X, Y, Z, R) * lanesExp(decay * R));
+    }
+
+    // The last partial pack goes through a padded copy
+    if (i < count) {
+        GLfloat X[LANES] = {}, Y[LANES] = {}, Z[LANES] = {}, out[LANES];
+        for (size_t k = i; k < count; k++) {
+            X[k - i] = x[k]; Y[k - i] = y[k]; Z[k - i] = z[k];
+        }
+        densityBatch<N, L, ML>(X, Y, Z, out, LANES, bohrPerUnit);
+        for (size_t k = i; k < count; k++) {
+            density[k] = out[k - i];
+        }
+    }
+}
+
+#endif
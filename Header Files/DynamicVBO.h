@@ -0,0 +1,48 @@
+#pragma once
+
+#ifndef DYNAMIC_VBO_CLASS_H
+#define DYNAMIC_VBO_CLASS_H
+
+#include"glad.h"
+#include"VBO.h"
+
+// Number of regions of a DynamicVBO: the CPU writes one while the GPU can still be reading the others
+const int NUM_DYNAMIC_VBO_REGIONS = 3;
+
+// Vertex Buffer Object for data that is rewritten every frame (or every time the camera moves)
+// The buffer is a ring of NUM_DYNAMIC_VBO_REGIONS regions. Each frame maps the next region without synchronizing
+// with the GPU, and a fence per region makes sure a region is never written while a draw may still be reading it.
+// Attributes are linked like any VBO, with Offset() added to their offsets.
+class DynamicVBO : public VBO
+{
+public:
+    // Bytes of each region
+    GLsizeiptr regionSize;
+    // Region that was last mapped (the one the draws of this frame read)
+    int region = 0;
+
+    // Constructor that generates a ring of regions of regionSize bytes
+    DynamicVBO(GLsizeiptr regionSize);
+
+    // Moves on to the next region, waits until the GPU is done with it and maps its first size bytes for writing
+    // Returns NULL if size is 0
+    GLfloat* Map(GLsizeiptr size);
+    // Unmaps the region (the VBO is left bound)
+    void Unmap();
+    // Byte offset of the current region in the buffer
+    GLintptr Offset();
+    // Fences the current region; call after the draws that read it
+    void Fence();
+    // Reallocates the ring for regions of newRegionSize bytes
+    // The old storage is orphaned, so nothing waits for the draws that still read it
+    void Reserve(GLsizeiptr newRegionSize);
+    // Deletes the VBO and its fences
+    void Delete();
+private:
+    // Fence of the last draws that read each region (0 if there are none)
+    GLsync fences[NUM_DYNAMIC_VBO_REGIONS] = {};
+    // Deletes the fence of a region
+    void deleteFence(int r);
+};
+
+#endif
@@ -14,6 +14,9 @@ public:
     // Constructor that generates a Elements Buffer Object and links it to indices
     EBO(GLuint* indices, GLsizeiptr size);
 
+    // Reallocates the EBO to size bytes and fills it with indices (the VAO it belongs to must be bound)
+    void Resize(const GLuint* indices, GLsizeiptr size);
+
     // Binds the EBO
     void Bind();
     // Unbinds the EBO
@@ -0,0 +1,84 @@
+#pragma once
+
+#ifndef ELECTRON_CLOUD_H
+#define ELECTRON_CLOUD_H
+
+#include"glad.h"
+#include<cstddef>
+#include<cstdint>
+#include<vector>
+
+#include"VAO.h"
+#include"VBO.h"
+
+struct Orbital;
+
+// Electron positions drawn and uploaded per frame until the cloud is full
+const size_t ELECTRONS_PER_FRAME = 1 << 16;
+// Electron positions an ElectronCloud of ELECTRON_CLOUD mode holds on the GPU (4M, 32 MB)
+const size_t MAX_ELECTRONS = 1 << 22;
+// Positions drawn from one random stream; the streams of a batch are spread over the worker threads
+const size_t ELECTRON_STREAM_SAMPLES = 4096;
+// Bins of the tabulated distributions of r and cos(theta)
+const int SAMPLING_TABLE_SIZE = 4096;
+
+// Electron position, read by electron.vert
+struct ElectronPoint
+{
+    // Position / COMPACT_POSITION_SCALE as snorm16 (w is padding)
+    GLshort x, y, z, w;
+};
+
+// Draws electron positions from |psi_nlm|^2 by importance sampling
+// The density is separable: |psi|^2 dV = R_nl(r)^2 r^2 dr * |Y_lm|^2 dcos(theta) * dphi, and |Y_lm|^2 does not depend
+// on phi. So r and cos(theta) are each drawn by inverting their own tabulated CDF and phi is uniform; no sample is
+// ever rejected for its density, only the ones outside the axes are drawn again.
+// Every stream is a PCG32 generator with its own increment, so a batch gives the same positions on any number of threads.
+class ElectronSampler
+{
+public:
+    // Tabulates the distributions of orbital within the cube of the axes
+    void SetOrbital(const Orbital& orbital);
+    // Writes count positions into points, drawn from streams firstStream, firstStream + 1, ...
+    // (ELECTRON_STREAM_SAMPLES positions per stream, in parallel)
+    void Sample(uint64_t firstStream, size_t count, ElectronPoint* points) const;
+private:
+    // CDFs of r (in Bohr, from 0 to maxRadius) and of cos(theta) (from -1 to 1), SAMPLING_TABLE_SIZE + 1 entries each
+    std::vector<GLfloat> radialCdf, polarCdf;
+    GLfloat maxRadius = 0;
+    GLfloat unitsPerBohr = 1;
+};
+
+// Electron positions of the current orbital in a fixed size buffer on the GPU, drawn as points
+// Every frame adds ELECTRONS_PER_FRAME new positions behind the ones already there until the buffer is full, so the
+// cloud converges while the camera moves and the CPU never holds more than one batch.
+class ElectronCloud
+{
+public:
+    // Number of positions in the buffer
+    size_t count = 0;
+    // Number of positions the buffer holds
+    size_t capacity;
+
+    // Constructor that generates a buffer for capacity positions
+    ElectronCloud(size_t capacity);
+
+    // Starts a new cloud of orbital
+    void SetOrbital(const Orbital& orbital);
+    // Draws and uploads the next batch of positions (nothing once the buffer is full)
+    void Accumulate();
+    // Draws the positions as points with the bound shader (electron.vert and electron.frag)
+    void Draw();
+    // Deletes the buffer
+    void Delete();
+private:
+    ElectronSampler sampler;
+    VAO vao;
+    VBO vbo;
+    // First stream of the next batch
+    uint64_t nextStream = 0;
+    // Positions of the batch being uploaded (its capacity is reused every frame)
+    std::vector<ElectronPoint> batch;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#define GLM_ENABLE_EXPERIMENTAL
+
+#include<glm/glm.hpp>
+
+// The 6 clip planes of a view-projection matrix (left, right, bottom, top, near, far)
+// Each plane is (normal, distance) with the normal pointing into the frustum and normalized
+struct Frustum
+{
+    glm::vec4 planes[6];
+};
+
+// Extracts the clip planes of a view-projection matrix such as Camera::cameraMatrix
+Frustum frustumFromMatrix(const glm::mat4& viewProjection);
+// Whether a sphere is at least partly inside the frustum
+bool sphereInFrustum(const Frustum& frustum, const glm::vec3& center, float radius);
+// Whether an axis aligned box is at least partly inside the frustum (may be true for some boxes just outside a corner)
+bool boxInFrustum(const Frustum& frustum, const glm::vec3& boxMin, const glm::vec3& boxMax);
+
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+#ifndef GPU_DENSITY_H
+#define GPU_DENSITY_H
+
+#include"glad.h"
+
+#include"shaderClass.h"
+#include"Orbitals.h"
+
+// Uploads everything gpuDensity.vert needs to evaluate orbital on a numSpheres_per_side^3 grid
+// Switching orbitals only calls this again: no sphere data is generated or uploaded on the CPU
+void setDensityUniforms(Shader& shader, const Orbital& orbital, int numSpheres_per_side);
+
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+
+#ifndef GRID_EXPORT_H
+#define GRID_EXPORT_H
+
+#include"glad.h"
+#include<cstddef>
+#include<string>
+
+// Points evaluated and written per chunk of an export (1M points, 28 MB of spheres)
+const size_t EXPORT_CHUNK_POINTS = 1 << 20;
+
+// File formats of an export
+//     EXPORT_VOLUME: NRRD volume of float32 densities relative to the peak density, x fastest, spacing in Bohr
+//     EXPORT_PLY:    binary PLY point cloud, one vertex per sphere with float x, y, z, radius, density and uchar color
+//     EXPORT_GLTF:   glTF 2.0 point primitive (scene units), the spheres in a .bin next to the .gltf as SphereInstance
+//                    records: POSITION, _RADIUS and COLOR_0 read the same buffer with a stride of 28 bytes
+enum ExportFormat { EXPORT_VOLUME, EXPORT_PLY, EXPORT_GLTF };
+
+struct ExportSettings
+{
+    ExportFormat format;
+    // Quantum numbers and grid points per side
+    int n, l, ml;
+    int numPoints_per_side;
+    // Spheres of a lower density relative to the peak density are left out of point clouds
+    GLfloat minDensity;
+    // File to write (for glTF, the .bin is written next to it)
+    std::string path;
+};
+
+// Evaluates the orbital of settings a chunk of EXPORT_CHUNK_POINTS points at a time and streams every chunk to disk
+// while the next one is evaluated, so the grid is never held in memory. Returns false if the file could not be written.
+bool exportOrbital(const ExportSettings& settings);
+
+// Batch mode of the simulator, without a window:
+//     --export volume|ply|gltf --n N --l L --ml ML --grid SIDE --out FILE [--min-density D]
+// Returns the exit code of the program
+int runExportCommand(int argc, char** argv);
+
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+
+#ifndef GRID_WORKER_CLASS_H
+#define GRID_WORKER_CLASS_H
+
+#include"glad.h"
+#include<atomic>
+#include<cstddef>
+#include<string>
+#include<thread>
+#include<vector>
+
+#include"Sphere.h"
+#include"Orbitals.h"
+#include"OrbitalCache.h"
+#include"SpscQueue.h"
+
+// Spheres per side of the grid that is shown while the requested one is evaluated
+const int COARSE_SPHERES_PER_SIDE = 6;
+// Slabs that can wait in the queue of a GridWorker before the worker waits for the render thread
+const size_t GRID_SLAB_QUEUE_SIZE = 1024;
+
+// Slab of constant x of one level of a GridWorker, ready to be read from levels
+struct GridSlab
+{
+    // Level the slab belongs to and its spheres, levels[level][first, first + count)
+    int level;
+    size_t first, count;
+    // Whether this is the last slab of its level, and then the wall-clock time the level took
+    bool levelDone;
+    double levelMs;
+    // Whether the level was read from the orbital cache (then it is the only slab of the job, with no coarse level before it)
+    bool cached;
+};
+
+// Evaluates sphere grids on a background thread, coarse to fine
+// Each job evaluates a COARSE_SPHERES_PER_SIDE^3 grid first and then the requested one, a few slabs of constant x
+// at a time (in parallel), and hands every finished slab to the render thread through a lock-free queue.
+// A grid found in the orbital cache is published at once, without the coarse level.
+class GridWorker
+{
+public:
+    // Spheres per side of every level of the current job (the last one is the requested grid)
+    std::vector<int> levelSides;
+    // Spheres of every level, in grid order; a slab may only be read once Poll returned it
+    std::vector<std::vector<SphereInstance>> levels;
+
+    // Constructor that sets the cache directory (an empty one disables the cache)
+    GridWorker(std::string cacheDir);
+
+    // Cancels the current job, if any, and starts evaluating orbital on a numSpheres_per_side^3 grid
+    void Start(const Orbital& orbital, int numSpheres_per_side);
+    // Pops the next finished slab; returns false if there is none yet. Render thread only.
+    bool Poll(GridSlab& slab);
+    // Cancels the current job and waits for the thread to end
+    void Stop();
+private:
+    std::thread thread;
+    // Set to make the thread return after its current slabs
+    std::atomic<bool> cancel{false};
+    SpscQueue<GridSlab, GRID_SLAB_QUEUE_SIZE> slabs;
+    // Its own cache object, since the render thread may use another one at the same time
+    OrbitalCache orbitalCache;
+    bool useCache;
+
+    // Body of the thread
+    void run(Orbital orbital);
+    // Pushes a slab, waiting while the queue is full; returns false if cancelled meanwhile
+    bool publish(const GridSlab& slab);
+};
+
+#endif
@@ -0,0 +1,87 @@
+#pragma once
+
+#ifndef ISOSURFACE_CLASS_H
+#define ISOSURFACE_CLASS_H
+
+#include"glad.h"
+#include<GLFW/glfw3.h>
+#include<cstddef>
+#include<list>
+#include<string>
+#include<vector>
+
+#include"Sphere.h"
+
+// Cells per side of the blocks the grid is split into, one task per block
+const int ISOSURFACE_BLOCK_CELLS = 16;
+// Surfaces kept by an IsosurfaceExtractor (the least recently used one is dropped beyond that)
+const size_t MAX_CACHED_ISOSURFACES = 32;
+// Change of the iso levels per key press of an IsoLevelSelector (relative to the peak density)
+const GLfloat ISO_LEVEL_STEP = 0.02f;
+
+// Vertex of an isosurface: position in scene units and unit normal, pointing to lower densities
+struct IsosurfaceVertex
+{
+    GLfloat x, y, z;
+    GLfloat nx, ny, nz;
+};
+
+// Extracts surfaces of constant density from the density grid the spheres were evaluated on
+// The grid is taken from the spheres (or the density volume) as they are, so nothing is sampled again. Every cube of
+// the grid is split into 6 tetrahedra around its main diagonal (marching tetrahedra, so the surface has no cracks and
+// needs no case tables), blocks of ISOSURFACE_BLOCK_CELLS^3 cubes are triangulated in parallel, and every surface is
+// cached per grid and level, so only levels that were not extracted before cost anything.
+class IsosurfaceExtractor
+{
+public:
+    // Points per side of the current grid (0 if there is none)
+    int side = 0;
+
+    // Sets the grid to the densities of the spheres of an N^3 grid, in grid order (as written by orbital.evaluate)
+    // gridKey names the grid (orbital and resolution); a grid set before keeps the surfaces cached for it
+    void SetSphereGrid(const std::string& gridKey, const SphereInstance* spheres, int N);
+    // Same for the relative densities of an N^3 density volume, x fastest (as written by evaluateDensityVolume)
+    void SetVolumeGrid(const std::string& gridKey, const GLfloat* volume, int N);
+    // Returns the triangles (3 vertices each) where the density of the current grid relative to the peak density
+    // crosses level, extracting them unless they are cached. Valid until the next call.
+    const std::vector<IsosurfaceVertex>& Extract(GLfloat level);
+    // Whether the last Extract was served from the cache
+    bool lastWasCached = false;
+private:
+    // Relative densities of the current grid, (i * side + j) * side + k with x = i
+    std::vector<GLfloat> densities;
+    std::string gridKey;
+    // Cached surfaces, most recently used first
+    struct CachedSurface
+    {
+        std::string gridKey;
+        long levelKey;
+        std::vector<IsosurfaceVertex> vertices;
+    };
+    std::list<CachedSurface> cache;
+    // Triangles of every block of the last extraction (their capacity is reused by the next one)
+    std::vector<std::vector<IsosurfaceVertex>> blockVertices;
+
+    // Triangulates the cubes of one block into vertices
+    void extractBlock(int block, GLfloat level, std::vector<IsosurfaceVertex>& vertices);
+};
+
+// Changes the iso levels from the keyboard while the simulation is running
+// . / , : every level +/- ISO_LEVEL_STEP
+class IsoLevelSelector
+{
+public:
+    // Currently selected levels (each one in (0, 1))
+    std::vector<GLfloat> levels;
+
+    // IsoLevelSelector constructor to set up initial levels
+    IsoLevelSelector(const std::vector<GLfloat>& levels);
+
+    // Handles iso level inputs, returns true when the levels changed this frame
+    bool Inputs(GLFWwindow* window);
+private:
+    // Whether each hotkey was held in the previous frame, so that holding a key only changes the levels once
+    bool wasPressed[2] = {};
+};
+
+#endif
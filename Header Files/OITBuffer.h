@@ -0,0 +1,46 @@
+#pragma once
+
+#ifndef OIT_BUFFER_CLASS_H
+#define OIT_BUFFER_CLASS_H
+
+#include"glad.h"
+#include"shaderClass.h"
+
+// Framebuffers of weighted blended order-independent transparency (McGuire and Bavoil 2013)
+// The opaque objects are drawn into opaqueFBO as usual. The translucent spheres are then drawn in any order into
+// transparentFBO, which shares its depth buffer: every fragment adds its weighted premultiplied color to accumTex
+// and multiplies the revealage (the alpha of accumTex) by 1 - alpha. Composite resolves the average color over the
+// opaque image on the default framebuffer, so no sphere is ever sorted.
+// OpenGL 3.3 has no per-attachment blend functions (glBlendFunci is 4.0), so both attachments share one separate
+// blend function: colors are added and alphas multiplied, with the sum of the weights kept in the red of weightTex.
+class OITBuffer
+{
+public:
+    // Opaque color + depth, and the accumulation targets + the same depth
+    GLuint opaqueFBO, transparentFBO;
+    // Renderbuffers of the opaque color and the shared depth
+    GLuint opaqueColor, depth;
+    // Sum of the weighted premultiplied colors (rgb) and revealage (a), on texture unit 2
+    GLuint accumTex;
+    // Sum of the weighted alphas (r), on texture unit 3
+    GLuint weightTex;
+    GLsizei width, height;
+
+    // Constructor that generates the framebuffers for a width * height viewport
+    OITBuffer(GLsizei width, GLsizei height);
+
+    // Binds opaqueFBO; clear and draw the opaque objects after this
+    void BeginOpaque();
+    // Binds transparentFBO, clears the accumulation and sets up blending (depth is tested, not written)
+    void BeginTransparent();
+    // Copies the opaque image to the default framebuffer and blends the resolved spheres over it
+    // compositeShader is oitComposite.vert and oitComposite.frag; restores the default depth and blend state
+    void Composite(Shader& compositeShader);
+    // Deletes the framebuffers and their attachments
+    void Delete();
+private:
+    // An empty VAO for the full screen triangle, whose corners come from gl_VertexID
+    GLuint screenVAO;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+
+#ifndef ORBITAL_CACHE_H
+#define ORBITAL_CACHE_H
+
+#include"glad.h"
+#include<cstddef>
+#include<cstdint>
+#include<string>
+
+#include"Sphere.h"
+#include"Orbitals.h"
+
+// Binary sidecar holding the evaluated sphere grid of one orbital, so that it does not have to be recomputed
+// One file per (n, |ml|, l, grid resolution): <cacheDir>/orbital_<n>_<l>_<|ml|>_<N>.bin, little endian:
+//     OrbitalCacheHeader (48 bytes)
+//     numSpheres SphereInstance records (x, y, z, radius, red, green, blue as 32-bit floats), in grid order
+// A file is only used if every field of its header matches what would be generated now
+const uint32_t ORBITAL_CACHE_VERSION = 1;
+
+struct OrbitalCacheHeader
+{
+    char magic[8];                  // "ORBCACHE"
+    uint32_t version;               // ORBITAL_CACHE_VERSION
+    uint32_t instanceSize;          // sizeof(SphereInstance)
+    int32_t n, l, ml;               // Quantum numbers (ml is |ml|)
+    int32_t numSpheres_per_side;    // Grid resolution
+    float extentBohr;               // Scale of the axes
+    float gridHalfExtent;           // GRID_HALF_EXTENT
+    uint64_t numSpheres;            // numSpheres_per_side^3
+};
+static_assert(sizeof(OrbitalCacheHeader) == 48, "OrbitalCacheHeader must match the documented file layout");
+
+class OrbitalCache
+{
+public:
+    // Directory the cache files are stored in
+    std::string cacheDir;
+
+    // Constructor that sets the cache directory (it is created on the first Store)
+    OrbitalCache(std::string cacheDir);
+
+    // Memory maps the cache file of orbital on a numSpheres_per_side^3 grid
+    // Returns the spheres inside the mapping, or NULL if there is no matching file. They stay valid until Unmap.
+    const SphereInstance* Map(const Orbital& orbital, int numSpheres_per_side);
+    // Unmaps the file mapped by Map, if any
+    void Unmap();
+    // Writes the cache file of orbital on a numSpheres_per_side^3 grid
+    void Store(const Orbital& orbital, int numSpheres_per_side, const SphereInstance* sphereInstances);
+private:
+    // Current mapping
+    void* mapping = NULL;
+    size_t mappingSize = 0;
+
+    // Path of the cache file of orbital on a numSpheres_per_side^3 grid
+    std::string path(const Orbital& orbital, int numSpheres_per_side);
+    // Header the cache file of orbital on a numSpheres_per_side^3 grid must have
+    OrbitalCacheHeader header(const Orbital& orbital, int numSpheres_per_side);
+};
+
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+
+#ifndef ORBITAL_COMPARISON_H
+#define ORBITAL_COMPARISON_H
+
+#include"glad.h"
+#include<vector>
+#include<glm/glm.hpp>
+
+#include"Sphere.h"
+#include"Orbitals.h"
+#include"OrbitalCache.h"
+
+// Distance between the centers of neighbouring orbitals of a comparison (their axes are 2 * GRID_HALF_EXTENT long)
+const GLfloat COMPARISON_SPACING = 2.5f * GRID_HALF_EXTENT;
+
+// Every orbital of shell n, one per (l, |ml|) since -ml has the same density as ml, in order of l and then ml
+std::vector<Orbital> shellOrbitals(int n);
+// Center of an orbital of shell n in the comparison: one row per l (l = 0 on top) and one column per |ml|,
+// all of it centered on the origin
+glm::vec3 comparisonOffset(const Orbital& orbital, int n);
+// Distance from the origin along +z at which a camera with a vertical field of view of fov degrees sees all of shell n
+GLfloat comparisonCameraDistance(int n, GLfloat fov);
+// Writes the spheres of every orbital of shell n back to back into sphereInstances, each moved to its comparisonOffset,
+// so that all of them are drawn from one instance buffer
+// Grids come from orbitalCache when it is not NULL (and are added to it); with adaptive each orbital is octree sampled
+void evaluateComparison(const std::vector<Orbital>& orbitals, int n, int numSpheres_per_side, bool adaptive,
+                        OrbitalCache* orbitalCache, std::vector<SphereInstance>& sphereInstances);
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#ifndef ORBITAL_SELECTOR_H
+#define ORBITAL_SELECTOR_H
+
+#include"glad.h"
+#include<GLFW/glfw3.h>
+#include<string>
+
+// Largest principal quantum number the prompt and the export command accept and the hotkeys go up to
+const int MAX_PRINCIPAL_QUANTUM_NUMBER = 10;
+
+// Parses text into value; false unless text is one integer that fits in an int (spaces around it are allowed)
+bool parseInt(const std::string& text, int& value);
+// Whether n, l and ml can be shown (0 <= l < n <= MAX_PRINCIPAL_QUANTUM_NUMBER, |ml| <= l); prints why not otherwise
+// Shared by the interactive prompt and the export command
+bool checkQuantumNumbers(int n, int l, int ml);
+
+// Changes the quantum numbers from the keyboard while the simulation is running
+// UP/DOWN : n +/- 1, RIGHT/LEFT : l +/- 1, ]/[ : ml +/- 1
+class OrbitalSelector
+{
+public:
+    // Currently selected quantum numbers (always an allowed combination)
+    int n;
+    int l;
+    int ml;
+
+    // OrbitalSelector constructor to set up initial values
+    OrbitalSelector(int n, int l, int ml);
+
+    // Handles orbital inputs, returns true when the quantum numbers changed this frame
+    bool Inputs(GLFWwindow* window);
+private:
+    // Whether each hotkey was held in the previous frame, so that holding a key only changes the orbital once
+    bool wasPressed[6] = {};
+};
+
+#endif
@@ -0,0 +1,236 @@
+#pragma once
+
+#ifndef ORBITALS_H
+#define ORBITALS_H
+
+#include"glad.h"
+#include<cmath>
+#include<vector>
+#include<algorithm>
+
+#include"Sphere.h"
+#include"DensityKernels.h"
+#include"Parallel.h"
+#include"ScratchArena.h"
+
+const float PI = M_PI;
+
+// The sphere grid always spans [-GRID_HALF_EXTENT, GRID_HALF_EXTENT] on each axis (the length of the axes)
+const GLfloat GRID_HALF_EXTENT = 5.00f;
+
+//------------------------------------ COORDINATES -------------------------------------------------//
+inline GLfloat r_of (GLfloat x, GLfloat y, GLfloat z) {
+    return sqrt(x*x + y*y + z*z);
+}
+inline GLfloat theta_of (GLfloat x, GLfloat y, GLfloat z) {
+    GLfloat r = sqrt(x*x + y*y + z*z);
+    return acos(z / r);
+}
+inline GLfloat phi_of (GLfloat x, GLfloat y, GLfloat z) {
+    return atan2(y, x);
+}
+
+//-----------------------------------EQUATIONS-----------------------------------------------------//
+// r -> distance from origin, theta -> polar angle, phi -> azimuthal angle
+// All return the probability DENSITY (wavefunction squared) as GLfloat
+
+// (n=1,l=0,ml=0)
+inline GLfloat _100_eq(GLfloat r, GLfloat theta, GLfloat phi) {
+    const GLfloat max_prob_amp = 1.0f * std::pow(10, 0); // Calculate manually
+
+    GLfloat wavefunction = 1 / max_prob_amp * exp(-r) / sqrt(PI);
+    return pow(wavefunction, 2);
+}
+
+// (n=2,l=0,ml=0)
+inline GLfloat _200_eq(GLfloat r, GLfloat theta, GLfloat phi) {
+    const GLfloat max_prob_amp = 1.0f * std::pow(10, -1); // Calculate manually
+
+    GLfloat wavefunction = 1 / max_prob_amp * 1/8 / pow(2.0*PI, 0.5) * (2-r) * exp(-r/2);
+    return pow(wavefunction, 2);
+}
+
+// (n=2,l=1,ml=0)
+inline GLfloat _210_eq(GLfloat r, GLfloat theta, GLfloat phi) {
+    const GLfloat max_prob_amp = 8.7f * std::pow(10, -1); // Calculate manually
+
+    GLfloat wavefunction = 1 / max_prob_amp * r * exp(-r/2) * cos(theta);
+    return pow(wavefunction, 2);
+}
+
+// (n=2,l=1,ml=+/-1)
+inline GLfloat _211_eq(GLfloat r, GLfloat theta, GLfloat phi) {
+    const GLfloat max_prob_amp = 7.5 * std::pow(10, -1); // Calculate manually
+
+    // The imaginary portion is not included here because in the probability density the conplex conjugate cancels it out.
+    GLfloat wavefunction = 1 / max_prob_amp * r * exp(-r/2) * sin(theta);
+    return pow(wavefunction, 2);
+}
+
+inline GLfloat _300_eq(GLfloat r, GLfloat theta, GLfloat phi) {
+    const GLfloat max_prob_amp = 25 * std::pow(10, -1); // Calculate manually
+
+    GLfloat wavefunction = 1 / max_prob_amp * (27 - 18*r + 2*r*r) * exp(-r/2);
+    return pow(wavefunction, 2);
+}
+
+inline GLfloat _310_eq(GLfloat r, GLfloat theta, GLfloat phi) {
+    const GLfloat max_prob_amp = 4 * std::pow(10, 0); // Calculate manually
+
+    GLfloat wavefunction = 1 / max_prob_amp * (6 - r) * r * exp(-r/3) * cos(theta);
+    return pow(wavefunction, 2);
+}
+
+inline GLfloat _311_eq(GLfloat r, GLfloat theta, GLfloat phi) {
+    const GLfloat max_prob_amp = 4.5 * std::pow(10, 0); // Calculate manually
+
+    GLfloat wavefunction = 1 / max_prob_amp * (6 - r) * r * exp(-r/3) * sin(theta);
+    return pow(wavefunction, 2);
+}
+
+inline GLfloat _320_eq(GLfloat r, GLfloat theta, GLfloat phi) {
+    const GLfloat max_prob_amp = 92.f * std::pow(10, -1); // Calculate manually
+
+    GLfloat wavefunction = 1 / max_prob_amp * pow(r,2) * exp(-r/3) * (3 * pow(cos(theta) , 2) - 1);
+    return pow(wavefunction, 2);
+}
+
+inline GLfloat _321_eq(GLfloat r, GLfloat theta, GLfloat phi) {
+    const GLfloat max_prob_amp = 25.f * std::pow(10, -1); // Calculate manually
+
+    GLfloat wavefunction = 1 / max_prob_amp * pow(r,2) * exp(-r/3) * sin(theta) * cos(theta);
+    return pow(wavefunction, 2);
+}
+
+inline GLfloat _322_eq(GLfloat r, GLfloat theta, GLfloat phi) {
+    const GLfloat max_prob_amp = 48.f * std::pow(10, -1); // Calculate manually
+
+    GLfloat wavefunction = 1 / max_prob_amp * pow(r,2) * exp(-r/3) * pow(sin(theta) , 2);
+    return pow(wavefunction, 2);
+}
+//-------------------------------END EQUATIONS-----------------------------------------------------//
+
+//------------------------------- ORBITAL DENSITIES ------------------------------------------------//
+// OrbitalDensity<n, l, |ml|>::of(r, theta, phi) is the probability density of that orbital with r in Bohr
+// This is the scalar reference for the vectorized CartesianDensity<n, l, |ml|> of DensityKernels.h
+template<int N, int L, int ML> struct OrbitalDensity;
+
+template<> struct OrbitalDensity<1,0,0> { static GLfloat of(GLfloat r, GLfloat theta, GLfloat phi) { return _100_eq(r, theta, phi); } };
+template<> struct OrbitalDensity<2,0,0> { static GLfloat of(GLfloat r, GLfloat theta, GLfloat phi) { return _200_eq(r, theta, phi); } };
+template<> struct OrbitalDensity<2,1,0> { static GLfloat of(GLfloat r, GLfloat theta, GLfloat phi) { return _210_eq(r, theta, phi); } };
+template<> struct OrbitalDensity<2,1,1> { static GLfloat of(GLfloat r, GLfloat theta, GLfloat phi) { return _211_eq(r, theta, phi); } };
+template<> struct OrbitalDensity<3,0,0> { static GLfloat of(GLfloat r, GLfloat theta, GLfloat phi) { return _300_eq(r, theta, phi); } };
+template<> struct OrbitalDensity<3,1,0> { static GLfloat of(GLfloat r, GLfloat theta, GLfloat phi) { return _310_eq(r, theta, phi); } };
+template<> struct OrbitalDensity<3,1,1> { static GLfloat of(GLfloat r, GLfloat theta, GLfloat phi) { return _311_eq(r, theta, phi); } };
+template<> struct OrbitalDensity<3,2,0> { static GLfloat of(GLfloat r, GLfloat theta, GLfloat phi) { return _320_eq(r, theta, phi); } };
+template<> struct OrbitalDensity<3,2,1> { static GLfloat of(GLfloat r, GLfloat theta, GLfloat phi) { return _321_eq(r, theta, phi); } };
+template<> struct OrbitalDensity<3,2,2> { static GLfloat of(GLfloat r, GLfloat theta, GLfloat phi) { return _322_eq(r, theta, phi); } };
+//----------------------------- END ORBITAL DENSITIES ----------------------------------------------//
+
+struct Orbital;
+
+// Samples an orbital onto a numSpheres_per_side^3 grid, writing one sphere per grid point into sphereInstances
+typedef void (*GridEvaluator)(const Orbital& orbital, int numSpheres_per_side, SphereInstance* sphereInstances);
+// Evaluates the probability density of an orbital at count points given in scene units
+typedef void (*DensityEvaluator)(const Orbital& orbital, const GLfloat* x, const GLfloat* y, const GLfloat* z, GLfloat* density, size_t count);
+
+// Describes how one orbital is displayed
+struct Orbital
+{
+    // Quantum numbers (ml matches both +ml and -ml, the densities are identical)
+    int n, l, ml;
+    // How many Bohr radii the axes extend to (the scale of the axes for this orbital)
+    GLfloat extentBohr;
+    // Probability density that is drawn with the maximum sphere radius
+    GLfloat peakDensity;
+    // Grid loop specialized for this orbital's density
+    GridEvaluator evaluate;
+    // Batch density evaluation specialized for this orbital
+    DensityEvaluator densities;
+};
+
+// Sets the radius and color of a sphere from its probability density relative to the peak density
+inline void setSphereDensity(SphereInstance& sphere, GLfloat probDensity, GLfloat step)
+{
+    // Conversion factor: step/1.5 => sphereRadius is maximum (subject to change)
+    sphere.radius = step/1.5f * probDensity;
+    sphere.red = 1.0f * (1-probDensity); // More red = lower prob density
+    sphere.green = 1.0f * probDensity;   // More green = higher prob density
+    sphere.blue = 0.2f;                  // Blue is constant for now
+}
+
+// Probability density relative to the peak density of a sphere written by setSphereDensity
+inline GLfloat sphereDensity(const SphereInstance& sphere)
+{
+    return sphere.green;
+}
+
+// Batch density evaluation of the hand-fitted orbitals
+template<int N, int L, int ML>
+void evaluateDensities(const Orbital& orbital, const GLfloat* x, const GLfloat* y, const GLfloat* z, GLfloat* density, size_t count)
+{
+    densityBatch<N, L, ML>(x, y, z, density, count, orbital.extentBohr / GRID_HALF_EXTENT);
+}
+
+// Grid loop shared by every hand-fitted orbital
+// The sphere at grid point (i, j, k) is written to sphereInstances[(i * numSpheres_per_side + j) * numSpheres_per_side + k]
+template<int N, int L, int ML>
+void evaluateGrid(const Orbital& orbital, int numSpheres_per_side, SphereInstance* sphereInstances)
+{
+    GLfloat step = 2 * GRID_HALF_EXTENT / (numSpheres_per_side - 1);
+    // conversion factor: GRID_HALF_EXTENT units = extentBohr Bohr radii
+    GLfloat bohrPerUnit = orbital.extentBohr / GRID_HALF_EXTENT;
+
+    // Slabs of constant x are evaluated in parallel, each one writing its own part of sphereInstances
+    ScratchArena* arenas = slabArenas();
+    parallelForSlabs(numSpheres_per_side, [&](unsigned int slab, size_t i_begin, size_t i_end) {
+        // The densities of a row of constant (i, j) are evaluated together; only z changes along a row
+        ScratchArena& arena = arenas[slab];
+        const ScratchMark mark = arena.Mark();
+        GLfloat* xRow = arena.Allocate<GLfloat>(numSpheres_per_side);
+        GLfloat* yRow = arena.Allocate<GLfloat>(numSpheres_per_side);
+        GLfloat* zRow = arena.Allocate<GLfloat>(numSpheres_per_side);
+        GLfloat* densityRow = arena.Allocate<GLfloat>(numSpheres_per_side);
+        for (int k = 0; k < numSpheres_per_side; k++) {
+            zRow[k] = -GRID_HALF_EXTENT + (k * step);
+        }
+
+        // Nested for loops traverse a cube centered on the origin in 3D space
+        for (size_t i = i_begin; i < i_end; i++) {
+            for (int j = 0; j < numSpheres_per_side; j++) {
+                // x,y,z is the center of the probability sphere
+                GLfloat x = -GRID_HALF_EXTENT + (i * step);
+                GLfloat y = -GRID_HALF_EXTENT + (j * step);
+                std::fill(xRow, xRow + numSpheres_per_side, x);
+                std::fill(yRow, yRow + numSpheres_per_side, y);
+                densityBatch<N, L, ML>(xRow, yRow, zRow, densityRow, numSpheres_per_side, bohrPerUnit);
+
+                SphereInstance* row = &sphereInstances[(i * numSpheres_per_side + j) * numSpheres_per_side];
+                for (int k = 0; k < numSpheres_per_side; k++) {
+                    row[k].x = x;
+                    row[k].y = y;
+                    row[k].z = zRow[k];
+                    setSphereDensity(row[k], densityRow[k] / orbital.peakDensity, step);
+                }
+            }
+        }
+        arena.Rewind(mark);
+    });
+}
+
+// Samples the probability density relative to the peak density of an orbital onto a numSamples_per_side^3 grid
+// with the same grid points as the spheres, but x fastest as a 3D texture expects:
+// the density at grid point (i, j, k) is written to volume[(k * numSamples_per_side + j) * numSamples_per_side + i]
+void evaluateDensityVolume(const Orbital& orbital, int numSamples_per_side, GLfloat* volume);
+
+// Evaluates the spheres [first, first + count) of a numSpheres_per_side^3 grid, numbered like orbital.evaluate numbers
+// them, into spheres[0, count) (in parallel), so that a grid can be evaluated a few slabs at a time
+void evaluateGridRange(const Orbital& orbital, int numSpheres_per_side, size_t first, size_t count, SphereInstance* spheres);
+// Same for the samples [first, first + count) of evaluateDensityVolume (x fastest), into volume[0, count)
+void evaluateDensityVolumeRange(const Orbital& orbital, int numSamples_per_side, size_t first, size_t count, GLfloat* volume);
+
+// Returns the description of the (n, l, ml) orbital
+// Orbitals without a hand-fitted entry use the general evaluators of Wavefunction.h
+Orbital findOrbital(int n, int l, int ml);
+
+#endif
@@ -0,0 +1,21 @@
+#pragma once
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include<cstddef>
+#include<functional>
+
+// Number of worker threads parallelFor splits work across (one per hardware thread)
+unsigned int numWorkerThreads();
+
+// Splits [0, count) into one contiguous slab per worker thread and calls body(begin, end) for every slab in parallel
+// Returns once every slab is done. Slabs never overlap, so each one can write its own part of a shared buffer.
+// The slabs run on a pool of numWorkerThreads() - 1 threads that is created once, by the first call, and on the
+// calling thread. Calls may come from several threads at once and from inside a slab.
+void parallelFor(size_t count, const std::function<void(size_t begin, size_t end)>& body);
+// Same as parallelFor, but also passes body the index of its slab (below numWorkerThreads()), e.g. to pick its arena
+// from slabArenas(). Slab 0 always runs on the calling thread.
+void parallelForSlabs(size_t count, const std::function<void(unsigned int slab, size_t begin, size_t end)>& body);
+
+#endif
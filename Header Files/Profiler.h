@@ -0,0 +1,115 @@
+#pragma once
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include"glad.h"
+#include<chrono>
+#include<cstddef>
+#include<fstream>
+#include<string>
+#include<utility>
+#include<vector>
+
+// GPU time queries are read this many frames after they were issued, so reading them never stalls the pipeline
+const int NUM_QUERY_FRAMES = 3;
+// The summary averages the frames of this many seconds
+const double SUMMARY_INTERVAL_SECONDS = 0.5;
+
+// Frame statistics: GPU time of named sections of the frame (GL_TIME_ELAPSED queries), wall-clock time of the frame,
+// instances and triangles drawn, and wall-clock times of named CPU scopes (grid evaluation, uploads...)
+// The frame stats are averaged into a one line summary and can be logged every frame as CSV or JSON
+class Profiler
+{
+public:
+    // Wall-clock time in ms of every CpuScope that ended, in order
+    std::vector<std::pair<std::string, double>> cpuTimes;
+    // Stats of the last frame (its GPU time is the latest one read back, NUM_QUERY_FRAMES frames old)
+    double frameMs = 0, gpuMs = 0;
+    size_t instances = 0, triangles = 0;
+    // Averages of the last summary interval
+    double avgFrameMs = 0, avgGpuMs = 0;
+    size_t avgInstances = 0, avgTriangles = 0;
+
+    // Constructor that does not log
+    Profiler();
+
+    // Logs the stats of every frame to path (JSON if path ends in ".json", CSV otherwise)
+    void OpenLog(const std::string& path);
+    // Starts a frame
+    void BeginFrame();
+    // Creates the section name ahead of its first BeginGpu, so that the CSV log has its column from the first frame
+    void AddGpuSection(const char* name);
+    // Starts timing the GPU work of a section of the frame (sections can not be nested)
+    void BeginGpu(const char* name);
+    // Stops timing the current section
+    void EndGpu();
+    // Adds one draw to the counters of this frame
+    void CountDraw(size_t instances, size_t triangles);
+    // Ends a frame (after the buffers are swapped, so the frame time includes waiting for them); returns whether the summary was updated
+    bool EndFrame();
+    // One line summary of the averages ("16.7 ms frame (60.0 fps) | 3.2 ms GPU ...")
+    std::string Summary();
+    // Records the wall-clock time of a CPU scope (and prints it)
+    void RecordCpu(const std::string& name, double ms);
+    // Deletes the queries and closes the log
+    void Delete();
+private:
+    // A timed section of the frame: one query per frame of the ring
+    struct GpuSection
+    {
+        std::string name;
+        GLuint queries[NUM_QUERY_FRAMES];
+        bool issued[NUM_QUERY_FRAMES];
+        // Latest result in ms
+        double ms;
+        // Whether ms was read back this frame (false while the section is not drawn)
+        bool measured;
+    };
+    std::vector<GpuSection> sections;
+    int currentSection = -1;
+    // Frame of the ring the queries of this frame go to
+    int ringFrame = 0;
+    size_t frameNumber = 0;
+
+    std::chrono::steady_clock::time_point frameStart, summaryStart;
+
+    // Sums since the summary was last updated
+    double sumFrameMs = 0, sumGpuMs = 0;
+    size_t sumInstances = 0, sumTriangles = 0, summaryFrames = 0;
+
+    std::ofstream log;
+    std::string logPath;
+    bool logJson = false;
+    bool logHeaderWritten = false;
+    // Sections in the header of the CSV log
+    size_t loggedSections = 0;
+
+    // Index of the section name, created if there is none yet
+    int findSection(const char* name);
+    // Reads the queries of the ring frame that is reused next
+    void readQueries();
+    // Writes the CSV header with a column for every section
+    void writeCsvHeader();
+    // Rewrites the CSV log with the columns of the sections added since its header was written (empty in earlier rows)
+    void extendCsvLog();
+    // Writes the stats of the last frame to the log
+    void writeLog();
+};
+
+// Measures the wall-clock time from its construction to the end of its scope (or to End) and records it in a Profiler
+class CpuScope
+{
+public:
+    CpuScope(Profiler& profiler, const std::string& name);
+    // Records the time now, for scopes that can not end where the measured work does
+    void End();
+    ~CpuScope();
+private:
+    Profiler& profiler;
+    std::string name;
+    std::chrono::steady_clock::time_point start;
+    bool ended = false;
+};
+
+#endif
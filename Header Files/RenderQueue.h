@@ -0,0 +1,45 @@
+#pragma once
+
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include"glad.h"
+#include<glm/glm.hpp>
+#include<vector>
+
+#include"shaderClass.h"
+#include"Texture.h"
+#include"Camera.h"
+#include"Profiler.h"
+
+// One indexed draw of a RenderQueue
+struct DrawCommand
+{
+    // Program, vertex array (with its EBO) and texture (NULL for none) of the draw
+    Shader* shader;
+    GLuint vao;
+    Texture* texture;
+    // Model matrix of the draw (the "model" uniform of shader)
+    glm::mat4 model;
+    // Number of GL_UNSIGNED_INT indices, read from the start of the EBO of vao (as triangles)
+    GLsizei count;
+};
+
+// Collects the opaque draws of a frame and issues them sorted by program, vertex array and texture, so each one is
+// only bound when it differs from the previous draw; the camera matrix and position are exported once per program.
+// The spheres are drawn outside of it, since every mode needs its own blend, depth and framebuffer state.
+class RenderQueue
+{
+public:
+    // Programs, vertex arrays and textures bound by the last Flush
+    int programChanges = 0, vaoChanges = 0, textureChanges = 0;
+
+    // Adds a draw to the queue
+    void Submit(const DrawCommand& command);
+    // Issues every draw submitted since the last Flush and empties the queue
+    void Flush(Camera& camera, Profiler& profiler);
+private:
+    std::vector<DrawCommand> commands;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+
+#ifndef SCRATCH_ARENA_CLASS_H
+#define SCRATCH_ARENA_CLASS_H
+
+#include<cstddef>
+#include<memory>
+#include<vector>
+
+// Position of a ScratchArena, to free everything allocated after it
+struct ScratchMark
+{
+    size_t block;
+    size_t used;
+};
+
+// Bump allocator for the temporaries of the generation loops (coordinate rows, density rows, lookup tables)
+// Allocating only moves a pointer and freeing rewinds it, so a loop that rewinds its arena every slab reuses the same
+// memory over and over. When a block runs out the next one is twice as large, and rewinding the arena to its start
+// merges all its blocks into one, so from the second build of a grid on an arena never touches the heap.
+class ScratchArena
+{
+public:
+    // Returns uninitialized room for count Ts, aligned for any scalar type, valid until the arena is rewound past it
+    template<typename T>
+    T* Allocate(size_t count)
+    {
+        return (T*)allocateBytes(count * sizeof(T));
+    }
+    // Current position of the arena
+    ScratchMark Mark();
+    // Frees everything allocated since mark was taken
+    void Rewind(ScratchMark mark);
+    // Bytes held by the arena
+    size_t Capacity();
+private:
+    // Blocks of memory (in max_align_t units, so every block is aligned for any scalar type) and their sizes in bytes
+    std::vector<std::unique_ptr<std::max_align_t[]>> blocks;
+    std::vector<size_t> blockSizes;
+    // Block allocations currently come from and bytes used in it
+    size_t block = 0;
+    size_t used = 0;
+
+    // Returns bytes bytes of the current block, moving on to (or adding) a larger block if they do not fit
+    void* allocateBytes(size_t bytes);
+};
+
+// Arenas of the calling thread, one per slab of parallelForSlabs (numWorkerThreads() of them)
+// A loop takes them on its own thread and every slab body uses the arena of its slab, which no other body touches.
+// The calling thread may also keep allocations of its own in the first one, as long as it rewinds it after the loop.
+// Loops on different threads get different arenas, but the body of a loop must not start another loop.
+ScratchArena* slabArenas();
+
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef SPHERE_H
+#define SPHERE_H
+
+#include"glad.h"
+#include<cstddef>
+#include<vector>
+
+// How many sectors and stacks each sphere has graphically
+const int sectorCount = 9;
+const int stackCount = 9;
+const int NUM_VERTICES_PER_SPHERE = 100;
+const int NUM_TRIANGLES_PER_SPHERE = 144;
+// Coordinates (3), color (3), texcoord (2) and normal (3) of a baked sphere vertex
+const int NUM_FLOATS_PER_VERTEX = 11;
+// Positions of compact vertices are stored as fractions of this (twice GRID_HALF_EXTENT, so that spheres on the
+// edge of the grid fit with room to spare)
+const GLfloat COMPACT_POSITION_SCALE = 10.0f;
+
+// Center, radius and color of a single probability density sphere
+// Tightly packed so an array of them can be uploaded as-is as a per-instance vertex attribute buffer
+struct SphereInstance
+{
+    GLfloat x, y, z;
+    GLfloat radius;
+    GLfloat red, green, blue;
+};
+
+// Quantized baked sphere vertex, 12 bytes instead of the 44 of NUM_FLOATS_PER_VERTEX floats (read by compact.vert)
+// The texcoord is dropped since the spheres are not textured
+struct CompactVertex
+{
+    // Position / COMPACT_POSITION_SCALE as snorm16
+    GLshort x, y, z;
+    // Unit normal, octahedral encoded as snorm8
+    GLbyte normal[2];
+    // RGBA8 color
+    GLubyte color[4];
+};
+
+// Generates the positions of a sphere of radius 1 centered on the origin (also its normals)
+// with (sectors+1)*(stacks+1) vertices
+std::vector<GLfloat> generateUnitSphereVertices(int sectors = sectorCount, int stacks = stackCount);
+// Writes the interleaved vertices (coordinates, color, texcoord, normal) of one complete sphere
+// directly into vertices, which must have room for NUM_VERTICES_PER_SPHERE * NUM_FLOATS_PER_VERTEX floats
+// Every sphere is a scaled and moved copy of one sectorCount x stackCount unit sphere built at compile time
+void writeSphereVertices(const SphereInstance& sphere, GLfloat* vertices);
+// Writes the vertices of count spheres back to back into vertices (in parallel, each sphere into its own slot)
+void writeSphereMeshVertices(const SphereInstance* spheres, size_t count, GLfloat* vertices);
+// Writes the compact vertices of one complete sphere into vertices, which must have room for NUM_VERTICES_PER_SPHERE of them
+void writeCompactSphereVertices(const SphereInstance& sphere, CompactVertex* vertices);
+// Writes the compact vertices of count spheres back to back into vertices (in parallel, each sphere into its own slot)
+void writeCompactSphereMeshVertices(const SphereInstance* spheres, size_t count, CompactVertex* vertices);
+// Writes the indices of count spheres back to back into indices, offsetting sphereIndices by NUM_VERTICES_PER_SPHERE per sphere
+void writeSphereMeshIndices(const std::vector<GLuint>& sphereIndices, size_t count, GLuint* indices);
+// Generates the CCW index list of the 2*sectors*(stacks-1) triangles of one sphere
+std::vector<GLuint> generateSphereIndices(int sectors = sectorCount, int stacks = stackCount);
+
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+
+#ifndef SPHERE_CHUNKS_H
+#define SPHERE_CHUNKS_H
+
+#include"glad.h"
+#include<cstddef>
+#include<vector>
+
+#include"VBO.h"
+#include"Camera.h"
+#include"Frustum.h"
+#include"Sphere.h"
+
+// The cube of the axes is split into CHUNKS_PER_SIDE^3 chunks for culling
+const int CHUNKS_PER_SIDE = 8;
+
+// Frustum culls instanced spheres a chunk at a time
+// The spheres are stored grouped by chunk in a source buffer on the GPU. Every time the camera moves, the chunks
+// inside the frustum are copied to the front of the instance buffer that is drawn (glCopyBufferSubData, no upload)
+class SphereChunks
+{
+public:
+    // Number of spheres at the front of the drawn instance buffer since the last Cull
+    size_t visibleCount = 0;
+
+    // Constructor that generates the source buffer
+    SphereChunks();
+
+    // Groups spheres by chunk, uploads them and resizes visibleVBO to hold all of them
+    // The buffers get room for capacity spheres (if that is more than count), so that Refresh can add spheres in place
+    void Build(const SphereInstance* spheres, size_t count, VBO& visibleVBO, size_t capacity = 0);
+    // Regroups and uploads only the chunks that spheres[firstChanged, count) fall in, after the spheres from
+    // firstChanged on were replaced or added (or removed). The chunks are ordered by x first, so with spheres in order
+    // of x (like a grid that is filled slab by slab) every chunk of a lower x than them keeps its part of the buffers.
+    // Falls back to Build when the spheres do not fit the buffers.
+    void Refresh(const SphereInstance* spheres, size_t count, size_t firstChanged, VBO& visibleVBO);
+    // Copies the spheres of the chunks inside the frustum of camera to the front of visibleVBO
+    // Nothing is done if the camera did not move since the last Cull or Build
+    void Cull(Camera& camera, VBO& visibleVBO);
+    // Deletes the source buffer
+    void Delete();
+private:
+    // Spheres grouped by chunk
+    VBO sourceVBO;
+    // Number of spheres sourceVBO and the visible buffer have room for
+    size_t capacity = 0;
+    // First sphere of every chunk in sourceVBO (with one extra entry that is the total count)
+    std::vector<size_t> chunkFirst;
+    // Bounds of the spheres of every chunk
+    std::vector<glm::vec3> chunkMin;
+    std::vector<glm::vec3> chunkMax;
+    // Camera matrix of the last Cull
+    glm::mat4 lastCameraMatrix = glm::mat4(0.0f);
+
+    // Groups spheres[first, count), which all fall in firstChunk or a later chunk, into the chunks from firstChunk on
+    // and uploads them to sourceVBO behind the first spheres (the chunks before firstChunk must hold exactly those)
+    void group(const SphereInstance* spheres, size_t first, size_t count, int firstChunk);
+};
+
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+
+#ifndef SPHERE_LOD_H
+#define SPHERE_LOD_H
+
+#include"glad.h"
+#include<cstddef>
+#include<vector>
+
+#include"VAO.h"
+#include"VBO.h"
+#include"DynamicVBO.h"
+#include"EBO.h"
+#include"Camera.h"
+#include"Frustum.h"
+#include"Sphere.h"
+
+// Levels of detail of the instanced spheres, finest first
+const int NUM_SPHERE_LODS = 3;
+// Sectors and stacks of the unit sphere of each level of detail
+const int LOD_SEGMENTS[NUM_SPHERE_LODS] = { 24, 9, 4 };
+// Smallest projected radius (in pixels) that is drawn with each level of detail
+const GLfloat LOD_MIN_PIXEL_RADIUS[NUM_SPHERE_LODS] = { 24.0f, 4.0f, 0.0f };
+
+// Draws instanced spheres with a unit sphere mesh chosen per sphere by its size on screen
+// The spheres are grouped by level of detail in one instance buffer, and every level is one instanced draw
+// (instanced.vert, same attributes as the INSTANCED render mode)
+class SphereLODs
+{
+public:
+    // Number of spheres drawn with each level of detail since the last Update
+    size_t lodCounts[NUM_SPHERE_LODS] = {};
+    // Whether spheres outside the camera frustum are left out
+    bool frustumCulling = true;
+
+    // Constructor that generates and uploads the unit sphere of every level of detail
+    SphereLODs();
+
+    // Chooses the level of detail of every sphere from its projected radius and uploads them grouped by level
+    // (without the spheres outside the camera frustum when frustumCulling is on)
+    // Nothing is done if neither the camera nor the spheres changed since the last Update
+    void Update(const SphereInstance* spheres, size_t count, Camera& camera, float FOVdeg, bool spheresChanged);
+    // Draws every level of detail (the instanced shader must be active)
+    void Draw();
+    // Number of triangles Draw draws
+    size_t DrawnTriangles();
+    // Deletes the meshes and the instance buffer
+    void Delete();
+private:
+    // Mesh of each level of detail
+    std::vector<VAO> lodVAOs;
+    std::vector<VBO> lodVBOs;
+    std::vector<EBO> lodEBOs;
+    GLsizei lodIndexCounts[NUM_SPHERE_LODS];
+    // Spheres grouped by level of detail, finest first
+    // Written straight into the next region of the ring while the GPU may still draw the previous ones
+    DynamicVBO instanceVBO;
+    // Level of detail of every sphere (NUM_SPHERE_LODS when it is culled)
+    std::vector<unsigned char> sphereLODs;
+    // Camera matrix of the last Update
+    glm::mat4 lastCameraMatrix = glm::mat4(0.0f);
+};
+
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include<atomic>
+#include<cstddef>
+
+// Lock-free ring buffer that one thread pushes to and one other thread pops from
+// Holds up to Capacity - 1 items. Push publishes an item with a release store of the tail, and Pop acquires it,
+// so everything the producer wrote before Push is visible to the consumer after Pop.
+template<typename T, size_t Capacity>
+class SpscQueue
+{
+public:
+    // Adds item at the back; returns false (and adds nothing) if the queue is full. Producer thread only.
+    bool Push(const T& item)
+    {
+        const size_t currentTail = tail.load(std::memory_order_relaxed);
+        const size_t nextTail = (currentTail + 1) % Capacity;
+        if (nextTail == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        items[currentTail] = item;
+        tail.store(nextTail, std::memory_order_release);
+        return true;
+    }
+    // Removes the front item into item; returns false if the queue is empty. Consumer thread only.
+    bool Pop(T& item)
+    {
+        const size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[currentHead];
+        head.store((currentHead + 1) % Capacity, std::memory_order_release);
+        return true;
+    }
+private:
+    T items[Capacity];
+    // Next item to pop (written by the consumer) and next free slot (written by the producer)
+    std::atomic<size_t> head{0};
+    std::atomic<size_t> tail{0};
+};
+
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#ifndef SUPERPOSITION_H
+#define SUPERPOSITION_H
+
+#include"glad.h"
+#include<complex>
+#include<cstddef>
+#include<vector>
+
+// Most stationary states superposition.vert combines (two vec4 attributes of (re, im) pairs)
+const int MAX_SUPERPOSED_STATES = 4;
+
+// One stationary state |n l ml> of a superposition and its coefficient at t = 0
+struct SuperposedState
+{
+    int n, l, ml;
+    std::complex<double> coefficient;
+};
+
+// A superposition sum_s c_s psi_s(x) e^(-i E_s t) of hydrogen stationary states (atomic units, E_n = -1/(2n^2))
+struct Superposition
+{
+    // States with normalized coefficients (sum |c_s|^2 = 1)
+    std::vector<SuperposedState> states;
+    // How many Bohr radii the axes extend to (the largest extent of the states)
+    GLfloat extentBohr;
+    // Upper bound of the probability density at any time, drawn with the maximum sphere radius
+    GLfloat peakDensity;
+};
+
+// Grid point of a superposition with the cached spatial part psi_s(x) of every state
+// Tightly packed so an array of them can be uploaded as-is as a per-instance vertex attribute buffer
+struct SuperpositionInstance
+{
+    GLfloat x, y, z, unused;
+    // (re, im) of psi_s at this point for every state, 0 for the states the superposition does not have
+    GLfloat psi[2 * MAX_SUPERPOSED_STATES];
+};
+
+// Checks and normalizes states (at most MAX_SUPERPOSED_STATES allowed (n, l, ml)); returns false if there are none left
+bool buildSuperposition(const std::vector<SuperposedState>& states, Superposition& superposition);
+// Evaluates psi_s of every state once on a numSpheres_per_side^3 grid (grid order, like evaluateGrid) and sets peakDensity
+// After this, animating the superposition only needs superpositionPhases every frame
+void evaluateSuperposition(Superposition& superposition, int numSpheres_per_side, std::vector<SuperpositionInstance>& instances);
+// Writes c_s e^(-i E_s t) of every state as (re, im) pairs into phases (2 * MAX_SUPERPOSED_STATES floats), t in atomic time units
+void superpositionPhases(const Superposition& superposition, double t, GLfloat* phases);
+// Probability density at an instance for the phases of superpositionPhases (what superposition.vert computes)
+GLfloat superpositionDensity(const SuperpositionInstance& instance, const GLfloat* phases);
+
+#endif
@@ -7,6 +7,7 @@
 
 #include"glad.h"
 #include"stb_image.h"
+#include<future>
 
 #include"shaderClass.h"
 
@@ -15,15 +16,39 @@ class Texture
 public:
     GLuint ID;
     GLenum type;
+    // Texture unit the texture is bound to
+    GLenum unit;
+    // The image is decoded in the background and only uploaded by the first Bind, so a texture that is never
+    // drawn with costs no upload and the decode overlaps the rest of startup
     Texture(std::string image, GLenum texType, GLenum slot, GLenum format, GLenum pixelType);
+    // Single channel width x height x depth 3D texture (trilinear filtering, clamped at the edges) of float voxels
+    // The voxel (i, j, k) is read from voxels[(k * height + j) * width + i]
+    Texture(const GLfloat* voxels, GLsizei width, GLsizei height, GLsizei depth, GLenum slot);
+
+    // Replaces all the voxels of a 3D texture (same layout and size as the constructor)
+    void Update(const GLfloat* voxels, GLsizei width, GLsizei height, GLsizei depth);
 
     // Assigns a texture unit to a texture
     void texUnit(Shader& shader, const char* uniform, GLuint unit);
-    // Binds a texture
+    // Binds a texture to its texture unit
     void Bind();
     // Unbinds a texture
     void Unbind();
     // Deletes a texture
     void Delete();
+private:
+    // Pixels of an image decoded by stb_image (NULL bytes if it could not be read)
+    struct DecodedImage
+    {
+        unsigned char* bytes;
+        int width, height;
+    };
+    // Image of the first constructor until it is uploaded
+    std::shared_future<DecodedImage> pendingImage;
+    // Layout of the pixels of pendingImage
+    GLenum format = GL_RGBA, pixelType = GL_UNSIGNED_BYTE;
+
+    // Uploads pendingImage (waiting for its decode) and generates the mipmaps
+    void upload();
 };
 #endif
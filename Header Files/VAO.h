@@ -15,7 +15,9 @@ public:
     VAO();
 
     // Links a VBO Attribute such as a position or color to the VAO
-    void LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset);
+    // A non-zero divisor advances the attribute once per divisor instances instead of once per vertex
+    // Integer types are read as [-1, 1] (signed) or [0, 1] (unsigned) if normalized, as they are otherwise
+    void LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset, GLuint divisor = 0, GLboolean normalized = GL_FALSE);
     // Binds the VAO
     void Bind();
     // Unbinds the VAO
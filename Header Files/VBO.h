@@ -17,6 +17,12 @@ public:
     // Constructor that generates a Vertex Buffer Object and links it to vertices
     VBO(GLfloat* vertices, GLsizeiptr size);
 
+    // Overwrites size bytes of the VBO starting at offset, without reallocating it
+    void Update(const GLfloat* vertices, GLsizeiptr size, GLintptr offset = 0);
+    // Reallocates the VBO to size bytes and fills it with vertices
+    // (GL_STREAM_DRAW for buffers that are refilled every frame)
+    void Resize(const GLfloat* vertices, GLsizeiptr size, GLenum usage = GL_STATIC_DRAW);
+
     // Binds the VBO
     void Bind();
     // Unbinds the VBO
@@ -0,0 +1,41 @@
+#pragma once
+
+#ifndef WAVEFUNCTION_H
+#define WAVEFUNCTION_H
+
+#include"glad.h"
+#include<complex>
+#include<cstddef>
+
+#include"Sphere.h"
+
+struct Orbital;
+
+// Normalized radial wavefunction R_nl(r) of the hydrogen atom, r in Bohr
+// Built on the recurrence of the associated Laguerre polynomials L^(2l+1)_(n-l-1)
+double radialWavefunction(int n, int l, double r);
+// Associated Legendre polynomial P_l^|ml|(cos(theta)), without the (-1)^m Condon-Shortley phase
+double associatedLegendre(int l, int ml, double cosTheta);
+// Angular probability density |Y_l^ml(theta, phi)|^2 as a function of cos(theta)
+// Built on the recurrence of the associated Legendre polynomials P_l^|ml|. It does not depend on phi.
+double angularDensity(int l, int ml, double cosTheta);
+// Logarithm of the normalization constant of R_nl
+double logRadialNormalization(int n, int l);
+// Normalization constant of |Y_l^ml|^2
+double angularNormalization(int l, int ml);
+
+// Complex wavefunction psi_nlm = R_nl(r) Y_l^ml(theta, phi) at (x, y, z) in Bohr (the phase e^(i ml phi) depends on the sign of ml)
+std::complex<double> wavefunction(int n, int l, int ml, double x, double y, double z);
+
+// Largest probability density of (n, l, ml) within extentBohr of the nucleus
+// The density is separable, so this is the largest R_nl^2 times the largest |Y_lm|^2
+GLfloat generalPeakDensity(int n, int l, int ml, GLfloat extentBohr);
+
+// Batch density evaluation for any allowed (n, l, ml), with cos(theta) = z/r instead of acos
+void evaluateGeneralDensities(const Orbital& orbital, const GLfloat* x, const GLfloat* y, const GLfloat* z, GLfloat* density, size_t count);
+// Grid loop for any allowed (n, l, ml)
+// R_nl^2 is computed once per distinct distance from the origin and |Y_lm|^2 once per distinct polar angle
+// of the grid, so every grid point only costs two table lookups
+void evaluateGeneralGrid(const Orbital& orbital, int numSpheres_per_side, SphereInstance* sphereInstances);
+
+#endif
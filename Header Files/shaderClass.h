@@ -9,6 +9,9 @@
 #include<sstream>
 #include<iostream>
 #include<cerrno>
+#include<cstring>
+#include<unordered_map>
+#include<vector>
 #include <stdexcept>  // For runtime_error
 
 std::string get_file_contents(const char* filename);
@@ -16,18 +19,40 @@ std::string get_file_contents(const char* filename);
 class Shader
 {
 public:
+    // Folder linked programs are cached in (glGetProgramBinary), so that later runs skip compiling them; empty for none
+    static std::string programCacheDir;
+
     // Reference ID of the Shader Program
     GLuint ID;
+    // Whether the program was loaded from programCacheDir instead of compiled
+    bool fromCache = false;
     // Constructor that build the Shader Program from 2 different shaders
+    // The shaders embedded in the executable are used instead of the files of the same name (see Assets.h)
     Shader(std::string vertexFile, std::string fragmentFile);
+    // Empty Shader Program (ID 0), for a program the render settings never draw with
+    Shader();
 
+    // Location of a uniform, looked up once when the program is linked instead of by string every time it is set
+    // -1 if the program does not use it (which glUniform ignores, like a location from glGetUniformLocation)
+    GLint Uniform(const std::string& name) const;
     // Activates the Shader Program
     void Activate();
     // Deletes the Shader Program
     void Delete();
 private:
+    // Locations of every active uniform by name (arrays also by their name without [0])
+    std::unordered_map<std::string, GLint> uniformLocations;
+
     // Checks if the different Shaders have compiled properly
     void compileErrors(unsigned int shader, const char* type);
+    // Fills uniformLocations from the linked program
+    void cacheUniforms();
+    // Cache file of the program of vertexCode and fragmentCode for this driver, empty if programs are not cached
+    std::string programCachePath(const std::string& vertexCode, const std::string& fragmentCode);
+    // Links the program from its cache file, returns false if there is none or the driver rejects it
+    bool loadBinary(const std::string& cachePath);
+    // Writes the linked program to its cache file
+    void storeBinary(const std::string& cachePath);
 };
 
 
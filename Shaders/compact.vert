@@ -0,0 +1,51 @@
+// .vert
+#version 330 core
+
+// Positions/Coordinates as fractions of positionScale (snorm16)
+layout (location = 0) in vec3 aPos;
+// Colors (RGBA8)
+layout (location = 1) in vec4 aColor;
+// Octahedral encoded normals (snorm8)
+layout (location = 3) in vec2 aOctNormal;
+
+
+// Outputs the color for the Fragment Shader
+out vec3 color;
+// Outputs the texture coordinates to the Fragment Shader
+out vec2 texCoord;
+// Outputs the normal for the Fragment Shader
+out vec3 Normal;
+// Outputs the current position for the Fragment Shader
+out vec3 crntPos;
+
+// Imports the camera matrix from the main function
+uniform mat4 camMatrix;
+// Imports the model matrix from the main function
+uniform mat4 model;
+// COMPACT_POSITION_SCALE
+uniform float positionScale;
+
+// Unfolds a point of the octahedron back to a direction (the inverse of writeCompactSphereVertices)
+vec3 decodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0f - abs(e.x) - abs(e.y));
+    if (n.z < 0.0f) {
+        n.xy = (1.0f - abs(n.yx)) * vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    return n;
+}
+
+void main()
+{
+    // calculates current position
+    crntPos = vec3(model * vec4(aPos * positionScale, 1.0f));
+    // Outputs the positions/coordinates of all vertices
+    gl_Position = camMatrix * vec4(crntPos, 1.0);
+
+    // Assigns the colors from the Vertex Data to "color"
+    color = aColor.rgb;
+    // Spheres are not textured
+    texCoord = vec2(0.0f, 0.0f);
+    // Normalized in default.frag
+    Normal = decodeOctahedral(aOctNormal);
+}
@@ -0,0 +1,15 @@
+// .frag
+#version 330 core
+
+// Outputs colors in RGBA
+out vec4 FragColor;
+
+
+// Gets the color every electron position adds to its pixel from the main function
+uniform vec3 electronColor;
+
+void main()
+{
+    // The points are blended additively, so a pixel gets brighter with every electron position drawn on it
+    FragColor = vec4(electronColor, 1.0f);
+}
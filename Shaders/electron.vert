@@ -0,0 +1,19 @@
+// .vert
+#version 330 core
+
+// Positions/Coordinates as fractions of positionScale (snorm16)
+layout (location = 0) in vec3 aPos;
+
+// Imports the camera matrix from the main function
+uniform mat4 camMatrix;
+// Imports the model matrix from the main function
+uniform mat4 model;
+// COMPACT_POSITION_SCALE
+uniform float positionScale;
+
+
+void main()
+{
+    // Outputs the positions/coordinates of all electron positions
+    gl_Position = camMatrix * model * vec4(aPos * positionScale, 1.0f);
+}
@@ -0,0 +1,129 @@
+// .vert
+#version 330 core
+
+// Unit sphere Positions/Coordinates (also the normals, since the sphere has radius 1 around the origin)
+layout (location = 0) in vec3 aPos;
+
+
+// Outputs the color for the Fragment Shader
+out vec3 color;
+// Outputs the texture coordinates to the Fragment Shader
+out vec2 texCoord;
+// Outputs the normal for the Fragment Shader
+out vec3 Normal;
+// Outputs the current position for the Fragment Shader
+out vec3 crntPos;
+
+// Imports the camera matrix from the main function
+uniform mat4 camMatrix;
+// Imports the model matrix from the main function
+uniform mat4 model;
+
+// The grid is numSpheresPerSide^3 spheres spanning [-gridHalfExtent, gridHalfExtent] on each axis
+uniform int numSpheresPerSide;
+uniform float gridHalfExtent;
+// conversion factor: gridHalfExtent units = extentBohr Bohr radii
+uniform float bohrPerUnit;
+// Quantum numbers (ml is |ml|)
+uniform int n;
+uniform int l;
+uniform int ml;
+// 1 for the orbitals with an entry in the orbitals table of Orbitals.cpp (n <= 3), which use its equations
+uniform int handFitted;
+// Normalization constants of R_nl^2 and |Y_lm|^2 (only for the general wavefunction) divided by the peak density
+// (see setDensityUniforms)
+uniform float densityScale;
+
+
+// Wavefunction of a hand-fitted orbital at distance r (in Bohr), same as the _nlm_eq equations of Orbitals.h
+float handFittedWavefunction(float r, float cosTheta, float sinTheta)
+{
+    if (n == 1) {
+        return exp(-r) / sqrt(3.14159265f);
+    }
+    if (n == 2) {
+        if (l == 0) return 1.0f / 0.1f / 8.0f / sqrt(2.0f * 3.14159265f) * (2.0f - r) * exp(-r / 2.0f);
+        if (ml == 0) return 1.0f / 0.87f * r * exp(-r / 2.0f) * cosTheta;
+        return 1.0f / 0.75f * r * exp(-r / 2.0f) * sinTheta;
+    }
+    if (l == 0) return 1.0f / 2.5f * (27.0f - 18.0f * r + 2.0f * r * r) * exp(-r / 2.0f);
+    if (l == 1) {
+        if (ml == 0) return 1.0f / 4.0f * (6.0f - r) * r * exp(-r / 3.0f) * cosTheta;
+        return 1.0f / 4.5f * (6.0f - r) * r * exp(-r / 3.0f) * sinTheta;
+    }
+    if (ml == 0) return 1.0f / 9.2f * r * r * exp(-r / 3.0f) * (3.0f * cosTheta * cosTheta - 1.0f);
+    if (ml == 1) return 1.0f / 2.5f * r * r * exp(-r / 3.0f) * sinTheta * cosTheta;
+    return 1.0f / 4.8f * r * r * exp(-r / 3.0f) * sinTheta * sinTheta;
+}
+
+
+// Probability density relative to the peak density at p (in Bohr)
+// Same recurrences as radialWavefunction and angularDensity in Wavefunction.cpp, without the constants
+float relativeDensity(vec3 p)
+{
+    float r = length(p);
+    if (handFitted == 1) {
+        float cosThetaFit = (r > 0.0f) ? p.z / r : 1.0f;
+        float wavefunction = handFittedWavefunction(r, cosThetaFit, sqrt(max(0.0f, 1.0f - cosThetaFit * cosThetaFit)));
+        return densityScale * wavefunction * wavefunction;
+    }
+    float rho = 2.0f * r / float(n);
+
+    // L^(2l+1)_(n-l-1)(rho)
+    int alpha = 2 * l + 1;
+    float laguerre = 1.0f;
+    float laguerre_prev = 0.0f;
+    for (int j = 0; j < n - l - 1; j++) {
+        float laguerre_next = ((float(2 * j + 1 + alpha) - rho) * laguerre - float(j + alpha) * laguerre_prev) / float(j + 1);
+        laguerre_prev = laguerre;
+        laguerre = laguerre_next;
+    }
+    // rho^l, without pow(0, 0)
+    float rhoPow = 1.0f;
+    for (int j = 0; j < l; j++) {
+        rhoPow *= rho;
+    }
+    float radial = exp(-rho / 2.0f) * rhoPow * laguerre;
+
+    // P_l^ml(cos(theta))
+    float cosTheta = (r > 0.0f) ? p.z / r : 1.0f;
+    float sinTheta = sqrt(max(0.0f, 1.0f - cosTheta * cosTheta));
+    float legendre = 1.0f;
+    for (int j = 1; j <= ml; j++) {
+        legendre *= float(2 * j - 1) * sinTheta;
+    }
+    float legendre_prev = 0.0f;
+    for (int j = ml + 1; j <= l; j++) {
+        float legendre_next = (float(2 * j - 1) * cosTheta * legendre - float(j + ml - 1) * legendre_prev) / float(j - ml);
+        legendre_prev = legendre;
+        legendre = legendre_next;
+    }
+
+    return densityScale * radial * radial * legendre * legendre;
+}
+
+void main()
+{
+    // grid point (i, j, k) of this instance, in the same order as the CPU grid
+    int i = gl_InstanceID / (numSpheresPerSide * numSpheresPerSide);
+    int j = (gl_InstanceID / numSpheresPerSide) % numSpheresPerSide;
+    int k = gl_InstanceID % numSpheresPerSide;
+    float step = 2.0f * gridHalfExtent / float(numSpheresPerSide - 1);
+    vec3 center = vec3(-gridHalfExtent) + vec3(i, j, k) * step;
+
+    // Same mapping as setSphereDensity in Orbitals.h
+    float probDensity = relativeDensity(center * bohrPerUnit);
+    float radius = step / 1.5f * probDensity;
+
+    // scales and translates the unit sphere to the sphere of this instance
+    crntPos = vec3(model * vec4(center + radius * aPos, 1.0f));
+    // Outputs the positions/coordinates of all vertices
+    gl_Position = camMatrix * vec4(crntPos, 1.0);
+
+    // More red = lower prob density, more green = higher prob density
+    color = vec3(1.0f - probDensity, probDensity, 0.2f);
+    // Spheres are not textured
+    texCoord = vec2(0.0f, 0.0f);
+    // The unit sphere position is its own normal
+    Normal = aPos;
+}
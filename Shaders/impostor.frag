@@ -0,0 +1,62 @@
+// .frag
+#version 330 core
+
+// Outputs colors in RGBA
+out vec4 FragColor;
+
+
+// Imports the color from the Vertex Shader
+in vec3 color;
+// Imports the point of the quad the ray of this fragment goes through
+in vec3 crntPos;
+// Imports the sphere of this quad
+flat in vec4 sphere;
+
+// Gets the Texture Unit from the main function
+uniform sampler2D tex0;
+// Gets the color of the light from the main function
+uniform vec4 lightColor;
+// Gets the position of the light from the main function
+uniform vec3 lightPos;
+// Gets the position of the camera from the main function
+uniform vec3 camPos;
+// Imports the camera matrix from the main function
+uniform mat4 camMatrix;
+
+void main()
+{
+    // ray from the camera through this fragment against the sphere: |camPos + t * rayDirection - center| = radius
+    vec3 rayDirection = normalize(crntPos - camPos);
+    vec3 toCamera = camPos - sphere.xyz;
+    float b = dot(rayDirection, toCamera);
+    float c = dot(toCamera, toCamera) - sphere.w * sphere.w;
+    float discriminant = b * b - c;
+    if (discriminant < 0.0f) {
+        discard;
+    }
+    // nearest intersection is the visible surface
+    vec3 surfacePos = camPos + (-b - sqrt(discriminant)) * rayDirection;
+
+    // depth of the surface instead of the depth of the quad
+    vec4 clipPos = camMatrix * vec4(surfacePos, 1.0f);
+    gl_FragDepth = 0.5f * (clipPos.z / clipPos.w) * (gl_DepthRange.far - gl_DepthRange.near) + 0.5f * (gl_DepthRange.far + gl_DepthRange.near);
+
+    // Same lighting as default.frag, with the exact normal of the sphere
+    // ambient lighting
+    float ambient = 0.20f;
+
+    // diffuse lighting
+    vec3 normal = (surfacePos - sphere.xyz) / sphere.w;
+    vec3 lightDirection = normalize(lightPos - surfacePos);
+    float diffuse = max(dot(normal, lightDirection), 0.0f);
+
+    // specular lighting
+    float specularLight = 0.40f;
+    vec3 viewDirection = normalize(camPos - surfacePos);
+    vec3 reflectionDirection = reflect(-lightDirection, normal);
+    float specAmount = pow(max(dot(viewDirection, reflectionDirection), 0.0f), 8);
+    float specular = specAmount * specularLight;
+
+    // outputs final color (spheres have texture coordinates (0, 0) in every render mode)
+    FragColor = texture(tex0, vec2(0.0f, 0.0f)) * lightColor * (diffuse + ambient + specular);
+}
@@ -0,0 +1,48 @@
+// .vert
+#version 330 core
+
+// Quad corner, from (-1, -1) to (1, 1)
+layout (location = 0) in vec2 aCorner;
+// Per-sphere Colors
+layout (location = 1) in vec3 aColor;
+// Per-sphere center (xyz) and radius (w)
+layout (location = 4) in vec4 aSphere;
+
+
+// Outputs the color for the Fragment Shader
+out vec3 color;
+// Outputs the point of the quad the ray of this fragment goes through
+out vec3 crntPos;
+// Outputs the sphere of this quad
+flat out vec4 sphere;
+
+// Imports the camera matrix from the main function
+uniform mat4 camMatrix;
+// Imports the model matrix from the main function
+uniform mat4 model;
+// Gets the position of the camera from the main function
+uniform vec3 camPos;
+
+
+void main()
+{
+    vec3 center = vec3(model * vec4(aSphere.xyz, 1.0f));
+    float radius = aSphere.w;
+    sphere = vec4(center, radius);
+
+    // The quad faces the camera through the center of the sphere, and its half size is the radius of the
+    // silhouette cone from the camera in that plane: d * r / sqrt(d^2 - r^2)
+    vec3 toCamera = camPos - center;
+    float dist = length(toCamera);
+    vec3 forward = toCamera / dist;
+    vec3 right = normalize(cross(abs(forward.y) < 0.99f ? vec3(0.0f, 1.0f, 0.0f) : vec3(1.0f, 0.0f, 0.0f), forward));
+    vec3 up = cross(forward, right);
+    float halfSize = (dist > radius * 1.001f) ? dist * radius / sqrt(dist * dist - radius * radius) : 0.0f;
+
+    crntPos = center + halfSize * (aCorner.x * right + aCorner.y * up);
+    // Outputs the positions/coordinates of all vertices
+    gl_Position = camMatrix * vec4(crntPos, 1.0);
+
+    // Assigns the colors from the Instance Data to "color"
+    color = aColor;
+}
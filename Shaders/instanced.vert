@@ -0,0 +1,40 @@
+// .vert
+#version 330 core
+
+// Unit sphere Positions/Coordinates (also the normals, since the sphere has radius 1 around the origin)
+layout (location = 0) in vec3 aPos;
+// Per-sphere Colors
+layout (location = 1) in vec3 aColor;
+// Per-sphere center (xyz) and radius (w)
+layout (location = 4) in vec4 aSphere;
+
+
+// Outputs the color for the Fragment Shader
+out vec3 color;
+// Outputs the texture coordinates to the Fragment Shader
+out vec2 texCoord;
+// Outputs the normal for the Fragment Shader
+out vec3 Normal;
+// Outputs the current position for the Fragment Shader
+out vec3 crntPos;
+
+// Imports the camera matrix from the main function
+uniform mat4 camMatrix;
+// Imports the model matrix from the main function
+uniform mat4 model;
+
+
+void main()
+{
+    // scales and translates the unit sphere to the sphere of this instance
+    crntPos = vec3(model * vec4(aSphere.xyz + aSphere.w * aPos, 1.0f));
+    // Outputs the positions/coordinates of all vertices
+    gl_Position = camMatrix * vec4(crntPos, 1.0);
+
+    // Assigns the colors from the Instance Data to "color"
+    color = aColor;
+    // Spheres are not textured
+    texCoord = vec2(0.0f, 0.0f);
+    // The unit sphere position is its own normal
+    Normal = aPos;
+}
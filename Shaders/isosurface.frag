@@ -0,0 +1,41 @@
+// .frag
+#version 330 core
+
+// Outputs colors in RGBA
+out vec4 FragColor;
+
+
+// Imports the normal from the Vertex Shader
+in vec3 Normal;
+// Imports the current position from the Vertex Shader
+in vec3 crntPos;
+
+// Gets the color of the surface from the main function (alpha is its opacity)
+uniform vec4 surfaceColor;
+// Gets the color of the light from the main function
+uniform vec4 lightColor;
+// Gets the position of the light from the main function
+uniform vec3 lightPos;
+// Gets the position of the camera from the main function
+uniform vec3 camPos;
+
+void main()
+{
+    // ambient lighting
+    float ambient = 0.20f;
+
+    // diffuse lighting, the inside of the surface is lit like the outside
+    vec3 normal = normalize(gl_FrontFacing ? Normal : -Normal);
+    vec3 lightDirection = normalize(lightPos - crntPos);
+    float diffuse = max(dot(normal, lightDirection), 0.0f);
+
+    // specular lighting
+    float specularLight = 0.40f;
+    vec3 viewDirection = normalize(camPos - crntPos);
+    vec3 reflectionDirection = reflect(-lightDirection, normal);
+    float specAmount = pow(max(dot(viewDirection, reflectionDirection), 0.0f), 8);
+    float specular = specAmount * specularLight;
+
+    // outputs final color
+    FragColor = vec4(surfaceColor.rgb * lightColor.rgb * (diffuse + ambient + specular), surfaceColor.a);
+}
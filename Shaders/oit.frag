@@ -0,0 +1,56 @@
+// .frag
+#version 330 core
+
+// Weighted premultiplied color (rgb) and alpha (a, multiplied into the revealage by the blend function)
+layout (location = 0) out vec4 accum;
+// Weighted alpha (r, added up by the blend function)
+layout (location = 1) out vec4 weight;
+
+
+// Imports the color from the Vertex Shader
+in vec3 color;
+// Imports the texture coordinates from the Vertex Shader
+in vec2 texCoord;
+// Imports the normal from the Vertex Shader
+in vec3 Normal;
+// Imports the current position from the Vertex Shader
+in vec3 crntPos;
+
+// Gets the Texture Unit from the main function
+uniform sampler2D tex0;
+// Gets the color of the light from the main function
+uniform vec4 lightColor;
+// Gets the position of the light from the main function
+uniform vec3 lightPos;
+// Gets the position of the camera from the main function
+uniform vec3 camPos;
+// Alpha of a sphere at the peak density
+uniform float opacity;
+
+void main()
+{
+    // ambient lighting
+    float ambient = 0.20f;
+
+    // diffuse lighting
+    vec3 normal = normalize(Normal);
+    vec3 lightDirection = normalize(lightPos - crntPos);
+    float diffuse = max(dot(normal, lightDirection), 0.0f);
+
+    // specular lighting
+    float specularLight = 0.40f;
+    vec3 viewDirection = normalize(camPos - crntPos);
+    vec3 reflectionDirection = reflect(-lightDirection, normal);
+    float specAmount = pow(max(dot(viewDirection, reflectionDirection), 0.0f), 8);
+    float specular = specAmount * specularLight;
+
+    // the same lit color as default.frag
+    vec3 litColor = (texture(tex0, texCoord) * lightColor * (diffuse + ambient + specular)).rgb;
+    // green is the relative density of the sphere (setSphereDensity), so denser spheres are more opaque
+    float alpha = clamp(opacity * color.g, 0.0f, 1.0f);
+
+    // depth weight of McGuire and Bavoil (eq. 10): closer and more opaque fragments count more
+    float w = clamp(pow(min(1.0f, alpha * 10.0f) + 0.01f, 3.0f) * 1e8f * pow(1.0f - gl_FragCoord.z * 0.9f, 3.0f), 1e-2f, 3e3f);
+    accum = vec4(litColor * alpha * w, alpha);
+    weight = vec4(alpha * w, 0.0f, 0.0f, 0.0f);
+}
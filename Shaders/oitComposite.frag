@@ -0,0 +1,26 @@
+// .frag
+#version 330 core
+
+// Outputs colors in RGBA (blended as color * (1 - a) + opaque * a)
+out vec4 FragColor;
+
+// Imports the texture coordinates from the Vertex Shader
+in vec2 texCoord;
+
+// Weighted premultiplied color sums and revealage of the translucent spheres
+uniform sampler2D accum;
+// Weighted alpha sums of the translucent spheres
+uniform sampler2D weights;
+
+void main()
+{
+    vec4 accumulated = texture(accum, texCoord);
+    float revealage = accumulated.a;
+    // Nothing translucent in this pixel
+    if (revealage >= 1.0f) {
+        discard;
+    }
+    // Weighted average color of the spheres in this pixel
+    vec3 averageColor = accumulated.rgb / max(texture(weights, texCoord).r, 1e-5f);
+    FragColor = vec4(averageColor, revealage);
+}
@@ -0,0 +1,13 @@
+// .vert
+#version 330 core
+
+// Outputs the texture coordinates to the Fragment Shader
+out vec2 texCoord;
+
+void main()
+{
+    // One triangle that covers the screen, corners (-1, -1), (3, -1) and (-1, 3) from gl_VertexID (no vertex buffer)
+    vec2 corner = vec2((gl_VertexID == 1) ? 3.0f : -1.0f, (gl_VertexID == 2) ? 3.0f : -1.0f);
+    texCoord = corner * 0.5f + 0.5f;
+    gl_Position = vec4(corner, 0.0f, 1.0f);
+}
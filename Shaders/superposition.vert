@@ -0,0 +1,58 @@
+// .vert
+#version 330 core
+
+// Unit sphere Positions/Coordinates (also the normals, since the sphere has radius 1 around the origin)
+layout (location = 0) in vec3 aPos;
+// Per-sphere center (xyz)
+layout (location = 4) in vec4 aCenter;
+// Per-sphere cached spatial parts (re, im) of states 0 and 1, and of states 2 and 3
+layout (location = 5) in vec4 aPsi01;
+layout (location = 6) in vec4 aPsi23;
+
+
+// Outputs the color for the Fragment Shader
+out vec3 color;
+// Outputs the texture coordinates to the Fragment Shader
+out vec2 texCoord;
+// Outputs the normal for the Fragment Shader
+out vec3 Normal;
+// Outputs the current position for the Fragment Shader
+out vec3 crntPos;
+
+// Imports the camera matrix from the main function
+uniform mat4 camMatrix;
+// Imports the model matrix from the main function
+uniform mat4 model;
+// c_s e^(-i E_s t) of every state at the current time (0 for unused states)
+uniform vec2 phases[4];
+// Radius of the spheres at peakDensity (step / 1.5, like setSphereDensity)
+uniform float maxRadius;
+// Upper bound of the probability density of the superposition
+uniform float peakDensity;
+
+// (a.x + i a.y) (b.x + i b.y)
+vec2 complexMultiply(vec2 a, vec2 b)
+{
+    return vec2(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+}
+
+void main()
+{
+    // psi(x, t) = sum_s c_s e^(-i E_s t) psi_s(x)
+    vec2 psi = complexMultiply(phases[0], aPsi01.xy) + complexMultiply(phases[1], aPsi01.zw)
+             + complexMultiply(phases[2], aPsi23.xy) + complexMultiply(phases[3], aPsi23.zw);
+    float probDensity = clamp(dot(psi, psi) / peakDensity, 0.0f, 1.0f);
+
+    // scales and translates the unit sphere to the sphere of this instance
+    float radius = maxRadius * probDensity;
+    crntPos = vec3(model * vec4(aCenter.xyz + radius * aPos, 1.0f));
+    // Outputs the positions/coordinates of all vertices
+    gl_Position = camMatrix * vec4(crntPos, 1.0);
+
+    // More red = lower prob density, more green = higher prob density (same as setSphereDensity)
+    color = vec3(1.0f - probDensity, probDensity, 0.2f);
+    // Spheres are not textured
+    texCoord = vec2(0.0f, 0.0f);
+    // The unit sphere position is its own normal
+    Normal = aPos;
+}
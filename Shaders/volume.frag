@@ -0,0 +1,69 @@
+// .frag
+#version 330 core
+
+// Outputs colors in RGBA (premultiplied by alpha)
+out vec4 FragColor;
+
+
+// Imports the point of the box the ray of this fragment leaves through
+in vec3 crntPos;
+
+// Gets the relative probability densities of the grid from the main function
+uniform sampler3D volume;
+// Number of grid points per side of volume
+uniform int volumeSize;
+// The grid spans [-gridHalfExtent, gridHalfExtent] on each axis
+uniform float gridHalfExtent;
+// Number of samples along the diagonal of the box
+uniform int numSteps;
+// Opacity per scene unit of the peak density
+uniform float opacityScale;
+// Gets the position of the camera from the main function
+uniform vec3 camPos;
+
+// Same colors as the spheres: more red = lower prob density, more green = higher prob density
+// Near-zero densities are transparent so the empty space around the orbital stays black
+vec4 transfer(float density, float stepLength)
+{
+    vec3 color = vec3(1.0f - density, density, 0.2f);
+    // Beer-Lambert absorption over one step, so the look does not depend on numSteps
+    float alpha = 1.0f - exp(-opacityScale * density * stepLength);
+    return vec4(color, alpha);
+}
+
+void main()
+{
+    // ray from the camera through this fragment against the box (slab test)
+    vec3 rayDirection = normalize(crntPos - camPos);
+    vec3 t0 = (vec3(-gridHalfExtent) - camPos) / rayDirection;
+    vec3 t1 = (vec3(gridHalfExtent) - camPos) / rayDirection;
+    vec3 tMin = min(t0, t1);
+    vec3 tMax = max(t0, t1);
+    // the ray starts at the camera when it is inside the box
+    float tNear = max(max(tMin.x, tMin.y), max(tMin.z, 0.0f));
+    float tFar = min(min(tMax.x, tMax.y), tMax.z);
+    if (tFar <= tNear) {
+        discard;
+    }
+
+    float stepLength = 2.0f * gridHalfExtent * sqrt(3.0f) / float(numSteps);
+    // grid point 0 is at the center of the first texel and grid point volumeSize-1 at the center of the last one
+    float texelScale = float(volumeSize - 1) / float(volumeSize);
+    float texelOffset = 0.5f / float(volumeSize);
+
+    // front to back compositing, stopping once the ray is practically opaque
+    vec4 accumulated = vec4(0.0f);
+    for (int i = 0; i < numSteps; i++) {
+        float t = tNear + (float(i) + 0.5f) * stepLength;
+        if (t > tFar || accumulated.a > 0.99f) {
+            break;
+        }
+        vec3 samplePos = camPos + t * rayDirection;
+        vec3 texCoord = (samplePos + gridHalfExtent) / (2.0f * gridHalfExtent) * texelScale + texelOffset;
+        vec4 sampleColor = transfer(texture(volume, texCoord).r, stepLength);
+
+        accumulated.rgb += (1.0f - accumulated.a) * sampleColor.a * sampleColor.rgb;
+        accumulated.a += (1.0f - accumulated.a) * sampleColor.a;
+    }
+    FragColor = accumulated;
+}
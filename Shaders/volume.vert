@@ -0,0 +1,19 @@
+// .vert
+#version 330 core
+
+// Corner of the box around the density grid
+layout (location = 0) in vec3 aPos;
+
+
+// Outputs the point of the box the ray of this fragment leaves through
+out vec3 crntPos;
+
+// Imports the camera matrix from the main function
+uniform mat4 camMatrix;
+
+
+void main()
+{
+    crntPos = aPos;
+    gl_Position = camMatrix * vec4(crntPos, 1.0f);
+}
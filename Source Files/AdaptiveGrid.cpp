@@ -0,0 +1,92 @@
+#include"AdaptiveGrid.h"
+
+#include<algorithm>
+#include<cmath>
+
+#include"Parallel.h"
+
+// Settings whose finest cells are at least as small as the spacing of a numSpheres_per_side^3 grid
+AdaptiveSettings adaptiveSettingsFor(int numSpheres_per_side)
+{
+    AdaptiveSettings settings;
+    settings.minDepth = 2;
+    settings.maxDepth = std::max(settings.minDepth, (int)std::ceil(std::log2((double)numSpheres_per_side)));
+    settings.emptyThreshold = 0.01f;
+    settings.refineThreshold = 0.10f;
+    return settings;
+}
+
+// Samples the cell centered on (x, y, z) with half edge length halfSize at depth and emits its spheres into out
+static void refineCell(const Orbital& orbital, const AdaptiveSettings& settings, GLfloat x, GLfloat y, GLfloat z,
+                       GLfloat halfSize, int depth, std::vector<SphereInstance>& out)
+{
+    // center and 8 corners of the cell
+    GLfloat xs[9] = { x }, ys[9] = { y }, zs[9] = { z }, density[9];
+    for (int corner = 0; corner < 8; corner++) {
+        xs[corner + 1] = x + ((corner & 1) ? halfSize : -halfSize);
+        ys[corner + 1] = y + ((corner & 2) ? halfSize : -halfSize);
+        zs[corner + 1] = z + ((corner & 4) ? halfSize : -halfSize);
+    }
+    orbital.densities(orbital, xs, ys, zs, density, 9);
+    for (int sample = 0; sample < 9; sample++) {
+        density[sample] /= orbital.peakDensity;
+    }
+    GLfloat minDensity = *std::min_element(density, density + 9);
+    GLfloat maxDensity = *std::max_element(density, density + 9);
+
+    bool split = depth < settings.minDepth
+        || (depth < settings.maxDepth && maxDensity >= settings.emptyThreshold && maxDensity - minDensity > settings.refineThreshold);
+    if (split) {
+        GLfloat quarterSize = halfSize / 2;
+        for (int child = 0; child < 8; child++) {
+            refineCell(orbital, settings,
+                       x + ((child & 1) ? quarterSize : -quarterSize),
+                       y + ((child & 2) ? quarterSize : -quarterSize),
+                       z + ((child & 4) ? quarterSize : -quarterSize),
+                       quarterSize, depth + 1, out);
+        }
+        return;
+    }
+    if (maxDensity < settings.emptyThreshold) {
+        return;
+    }
+
+    // The sphere of a leaf is drawn like a grid sphere whose spacing is the edge length of the cell
+    SphereInstance sphere;
+    sphere.x = x;
+    sphere.y = y;
+    sphere.z = z;
+    setSphereDensity(sphere, density[0], 2 * halfSize);
+    out.push_back(sphere);
+}
+
+// Samples an orbital onto an octree spanning the cube of the axes, writing one sphere per non-empty leaf cell
+void evaluateAdaptive(const Orbital& orbital, const AdaptiveSettings& settings, std::vector<SphereInstance>& sphereInstances)
+{
+    // The cells of depth minDepth are refined in parallel, each slab of cells into its own list, then joined in order
+    // The lists belong to this thread and keep their capacity, so rebuilds of a similar octree do not reallocate them
+    // (the slab bodies use them through this reference; in a body the thread_local name is the list of its own thread)
+    thread_local std::vector<std::vector<SphereInstance>> threadSlabSpheres(numWorkerThreads());
+    std::vector<std::vector<SphereInstance>>& slabSpheres = threadSlabSpheres;
+    const int cellsPerSide = 1 << settings.minDepth;
+    const GLfloat cellHalfSize = GRID_HALF_EXTENT / cellsPerSide;
+    const size_t numCells = (size_t)cellsPerSide * cellsPerSide * cellsPerSide;
+    for (std::vector<SphereInstance>& spheres : slabSpheres) {
+        spheres.clear();
+    }
+    parallelForSlabs(numCells, [&](unsigned int slab, size_t cell_begin, size_t cell_end) {
+        for (size_t cell = cell_begin; cell < cell_end; cell++) {
+            int i = (int)(cell / (cellsPerSide * cellsPerSide)), j = (int)(cell / cellsPerSide) % cellsPerSide, k = (int)(cell % cellsPerSide);
+            refineCell(orbital, settings,
+                       -GRID_HALF_EXTENT + (2 * i + 1) * cellHalfSize,
+                       -GRID_HALF_EXTENT + (2 * j + 1) * cellHalfSize,
+                       -GRID_HALF_EXTENT + (2 * k + 1) * cellHalfSize,
+                       cellHalfSize, settings.minDepth, slabSpheres[slab]);
+        }
+    });
+
+    sphereInstances.clear();
+    for (const std::vector<SphereInstance>& spheres : slabSpheres) {
+        sphereInstances.insert(sphereInstances.end(), spheres.begin(), spheres.end());
+    }
+}
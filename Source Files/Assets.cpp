@@ -0,0 +1,85 @@
+#include"Assets.h"
+
+#include<cstring>
+#include<filesystem>
+#include<vector>
+
+#if defined(__APPLE__)
+#include<mach-o/dyld.h>
+#elif defined(_WIN32)
+#include<windows.h>
+#endif
+
+#include"shaderClass.h"
+
+namespace fs = std::filesystem;
+
+// Folder of the running executable
+std::string executableDir()
+{
+    std::error_code error;
+    fs::path executable;
+#if defined(__APPLE__)
+    uint32_t size = 0;
+    _NSGetExecutablePath(NULL, &size);
+    std::vector<char> buffer(size + 1, '\0');
+    if (_NSGetExecutablePath(buffer.data(), &size) == 0) {
+        executable = buffer.data();
+    }
+#elif defined(_WIN32)
+    std::vector<char> buffer(MAX_PATH, '\0');
+    DWORD length = GetModuleFileNameA(NULL, buffer.data(), (DWORD)buffer.size());
+    executable = std::string(buffer.data(), length);
+#else
+    executable = fs::read_symlink("/proc/self/exe", error);
+#endif
+    if (executable.empty() || error) {
+        return fs::current_path().string();
+    }
+    // Resolves the symbolic links and the .. of the path, so that its parent is the real folder
+    fs::path resolved = fs::weakly_canonical(executable, error);
+    return (error ? executable : resolved).parent_path().string();
+}
+
+// Folder the simulator keeps its files in
+std::string dataDir()
+{
+    return fs::path(executableDir()).parent_path().string();
+}
+
+// Name and source of every embedded shader
+struct EmbeddedShader
+{
+    const char* name;
+    const char* source;
+};
+
+#ifdef ORBITAL_EMBEDDED_SHADERS
+// Generated from the Shaders folder by cmake/EmbedShaders.cmake
+static const EmbeddedShader embeddedShaders[] = {
+#include"EmbeddedShaders.inc"
+};
+#else
+static const EmbeddedShader embeddedShaders[] = { { "", "" } };
+#endif
+
+// GLSL source of a shader built into the executable
+const char* embeddedShaderSource(const std::string& name)
+{
+    for (const EmbeddedShader& shader : embeddedShaders) {
+        if (name == shader.name && std::strlen(shader.source) > 0) {
+            return shader.source;
+        }
+    }
+    return NULL;
+}
+
+// Source of the shader file at path: the embedded shader of the same name if there is one, otherwise the file
+std::string shaderSource(const std::string& path)
+{
+    const char* embedded = embeddedShaderSource(fs::path(path).filename().string());
+    if (embedded != NULL) {
+        return embedded;
+    }
+    return get_file_contents(path.c_str());
+}
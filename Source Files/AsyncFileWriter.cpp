@@ -0,0 +1,75 @@
+#include"AsyncFileWriter.h"
+
+#include<algorithm>
+
+// Creates (or truncates) the file at path
+AsyncFileWriter::AsyncFileWriter(const std::string& path) : file(path, std::ios::binary | std::ios::trunc)
+{
+    good = file.good();
+    filling.reserve(ASYNC_WRITE_BUFFER_SIZE);
+    writing.reserve(ASYNC_WRITE_BUFFER_SIZE);
+    thread = std::thread(&AsyncFileWriter::run, this);
+}
+
+// Appends bytes bytes of data to the file
+void AsyncFileWriter::Write(const void* data, size_t bytes)
+{
+    const char* source = (const char*)data;
+    size += bytes;
+    while (bytes > 0) {
+        const size_t chunk = std::min(bytes, ASYNC_WRITE_BUFFER_SIZE - filling.size());
+        filling.insert(filling.end(), source, source + chunk);
+        source += chunk;
+        bytes -= chunk;
+        if (filling.size() == ASYNC_WRITE_BUFFER_SIZE) {
+            flush();
+        }
+    }
+}
+
+// Writes what is left, waits for the thread and closes the file
+bool AsyncFileWriter::Close()
+{
+    if (!filling.empty()) {
+        flush();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    handedOver.notify_all();
+    thread.join();
+    file.close();
+    return good;
+}
+
+// Hands filling to the thread, waiting until it is done with the buffer before
+void AsyncFileWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    handedOver.wait(lock, [&]() { return writing.empty(); });
+    // Both buffers keep their capacity, so the swaps never allocate
+    std::swap(filling, writing);
+    lock.unlock();
+    handedOver.notify_all();
+}
+
+// Body of the thread
+void AsyncFileWriter::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        handedOver.wait(lock, [&]() { return !writing.empty() || closing; });
+        if (writing.empty()) {
+            return;
+        }
+        // The caller only touches writing through flush, which waits for it to be empty again
+        lock.unlock();
+        file.write(writing.data(), writing.size());
+        const bool written = file.good();
+        lock.lock();
+        good = good && written;
+        writing.clear();
+        handedOver.notify_all();
+    }
+}
@@ -0,0 +1,74 @@
+#include"DynamicVBO.h"
+
+// Constructor that generates a ring of regions of regionSize bytes
+DynamicVBO::DynamicVBO(GLsizeiptr regionSize) : VBO(NULL, 0)
+{
+    Reserve(regionSize);
+}
+
+// Moves on to the next region, waits until the GPU is done with it and maps its first size bytes for writing
+GLfloat* DynamicVBO::Map(GLsizeiptr size)
+{
+    region = (region + 1) % NUM_DYNAMIC_VBO_REGIONS;
+    if (fences[region] != 0) {
+        // The region was drawn from NUM_DYNAMIC_VBO_REGIONS frames ago, so this normally returns at once
+        while (glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {
+        }
+        deleteFence(region);
+    }
+    if (size == 0) {
+        return NULL;
+    }
+    Bind();
+    // The fence already guarantees the GPU is not reading this range, so the driver does not have to synchronize
+    return (GLfloat*)glMapBufferRange(GL_ARRAY_BUFFER, Offset(), size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+// Unmaps the region
+void DynamicVBO::Unmap()
+{
+    Bind();
+    // GL_FALSE means the contents were lost (e.g. a display mode change); the next Map rewrites them anyway
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+// Byte offset of the current region in the buffer
+GLintptr DynamicVBO::Offset()
+{
+    return region * regionSize;
+}
+
+// Fences the current region
+void DynamicVBO::Fence()
+{
+    deleteFence(region);
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+// Reallocates the ring for regions of newRegionSize bytes
+void DynamicVBO::Reserve(GLsizeiptr newRegionSize)
+{
+    regionSize = newRegionSize;
+    for (int r = 0; r < NUM_DYNAMIC_VBO_REGIONS; r++) {
+        deleteFence(r);
+    }
+    Resize(NULL, NUM_DYNAMIC_VBO_REGIONS * regionSize, GL_STREAM_DRAW);
+}
+
+// Deletes the VBO and its fences
+void DynamicVBO::Delete()
+{
+    for (int r = 0; r < NUM_DYNAMIC_VBO_REGIONS; r++) {
+        deleteFence(r);
+    }
+    VBO::Delete();
+}
+
+// Deletes the fence of a region
+void DynamicVBO::deleteFence(int r)
+{
+    if (fences[r] != 0) {
+        glDeleteSync(fences[r]);
+        fences[r] = 0;
+    }
+}
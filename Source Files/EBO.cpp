@@ -8,6 +8,13 @@ EBO::EBO(GLuint* indices, GLsizeiptr size)
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW);
 }
 
+// Reallocates the EBO to size bytes and fills it with indices (the VAO it belongs to must be bound)
+void EBO::Resize(const GLuint* indices, GLsizeiptr size)
+{
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW);
+}
+
 // Binds the EBO
 void EBO::Bind()
 {
@@ -0,0 +1,158 @@
+#include"ElectronCloud.h"
+
+#include<algorithm>
+#include<cmath>
+
+#include"Orbitals.h"
+#include"Parallel.h"
+#include"Wavefunction.h"
+
+// Seed shared by every stream (the streams differ in their increments)
+static const uint64_t ELECTRON_SEED = 0x853c49e6748fea9bULL;
+
+// PCG32 random number generator (O'Neill 2014), one stream per increment
+struct Pcg32
+{
+    uint64_t state = 0;
+    uint64_t increment;
+
+    Pcg32(uint64_t seed, uint64_t stream) : increment((stream << 1) | 1)
+    {
+        next();
+        state += seed;
+        next();
+    }
+    uint32_t next()
+    {
+        const uint64_t old = state;
+        state = old * 6364136223846793005ULL + increment;
+        const uint32_t xorShifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+        const uint32_t rotation = (uint32_t)(old >> 59);
+        return (xorShifted >> rotation) | (xorShifted << ((-rotation) & 31));
+    }
+    // Uniform in [0, 1)
+    GLfloat uniform()
+    {
+        return (next() >> 8) * (1.0f / 16777216.0f);
+    }
+};
+
+// Fills cdf with the normalized running sum of pdf at the centers of SAMPLING_TABLE_SIZE bins from begin to end
+template<typename Pdf>
+static void tabulateCdf(std::vector<GLfloat>& cdf, double begin, double end, Pdf pdf)
+{
+    std::vector<double> sum(SAMPLING_TABLE_SIZE + 1, 0.0);
+    const double width = (end - begin) / SAMPLING_TABLE_SIZE;
+    for (int i = 0; i < SAMPLING_TABLE_SIZE; i++) {
+        sum[i + 1] = sum[i] + pdf(begin + (i + 0.5) * width);
+    }
+    cdf.resize(SAMPLING_TABLE_SIZE + 1);
+    for (int i = 0; i <= SAMPLING_TABLE_SIZE; i++) {
+        cdf[i] = sum[i] / sum[SAMPLING_TABLE_SIZE];
+    }
+}
+
+// Inverts a CDF of tabulateCdf at u, linearly within the bin (the pdf is constant over each bin)
+static GLfloat invertCdf(const std::vector<GLfloat>& cdf, GLfloat begin, GLfloat end, GLfloat u)
+{
+    const int bin = std::clamp((int)(std::upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin()) - 1, 0, SAMPLING_TABLE_SIZE - 1);
+    const GLfloat binProbability = cdf[bin + 1] - cdf[bin];
+    const GLfloat t = (binProbability > 0) ? (u - cdf[bin]) / binProbability : 0.5f;
+    return begin + (end - begin) * (bin + t) / SAMPLING_TABLE_SIZE;
+}
+
+// Rounds a coordinate in [-1, 1] to a snorm16
+static GLshort snorm16(GLfloat v)
+{
+    return (GLshort)std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f);
+}
+
+// Tabulates the distributions of orbital within the cube of the axes
+void ElectronSampler::SetOrbital(const Orbital& orbital)
+{
+    // The corners of the cube are the farthest points of the axes from the nucleus
+    maxRadius = std::sqrt(3.0f) * orbital.extentBohr;
+    unitsPerBohr = GRID_HALF_EXTENT / orbital.extentBohr;
+    tabulateCdf(radialCdf, 0.0, maxRadius, [&](double r) {
+        const double R = radialWavefunction(orbital.n, orbital.l, r);
+        return R * R * r * r;
+    });
+    tabulateCdf(polarCdf, -1.0, 1.0, [&](double cosTheta) {
+        return angularDensity(orbital.l, orbital.ml, cosTheta);
+    });
+}
+
+// Writes count positions into points, drawn from streams firstStream, firstStream + 1, ...
+void ElectronSampler::Sample(uint64_t firstStream, size_t count, ElectronPoint* points) const
+{
+    const size_t numStreams = (count + ELECTRON_STREAM_SAMPLES - 1) / ELECTRON_STREAM_SAMPLES;
+    parallelFor(numStreams, [&](size_t stream_begin, size_t stream_end) {
+        for (size_t stream = stream_begin; stream < stream_end; stream++) {
+            Pcg32 random(ELECTRON_SEED, firstStream + stream);
+            const size_t end = std::min(count, (stream + 1) * ELECTRON_STREAM_SAMPLES);
+            for (size_t p = stream * ELECTRON_STREAM_SAMPLES; p < end; p++) {
+                GLfloat x, y, z;
+                // The radius reaches the corners of the cube, so positions outside of it are drawn again
+                do {
+                    const GLfloat r = invertCdf(radialCdf, 0.0f, maxRadius, random.uniform()) * unitsPerBohr;
+                    const GLfloat cosTheta = invertCdf(polarCdf, -1.0f, 1.0f, random.uniform());
+                    const GLfloat sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+                    const GLfloat phi = 2 * PI * random.uniform();
+                    x = r * sinTheta * std::cos(phi);
+                    y = r * sinTheta * std::sin(phi);
+                    z = r * cosTheta;
+                } while (std::max({ std::abs(x), std::abs(y), std::abs(z) }) > GRID_HALF_EXTENT);
+                points[p] = { snorm16(x / COMPACT_POSITION_SCALE), snorm16(y / COMPACT_POSITION_SCALE), snorm16(z / COMPACT_POSITION_SCALE), 0 };
+            }
+        }
+    });
+}
+
+// Constructor that generates a buffer for capacity positions
+ElectronCloud::ElectronCloud(size_t capacity) : capacity(capacity), vbo(NULL, capacity * sizeof(ElectronPoint))
+{
+    vao.Bind();
+    // Quantized positions, read as floats by normalizing them
+    vao.LinkAttrib(vbo, 0, 3, GL_SHORT, sizeof(ElectronPoint), (void*)offsetof(ElectronPoint, x), 0, GL_TRUE);
+    vao.Unbind();
+    vbo.Unbind();
+}
+
+// Starts a new cloud of orbital
+void ElectronCloud::SetOrbital(const Orbital& orbital)
+{
+    sampler.SetOrbital(orbital);
+    // The old positions are overwritten batch by batch, only the new ones are drawn
+    count = 0;
+    nextStream = 0;
+}
+
+// Draws and uploads the next batch of positions (nothing once the buffer is full)
+void ElectronCloud::Accumulate()
+{
+    const size_t batchCount = std::min(ELECTRONS_PER_FRAME, capacity - count);
+    if (batchCount == 0) {
+        return;
+    }
+    batch.resize(batchCount);
+    sampler.Sample(nextStream, batchCount, batch.data());
+    nextStream += (batchCount + ELECTRON_STREAM_SAMPLES - 1) / ELECTRON_STREAM_SAMPLES;
+    // Appended behind the positions already drawn, which are never touched again
+    vbo.Update((const GLfloat*)batch.data(), batchCount * sizeof(ElectronPoint), count * sizeof(ElectronPoint));
+    vbo.Unbind();
+    count += batchCount;
+}
+
+// Draws the positions as points with the bound shader
+void ElectronCloud::Draw()
+{
+    vao.Bind();
+    glDrawArrays(GL_POINTS, 0, (GLsizei)count);
+}
+
+// Deletes the buffer
+void ElectronCloud::Delete()
+{
+    vao.Delete();
+    vbo.Delete();
+}
@@ -0,0 +1,48 @@
+#include"Frustum.h"
+
+// Extracts the clip planes of a view-projection matrix such as Camera::cameraMatrix
+Frustum frustumFromMatrix(const glm::mat4& viewProjection)
+{
+    // A point is inside when -w <= x, y, z <= w in clip space, i.e. (row3 +/- row_i) . p >= 0
+    // glm matrices are column major, so row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++) {
+        rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    }
+
+    Frustum frustum;
+    for (int i = 0; i < 3; i++) {
+        frustum.planes[2 * i] = rows[3] + rows[i];
+        frustum.planes[2 * i + 1] = rows[3] - rows[i];
+    }
+    for (glm::vec4& plane : frustum.planes) {
+        plane = plane / glm::length(glm::vec3(plane.x, plane.y, plane.z));
+    }
+    return frustum;
+}
+
+// Whether a sphere is at least partly inside the frustum
+bool sphereInFrustum(const Frustum& frustum, const glm::vec3& center, float radius)
+{
+    for (const glm::vec4& plane : frustum.planes) {
+        if (glm::dot(glm::vec3(plane.x, plane.y, plane.z), center) + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whether an axis aligned box is at least partly inside the frustum
+bool boxInFrustum(const Frustum& frustum, const glm::vec3& boxMin, const glm::vec3& boxMax)
+{
+    for (const glm::vec4& plane : frustum.planes) {
+        // the corner of the box furthest along the plane normal
+        glm::vec3 corner(plane.x >= 0.0f ? boxMax.x : boxMin.x,
+                         plane.y >= 0.0f ? boxMax.y : boxMin.y,
+                         plane.z >= 0.0f ? boxMax.z : boxMin.z);
+        if (glm::dot(glm::vec3(plane.x, plane.y, plane.z), corner) + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,25 @@
+#include"GpuDensity.h"
+
+#include<cmath>
+#include<cstdlib>
+
+#include"Wavefunction.h"
+
+// Uploads everything gpuDensity.vert needs to evaluate orbital on a numSpheres_per_side^3 grid
+void setDensityUniforms(Shader& shader, const Orbital& orbital, int numSpheres_per_side)
+{
+    // The orbitals of the orbitals table use its equations in the shader too, so every mode draws the same shapes
+    bool handFitted = orbital.evaluate != evaluateGeneralGrid;
+    // R_nl^2 |Y_lm|^2 constants and 1 / peak density folded into one factor, in double so that high n does not underflow
+    double densityScale = handFitted ? 1.0 / orbital.peakDensity
+        : std::exp(2.0 * logRadialNormalization(orbital.n, orbital.l)) * angularNormalization(orbital.l, orbital.ml) / orbital.peakDensity;
+    shader.Activate();
+    glUniform1i(shader.Uniform("numSpheresPerSide"), numSpheres_per_side);
+    glUniform1f(shader.Uniform("gridHalfExtent"), GRID_HALF_EXTENT);
+    glUniform1f(shader.Uniform("bohrPerUnit"), orbital.extentBohr / GRID_HALF_EXTENT);
+    glUniform1i(shader.Uniform("n"), orbital.n);
+    glUniform1i(shader.Uniform("l"), orbital.l);
+    glUniform1i(shader.Uniform("ml"), abs(orbital.ml));
+    glUniform1i(shader.Uniform("handFitted"), handFitted ? 1 : 0);
+    glUniform1f(shader.Uniform("densityScale"), (GLfloat)densityScale);
+}
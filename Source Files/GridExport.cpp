@@ -0,0 +1,280 @@
+#include"GridExport.h"
+
+#include<filesystem>
+namespace fs = std::filesystem;
+
+#include<algorithm>
+#include<chrono>
+#include<cmath>
+#include<cstdint>
+#include<cstdlib>
+#include<fstream>
+#include<iomanip>
+#include<iostream>
+#include<sstream>
+#include<vector>
+
+#include"Sphere.h"
+#include"Orbitals.h"
+#include"AsyncFileWriter.h"
+#include"OrbitalSelector.h"
+
+// Bytes of a PLY vertex: float x, y, z, radius, density and uchar red, green, blue
+const size_t PLY_VERTEX_SIZE = 5 * sizeof(float) + 3;
+// Width the vertex count of a PLY header is padded to, so that it can be written over once the count is known
+const int PLY_COUNT_WIDTH = 20;
+
+// Rounds a color channel in [0, 1] to a byte
+static unsigned char colorByte(GLfloat channel)
+{
+    return (unsigned char)lroundf(std::min(std::max(channel, 0.0f), 1.0f) * 255);
+}
+
+// Prints how much of an export is done, overwriting the line it printed before
+static void printProgress(size_t done, size_t total)
+{
+    std::cout << "\rExporting... " << (int)(100.0 * done / total) << "%" << std::flush;
+}
+
+// Streams the densities of the grid as an NRRD volume
+static bool exportVolume(const Orbital& orbital, const ExportSettings& settings)
+{
+    const int N = settings.numPoints_per_side;
+    const size_t numPoints = (size_t)N * N * N;
+    const double spacingBohr = 2.0 * orbital.extentBohr / (N - 1);
+
+    AsyncFileWriter writer(settings.path);
+    std::ostringstream header;
+    header << std::setprecision(9)
+           << "NRRD0004\n"
+           << "# hydrogen orbital n = " << orbital.n << ", l = " << orbital.l << ", |ml| = " << orbital.ml
+           << ", probability density relative to " << orbital.peakDensity << "\n"
+           << "type: float\n"
+           << "dimension: 3\n"
+           << "space dimension: 3\n"
+           << "sizes: " << N << " " << N << " " << N << "\n"
+           << "space directions: (" << spacingBohr << ",0,0) (0," << spacingBohr << ",0) (0,0," << spacingBohr << ")\n"
+           << "space origin: (" << -orbital.extentBohr << "," << -orbital.extentBohr << "," << -orbital.extentBohr << ")\n"
+           << "space units: \"bohr\" \"bohr\" \"bohr\"\n"
+           << "endian: little\n"
+           << "encoding: raw\n"
+           << "\n";
+    writer.Write(header.str().data(), header.str().size());
+
+    std::vector<GLfloat> chunk(std::min(EXPORT_CHUNK_POINTS, numPoints));
+    for (size_t first = 0; first < numPoints; first += chunk.size()) {
+        const size_t count = std::min(chunk.size(), numPoints - first);
+        evaluateDensityVolumeRange(orbital, N, first, count, chunk.data());
+        writer.Write(chunk.data(), count * sizeof(GLfloat));
+        printProgress(first + count, numPoints);
+    }
+    std::cout << "\n";
+    return writer.Close();
+}
+
+// Streams the spheres of the grid as a binary PLY point cloud
+static bool exportPly(const Orbital& orbital, const ExportSettings& settings)
+{
+    const int N = settings.numPoints_per_side;
+    const size_t numPoints = (size_t)N * N * N;
+
+    AsyncFileWriter writer(settings.path);
+    std::ostringstream header;
+    header << "ply\n"
+           << "format binary_little_endian 1.0\n"
+           << "comment hydrogen orbital n = " << orbital.n << ", l = " << orbital.l << ", |ml| = " << orbital.ml
+           << ", " << N << "^3 grid, " << GRID_HALF_EXTENT << " scene units = " << orbital.extentBohr << " Bohr\n"
+           << "element vertex ";
+    // The count is not known until every chunk was filtered
+    const size_t countOffset = header.str().size();
+    header << std::string(PLY_COUNT_WIDTH, ' ') << "\n"
+           << "property float x\n"
+           << "property float y\n"
+           << "property float z\n"
+           << "property float radius\n"
+           << "property float density\n"
+           << "property uchar red\n"
+           << "property uchar green\n"
+           << "property uchar blue\n"
+           << "end_header\n";
+    writer.Write(header.str().data(), header.str().size());
+
+    std::vector<SphereInstance> spheres(std::min(EXPORT_CHUNK_POINTS, numPoints));
+    std::vector<unsigned char> vertices(spheres.size() * PLY_VERTEX_SIZE);
+    size_t numVertices = 0;
+    for (size_t first = 0; first < numPoints; first += spheres.size()) {
+        const size_t count = std::min(spheres.size(), numPoints - first);
+        evaluateGridRange(orbital, N, first, count, spheres.data());
+
+        unsigned char* vertex = vertices.data();
+        for (size_t s = 0; s < count; s++) {
+            const SphereInstance& sphere = spheres[s];
+            if (sphereDensity(sphere) < settings.minDensity) {
+                continue;
+            }
+            const float properties[5] = { sphere.x, sphere.y, sphere.z, sphere.radius, sphereDensity(sphere) };
+            std::copy((const unsigned char*)properties, (const unsigned char*)properties + sizeof(properties), vertex);
+            vertex += sizeof(properties);
+            *vertex++ = colorByte(sphere.red);
+            *vertex++ = colorByte(sphere.green);
+            *vertex++ = colorByte(sphere.blue);
+        }
+        const size_t kept = (vertex - vertices.data()) / PLY_VERTEX_SIZE;
+        writer.Write(vertices.data(), kept * PLY_VERTEX_SIZE);
+        numVertices += kept;
+        printProgress(first + count, numPoints);
+    }
+    std::cout << "\n";
+    if (!writer.Close()) {
+        return false;
+    }
+
+    std::fstream file(settings.path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(countOffset);
+    file << numVertices;
+    return file.good();
+}
+
+// Streams the spheres of the grid into a .bin and describes them in a .gltf
+static bool exportGltf(const Orbital& orbital, const ExportSettings& settings)
+{
+    const int N = settings.numPoints_per_side;
+    const size_t numPoints = (size_t)N * N * N;
+    const fs::path binPath = fs::path(settings.path).replace_extension(".bin");
+
+    AsyncFileWriter writer(binPath.string());
+    std::vector<SphereInstance> spheres(std::min(EXPORT_CHUNK_POINTS, numPoints));
+    size_t numSpheres = 0;
+    GLfloat minPosition[3] = { INFINITY, INFINITY, INFINITY }, maxPosition[3] = { -INFINITY, -INFINITY, -INFINITY };
+    for (size_t first = 0; first < numPoints; first += spheres.size()) {
+        const size_t count = std::min(spheres.size(), numPoints - first);
+        evaluateGridRange(orbital, N, first, count, spheres.data());
+
+        // The kept spheres are moved to the front of the chunk, in order
+        size_t kept = 0;
+        for (size_t s = 0; s < count; s++) {
+            if (sphereDensity(spheres[s]) < settings.minDensity) {
+                continue;
+            }
+            const SphereInstance& sphere = spheres[kept++] = spheres[s];
+            const GLfloat position[3] = { sphere.x, sphere.y, sphere.z };
+            for (int axis = 0; axis < 3; axis++) {
+                minPosition[axis] = std::min(minPosition[axis], position[axis]);
+                maxPosition[axis] = std::max(maxPosition[axis], position[axis]);
+            }
+        }
+        writer.Write(spheres.data(), kept * sizeof(SphereInstance));
+        numSpheres += kept;
+        printProgress(first + count, numPoints);
+    }
+    std::cout << "\n";
+    if (!writer.Close()) {
+        return false;
+    }
+    if (numSpheres == 0) {
+        std::cout << "No sphere is above --min-density, and a glTF accessor cannot be empty.\n";
+        return false;
+    }
+
+    // POSITION, _RADIUS and COLOR_0 are interleaved like the fields of SphereInstance
+    const uint64_t byteLength = (uint64_t)numSpheres * sizeof(SphereInstance);
+    std::ofstream file(settings.path);
+    file << std::setprecision(9)
+         << "{\n"
+         << "  \"asset\": { \"version\": \"2.0\", \"generator\": \"Hydrogen Atom Orbital Simulator\" },\n"
+         << "  \"scene\": 0,\n"
+         << "  \"scenes\": [ { \"nodes\": [ 0 ] } ],\n"
+         << "  \"nodes\": [ { \"mesh\": 0, \"name\": \"orbital_" << orbital.n << "_" << orbital.l << "_" << orbital.ml << "\" } ],\n"
+         << "  \"meshes\": [ { \"primitives\": [ { \"attributes\": { \"POSITION\": 0, \"_RADIUS\": 1, \"COLOR_0\": 2 }, \"mode\": 0 } ] } ],\n"
+         << "  \"buffers\": [ { \"uri\": \"" << binPath.filename().string() << "\", \"byteLength\": " << byteLength << " } ],\n"
+         << "  \"bufferViews\": [ { \"buffer\": 0, \"byteLength\": " << byteLength << ", \"byteStride\": " << sizeof(SphereInstance) << ", \"target\": 34962 } ],\n"
+         << "  \"accessors\": [\n"
+         << "    { \"bufferView\": 0, \"byteOffset\": 0, \"componentType\": 5126, \"count\": " << numSpheres << ", \"type\": \"VEC3\",\n"
+         << "      \"min\": [ " << minPosition[0] << ", " << minPosition[1] << ", " << minPosition[2] << " ],"
+         << " \"max\": [ " << maxPosition[0] << ", " << maxPosition[1] << ", " << maxPosition[2] << " ] },\n"
+         << "    { \"bufferView\": 0, \"byteOffset\": 12, \"componentType\": 5126, \"count\": " << numSpheres << ", \"type\": \"SCALAR\" },\n"
+         << "    { \"bufferView\": 0, \"byteOffset\": 16, \"componentType\": 5126, \"count\": " << numSpheres << ", \"type\": \"VEC3\" }\n"
+         << "  ]\n"
+         << "}\n";
+    return file.good();
+}
+
+// Evaluates the orbital of settings a chunk at a time and streams every chunk to disk
+bool exportOrbital(const ExportSettings& settings)
+{
+    const Orbital orbital = findOrbital(settings.n, settings.l, settings.ml);
+    std::cout << "Axis extent for this orbital: " << orbital.extentBohr << " Bohr radii\n";
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool written = false;
+    switch (settings.format) {
+        case EXPORT_VOLUME: written = exportVolume(orbital, settings); break;
+        case EXPORT_PLY: written = exportPly(orbital, settings); break;
+        case EXPORT_GLTF: written = exportGltf(orbital, settings); break;
+    }
+    if (!written) {
+        std::cout << "Could not write " << settings.path << ".\n";
+        return false;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Wrote " << settings.path << " in " << std::fixed << std::setprecision(2) << seconds << " s.\n";
+    return true;
+}
+
+// Batch mode of the simulator, without a window
+int runExportCommand(int argc, char** argv)
+{
+    const char* const FORMAT_NAMES[] = { "volume", "ply", "gltf" };
+    ExportSettings settings = { EXPORT_VOLUME, -1, -1, 0, 0, 0.0f, "" };
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        std::string value = (i + 1 < argc) ? argv[i + 1] : "";
+        if (arg == "--export") {
+            const char* const* found = std::find_if(std::begin(FORMAT_NAMES), std::end(FORMAT_NAMES),
+                                                    [&](const char* name) { return value == name; });
+            if (found == std::end(FORMAT_NAMES)) {
+                std::cout << "Unknown export format " << value << ". Use volume, ply or gltf.\n";
+                return 1;
+            }
+            settings.format = (ExportFormat)(found - std::begin(FORMAT_NAMES));
+            i++;
+        }
+        else if (arg == "--n" || arg == "--l" || arg == "--ml" || arg == "--grid") {
+            int& number = (arg == "--n") ? settings.n : (arg == "--l") ? settings.l : (arg == "--ml") ? settings.ml : settings.numPoints_per_side;
+            if (!parseInt(value, number)) {
+                std::cout << arg << " needs a whole number, not \"" << value << "\".\n";
+                return 1;
+            }
+            i++;
+        }
+        else if (arg == "--min-density") {
+            char* end = NULL;
+            settings.minDensity = std::strtof(value.c_str(), &end);
+            if (value.empty() || *end != '\0') {
+                std::cout << "--min-density needs a number, not \"" << value << "\".\n";
+                return 1;
+            }
+            i++;
+        }
+        else if (arg == "--out") { settings.path = value; i++; }
+        else {
+            std::cout << "Unknown argument " << arg << ". See GridExport.h for the usage.\n";
+            return 1;
+        }
+    }
+
+    // The quantum numbers are checked like at the interactive prompt; the grid has no upper limit since it is
+    // streamed to disk instead of uploaded
+    if (!checkQuantumNumbers(settings.n, settings.l, settings.ml)) {
+        return 1;
+    }
+    if (settings.numPoints_per_side < 2) {
+        std::cout << "The grid needs at least 2 points per side.\n";
+        return 1;
+    }
+    if (settings.path.empty()) {
+        std::cout << "No output file, use --out FILE.\n";
+        return 1;
+    }
+    return exportOrbital(settings) ? 0 : 1;
+}
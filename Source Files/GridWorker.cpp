@@ -0,0 +1,107 @@
+#include"GridWorker.h"
+
+#include<algorithm>
+#include<chrono>
+
+#include"Parallel.h"
+
+// Constructor that sets the cache directory
+GridWorker::GridWorker(std::string cacheDir) : orbitalCache(cacheDir), useCache(!cacheDir.empty())
+{
+}
+
+// Cancels the current job, if any, and starts evaluating orbital on a numSpheres_per_side^3 grid
+void GridWorker::Start(const Orbital& orbital, int numSpheres_per_side)
+{
+    Stop();
+    // Slabs of the cancelled job are stale
+    GridSlab stale;
+    while (slabs.Pop(stale)) {
+    }
+
+    levelSides.clear();
+    if (numSpheres_per_side > COARSE_SPHERES_PER_SIDE) {
+        levelSides.push_back(COARSE_SPHERES_PER_SIDE);
+    }
+    levelSides.push_back(numSpheres_per_side);
+    // Allocated here so the thread only ever writes into them
+    levels.assign(levelSides.size(), std::vector<SphereInstance>());
+    for (size_t level = 0; level < levelSides.size(); level++) {
+        levels[level].resize((size_t)levelSides[level] * levelSides[level] * levelSides[level]);
+    }
+
+    cancel = false;
+    thread = std::thread(&GridWorker::run, this, orbital);
+}
+
+// Pops the next finished slab
+bool GridWorker::Poll(GridSlab& slab)
+{
+    return slabs.Pop(slab);
+}
+
+// Cancels the current job and waits for the thread to end
+void GridWorker::Stop()
+{
+    if (thread.joinable()) {
+        cancel = true;
+        thread.join();
+    }
+}
+
+// Pushes a slab, waiting while the queue is full
+bool GridWorker::publish(const GridSlab& slab)
+{
+    while (!slabs.Push(slab)) {
+        if (cancel) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+// Body of the thread
+void GridWorker::run(Orbital orbital)
+{
+    const int lastLevel = (int)levelSides.size() - 1;
+    // A cached grid replaces the whole job
+    if (useCache) {
+        const SphereInstance* cachedSpheres = orbitalCache.Map(orbital, levelSides[lastLevel]);
+        if (cachedSpheres != NULL) {
+            std::copy(cachedSpheres, cachedSpheres + levels[lastLevel].size(), levels[lastLevel].begin());
+            orbitalCache.Unmap();
+            publish({ lastLevel, 0, levels[lastLevel].size(), true, 0.0, true });
+            return;
+        }
+    }
+
+    for (int level = 0; level <= lastLevel; level++) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const int side = levelSides[level];
+        const size_t slabSize = (size_t)side * side;
+        SphereInstance* spheres = levels[level].data();
+
+        // One slab per worker thread at a time, so a cancel never waits for more than that
+        const int slabsPerBatch = (int)numWorkerThreads();
+        for (int firstSlab = 0; firstSlab < side; firstSlab += slabsPerBatch) {
+            if (cancel) {
+                return;
+            }
+            const int batchSlabs = std::min(slabsPerBatch, side - firstSlab);
+            evaluateGridRange(orbital, side, firstSlab * slabSize, batchSlabs * slabSize, spheres + firstSlab * slabSize);
+
+            const bool levelDone = firstSlab + batchSlabs == side;
+            const double levelMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            for (int b = 0; b < batchSlabs; b++) {
+                const bool lastSlab = levelDone && b == batchSlabs - 1;
+                if (!publish({ level, (firstSlab + b) * slabSize, slabSize, lastSlab, levelMs, false })) {
+                    return;
+                }
+            }
+        }
+        if (level == lastLevel && useCache) {
+            orbitalCache.Store(orbital, side, spheres);
+        }
+    }
+}
@@ -0,0 +1,208 @@
+#include"Isosurface.h"
+
+#include<algorithm>
+#include<cmath>
+#include<glm/glm.hpp>
+
+#include"Orbitals.h"
+#include"Parallel.h"
+
+// The 6 tetrahedra of a cube around its diagonal from corner 0 to corner 7, corners numbered x + 2y + 4z
+// Each one walks from 0 to 7 along the three axes in a different order, so neighboring cubes split their shared
+// faces along the same diagonal and the surface has no cracks
+static const int cubeTetrahedra[6][4] = {
+    { 0, 1, 3, 7 }, { 0, 1, 5, 7 }, { 0, 2, 3, 7 }, { 0, 2, 6, 7 }, { 0, 4, 5, 7 }, { 0, 4, 6, 7 }
+};
+
+// Sets the grid to the densities of the spheres of an N^3 grid, in grid order
+void IsosurfaceExtractor::SetSphereGrid(const std::string& gridKey, const SphereInstance* spheres, int N)
+{
+    IsosurfaceExtractor::gridKey = gridKey;
+    side = N;
+    densities.resize((size_t)N * N * N);
+    for (size_t p = 0; p < densities.size(); p++) {
+        densities[p] = sphereDensity(spheres[p]);
+    }
+}
+
+// Same for the relative densities of an N^3 density volume, x fastest
+void IsosurfaceExtractor::SetVolumeGrid(const std::string& gridKey, const GLfloat* volume, int N)
+{
+    IsosurfaceExtractor::gridKey = gridKey;
+    side = N;
+    densities.resize((size_t)N * N * N);
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            for (int k = 0; k < N; k++) {
+                densities[((size_t)i * N + j) * N + k] = volume[((size_t)k * N + j) * N + i];
+            }
+        }
+    }
+}
+
+// Returns the triangles where the relative density of the current grid crosses level
+const std::vector<IsosurfaceVertex>& IsosurfaceExtractor::Extract(GLfloat level)
+{
+    // Levels are compared in steps of 1e-4, so a level swept away and back finds its surface again
+    const long levelKey = lroundf(level * 1e4f);
+    for (std::list<CachedSurface>::iterator surface = cache.begin(); surface != cache.end(); surface++) {
+        if (surface->gridKey == gridKey && surface->levelKey == levelKey) {
+            cache.splice(cache.begin(), cache, surface);
+            lastWasCached = true;
+            return cache.front().vertices;
+        }
+    }
+    lastWasCached = false;
+
+    // Every block is triangulated into its own list, then the lists are joined in block order
+    const int cellsPerSide = std::max(side - 1, 0);
+    const int blocksPerSide = (cellsPerSide + ISOSURFACE_BLOCK_CELLS - 1) / ISOSURFACE_BLOCK_CELLS;
+    blockVertices.resize((size_t)blocksPerSide * blocksPerSide * blocksPerSide);
+    parallelFor(blockVertices.size(), [&](size_t block_begin, size_t block_end) {
+        for (size_t block = block_begin; block < block_end; block++) {
+            blockVertices[block].clear();
+            extractBlock((int)block, level, blockVertices[block]);
+        }
+    });
+
+    cache.push_front({ gridKey, levelKey, std::vector<IsosurfaceVertex>() });
+    std::vector<IsosurfaceVertex>& vertices = cache.front().vertices;
+    size_t numVertices = 0;
+    for (const std::vector<IsosurfaceVertex>& block : blockVertices) {
+        numVertices += block.size();
+    }
+    vertices.reserve(numVertices);
+    for (const std::vector<IsosurfaceVertex>& block : blockVertices) {
+        vertices.insert(vertices.end(), block.begin(), block.end());
+    }
+    if (cache.size() > MAX_CACHED_ISOSURFACES) {
+        cache.pop_back();
+    }
+    return vertices;
+}
+
+// Triangulates the cubes of one block into vertices
+void IsosurfaceExtractor::extractBlock(int block, GLfloat level, std::vector<IsosurfaceVertex>& vertices)
+{
+    const int N = side;
+    const int cellsPerSide = N - 1;
+    const int blocksPerSide = (cellsPerSide + ISOSURFACE_BLOCK_CELLS - 1) / ISOSURFACE_BLOCK_CELLS;
+    const int bi = block / (blocksPerSide * blocksPerSide), bj = (block / blocksPerSide) % blocksPerSide, bk = block % blocksPerSide;
+    const GLfloat step = 2 * GRID_HALF_EXTENT / (N - 1);
+
+    auto density = [&](int i, int j, int k) {
+        return densities[((size_t)i * N + j) * N + k];
+    };
+    // Central differences (one sided on the faces of the grid), in density per grid step
+    auto gradient = [&](int i, int j, int k) {
+        const int i0 = std::max(i - 1, 0), i1 = std::min(i + 1, N - 1);
+        const int j0 = std::max(j - 1, 0), j1 = std::min(j + 1, N - 1);
+        const int k0 = std::max(k - 1, 0), k1 = std::min(k + 1, N - 1);
+        return glm::vec3((density(i1, j, k) - density(i0, j, k)) / (i1 - i0),
+                         (density(i, j1, k) - density(i, j0, k)) / (j1 - j0),
+                         (density(i, j, k1) - density(i, j, k0)) / (k1 - k0));
+    };
+
+    for (int i = bi * ISOSURFACE_BLOCK_CELLS; i < std::min((bi + 1) * ISOSURFACE_BLOCK_CELLS, cellsPerSide); i++) {
+        for (int j = bj * ISOSURFACE_BLOCK_CELLS; j < std::min((bj + 1) * ISOSURFACE_BLOCK_CELLS, cellsPerSide); j++) {
+            for (int k = bk * ISOSURFACE_BLOCK_CELLS; k < std::min((bk + 1) * ISOSURFACE_BLOCK_CELLS, cellsPerSide); k++) {
+                // Densities of the corners of the cube, and whether the surface passes through it at all
+                GLfloat cornerDensity[8];
+                int numInside = 0;
+                for (int corner = 0; corner < 8; corner++) {
+                    cornerDensity[corner] = density(i + (corner & 1), j + ((corner >> 1) & 1), k + ((corner >> 2) & 1));
+                    numInside += cornerDensity[corner] > level;
+                }
+                if (numInside == 0 || numInside == 8) {
+                    continue;
+                }
+                glm::vec3 cornerPosition[8], cornerNormal[8];
+                for (int corner = 0; corner < 8; corner++) {
+                    const int ci = i + (corner & 1), cj = j + ((corner >> 1) & 1), ck = k + ((corner >> 2) & 1);
+                    cornerPosition[corner] = glm::vec3(-GRID_HALF_EXTENT + ci * step, -GRID_HALF_EXTENT + cj * step, -GRID_HALF_EXTENT + ck * step);
+                    // The density falls off away from the surface, so the normal points down the gradient
+                    cornerNormal[corner] = -gradient(ci, cj, ck);
+                }
+
+                // The point of an edge from an inside corner to an outside corner where the density is level
+                auto edgeVertex = [&](int inside, int outside) {
+                    const GLfloat t = (cornerDensity[inside] - level) / (cornerDensity[inside] - cornerDensity[outside]);
+                    const glm::vec3 position = glm::mix(cornerPosition[inside], cornerPosition[outside], t);
+                    glm::vec3 normal = glm::mix(cornerNormal[inside], cornerNormal[outside], t);
+                    const GLfloat length = glm::length(normal);
+                    normal = (length > 0) ? normal / length : glm::vec3(0.0f);
+                    return IsosurfaceVertex{ position.x, position.y, position.z, normal.x, normal.y, normal.z };
+                };
+                // Adds a triangle, wound CCW seen from the outside (away from insideCenter)
+                auto addTriangle = [&](IsosurfaceVertex a, IsosurfaceVertex b, IsosurfaceVertex c, glm::vec3 insideCenter) {
+                    const glm::vec3 pa(a.x, a.y, a.z), pb(b.x, b.y, b.z), pc(c.x, c.y, c.z);
+                    if (glm::dot(glm::cross(pb - pa, pc - pa), (pa + pb + pc) / 3.0f - insideCenter) < 0) {
+                        std::swap(b, c);
+                    }
+                    vertices.push_back(a);
+                    vertices.push_back(b);
+                    vertices.push_back(c);
+                };
+
+                for (const int* tetrahedron : cubeTetrahedra) {
+                    int inside[4], outside[4], numIn = 0, numOut = 0;
+                    for (int v = 0; v < 4; v++) {
+                        if (cornerDensity[tetrahedron[v]] > level) {
+                            inside[numIn++] = tetrahedron[v];
+                        } else {
+                            outside[numOut++] = tetrahedron[v];
+                        }
+                    }
+                    glm::vec3 insideCenter(0.0f);
+                    for (int v = 0; v < numIn; v++) {
+                        insideCenter += cornerPosition[inside[v]] / (GLfloat)numIn;
+                    }
+                    if (numIn == 1) {
+                        addTriangle(edgeVertex(inside[0], outside[0]), edgeVertex(inside[0], outside[1]), edgeVertex(inside[0], outside[2]), insideCenter);
+                    } else if (numIn == 3) {
+                        addTriangle(edgeVertex(inside[0], outside[0]), edgeVertex(inside[1], outside[0]), edgeVertex(inside[2], outside[0]), insideCenter);
+                    } else if (numIn == 2) {
+                        // The four crossed edges form a quad, in this order around it
+                        const IsosurfaceVertex quad[4] = {
+                            edgeVertex(inside[0], outside[0]), edgeVertex(inside[0], outside[1]),
+                            edgeVertex(inside[1], outside[1]), edgeVertex(inside[1], outside[0])
+                        };
+                        addTriangle(quad[0], quad[1], quad[2], insideCenter);
+                        addTriangle(quad[0], quad[2], quad[3], insideCenter);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Hotkeys in the order of wasPressed
+static const int isoLevelKeys[2] = { GLFW_KEY_PERIOD, GLFW_KEY_COMMA };
+
+IsoLevelSelector::IsoLevelSelector(const std::vector<GLfloat>& levels)
+{
+    IsoLevelSelector::levels = levels;
+}
+
+bool IsoLevelSelector::Inputs(GLFWwindow* window)
+{
+    // Handles key inputs, each key acts once when it goes down
+    bool justPressed[2];
+    for (int key = 0; key < 2; key++) {
+        bool pressed = glfwGetKey(window, isoLevelKeys[key]) == GLFW_PRESS;
+        justPressed[key] = pressed && !wasPressed[key];
+        wasPressed[key] = pressed;
+    }
+    if (!justPressed[0] && !justPressed[1]) {
+        return false;
+    }
+
+    const std::vector<GLfloat> oldLevels = levels;
+    for (GLfloat& level : levels) {
+        if (justPressed[0]) level += ISO_LEVEL_STEP;
+        if (justPressed[1]) level -= ISO_LEVEL_STEP;
+        // Keep every level between the empty space and the peak
+        level = std::clamp(level, ISO_LEVEL_STEP / 2, 1.0f - ISO_LEVEL_STEP / 2);
+    }
+    return levels != oldLevels;
+}
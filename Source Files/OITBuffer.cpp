@@ -0,0 +1,124 @@
+#include"OITBuffer.h"
+
+#include<iostream>
+
+// Generates a width * height texture for an accumulation target
+static GLuint generateTarget(GLenum internalFormat, GLenum format, GLsizei width, GLsizei height)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_FLOAT, NULL);
+    // Read texel by texel in oitComposite.frag
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+// Constructor that generates the framebuffers for a width * height viewport
+OITBuffer::OITBuffer(GLsizei width, GLsizei height) : width(width), height(height)
+{
+    glGenRenderbuffers(1, &opaqueColor);
+    glBindRenderbuffer(GL_RENDERBUFFER, opaqueColor);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    // Half floats: the weights reach 3e3 and the sums of many of them must not saturate
+    accumTex = generateTarget(GL_RGBA16F, GL_RGBA, width, height);
+    weightTex = generateTarget(GL_R16F, GL_RED, width, height);
+
+    glGenFramebuffers(1, &opaqueFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, opaqueFBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, opaqueColor);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "The opaque framebuffer of the translucent spheres is incomplete.\n";
+    }
+
+    glGenFramebuffers(1, &transparentFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, transparentFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, accumTex, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, weightTex, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+    const GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    glDrawBuffers(2, drawBuffers);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "The accumulation framebuffer of the translucent spheres is incomplete.\n";
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glGenVertexArrays(1, &screenVAO);
+}
+
+// Binds opaqueFBO
+void OITBuffer::BeginOpaque()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, opaqueFBO);
+}
+
+// Binds transparentFBO, clears the accumulation and sets up blending
+void OITBuffer::BeginTransparent()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, transparentFBO);
+    // Nothing accumulated and everything behind fully revealed
+    const GLfloat clearAccum[] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    const GLfloat clearWeight[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glClearBufferfv(GL_COLOR, 0, clearAccum);
+    glClearBufferfv(GL_COLOR, 1, clearWeight);
+
+    // The spheres are tested against the opaque depth but never hide each other
+    glDepthMask(GL_FALSE);
+    glEnable(GL_BLEND);
+    // rgb: dst + src (the weighted sums), alpha: dst * (1 - src alpha) (the revealage)
+    glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+    // Only the front of every sphere, so each one counts once per pixel
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+}
+
+// Copies the opaque image to the default framebuffer and blends the resolved spheres over it
+void OITBuffer::Composite(Shader& compositeShader)
+{
+    glDisable(GL_CULL_FACE);
+    glDepthMask(GL_TRUE);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, opaqueFBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // result = average color * (1 - revealage) + opaque * revealage
+    glDisable(GL_DEPTH_TEST);
+    glBlendFunc(GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA);
+    compositeShader.Activate();
+    glUniform1i(compositeShader.Uniform("accum"), 2);
+    glUniform1i(compositeShader.Uniform("weights"), 3);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, accumTex);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, weightTex);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(screenVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+}
+
+// Deletes the framebuffers and their attachments
+void OITBuffer::Delete()
+{
+    glDeleteFramebuffers(1, &opaqueFBO);
+    glDeleteFramebuffers(1, &transparentFBO);
+    glDeleteRenderbuffers(1, &opaqueColor);
+    glDeleteRenderbuffers(1, &depth);
+    glDeleteTextures(1, &accumTex);
+    glDeleteTextures(1, &weightTex);
+    glDeleteVertexArrays(1, &screenVAO);
+}
@@ -0,0 +1,106 @@
+#include"OrbitalCache.h"
+
+#include<cstring>
+#include<cstdlib>
+#include<filesystem>
+#include<fstream>
+#include<iostream>
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+OrbitalCache::OrbitalCache(std::string cacheDir)
+{
+    OrbitalCache::cacheDir = cacheDir;
+}
+
+// Path of the cache file of orbital on a numSpheres_per_side^3 grid
+std::string OrbitalCache::path(const Orbital& orbital, int numSpheres_per_side)
+{
+    return cacheDir + "/orbital_" + std::to_string(orbital.n) + "_" + std::to_string(orbital.l) + "_"
+        + std::to_string(abs(orbital.ml)) + "_" + std::to_string(numSpheres_per_side) + ".bin";
+}
+
+// Header the cache file of orbital on a numSpheres_per_side^3 grid must have
+OrbitalCacheHeader OrbitalCache::header(const Orbital& orbital, int numSpheres_per_side)
+{
+    OrbitalCacheHeader header;
+    std::memcpy(header.magic, "ORBCACHE", 8);
+    header.version = ORBITAL_CACHE_VERSION;
+    header.instanceSize = sizeof(SphereInstance);
+    header.n = orbital.n;
+    header.l = orbital.l;
+    header.ml = abs(orbital.ml);
+    header.numSpheres_per_side = numSpheres_per_side;
+    header.extentBohr = orbital.extentBohr;
+    header.gridHalfExtent = GRID_HALF_EXTENT;
+    header.numSpheres = (uint64_t)numSpheres_per_side * numSpheres_per_side * numSpheres_per_side;
+    return header;
+}
+
+// Memory maps the cache file of orbital on a numSpheres_per_side^3 grid
+const SphereInstance* OrbitalCache::Map(const Orbital& orbital, int numSpheres_per_side)
+{
+    Unmap();
+
+    int file = open(path(orbital, numSpheres_per_side).c_str(), O_RDONLY);
+    if (file < 0) {
+        return NULL;
+    }
+    const OrbitalCacheHeader expected = header(orbital, numSpheres_per_side);
+    const size_t expectedSize = sizeof(OrbitalCacheHeader) + expected.numSpheres * sizeof(SphereInstance);
+    struct stat fileStat;
+    if (fstat(file, &fileStat) != 0 || (size_t)fileStat.st_size != expectedSize) {
+        close(file);
+        return NULL;
+    }
+
+    void* data = mmap(NULL, expectedSize, PROT_READ, MAP_PRIVATE, file, 0);
+    // The mapping stays valid after the file is closed
+    close(file);
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+    // Any difference in the key or the layout means the file is stale
+    if (std::memcmp(data, &expected, sizeof(OrbitalCacheHeader)) != 0) {
+        munmap(data, expectedSize);
+        return NULL;
+    }
+
+    mapping = data;
+    mappingSize = expectedSize;
+    return (const SphereInstance*)((const char*)data + sizeof(OrbitalCacheHeader));
+}
+
+// Unmaps the file mapped by Map, if any
+void OrbitalCache::Unmap()
+{
+    if (mapping != NULL) {
+        munmap(mapping, mappingSize);
+        mapping = NULL;
+        mappingSize = 0;
+    }
+}
+
+// Writes the cache file of orbital on a numSpheres_per_side^3 grid
+void OrbitalCache::Store(const Orbital& orbital, int numSpheres_per_side, const SphereInstance* sphereInstances)
+{
+    std::error_code error;
+    std::filesystem::create_directories(cacheDir, error);
+
+    // Written to a temporary file first so that a half-written file is never mapped
+    const std::string filePath = path(orbital, numSpheres_per_side);
+    const std::string tempPath = filePath + ".tmp";
+    const OrbitalCacheHeader fileHeader = header(orbital, numSpheres_per_side);
+    std::ofstream out(tempPath, std::ios::binary);
+    out.write((const char*)&fileHeader, sizeof(OrbitalCacheHeader));
+    out.write((const char*)sphereInstances, fileHeader.numSpheres * sizeof(SphereInstance));
+    out.close();
+    if (!out) {
+        std::cout << "Could not write orbital cache file " << filePath << "\n";
+        std::filesystem::remove(tempPath, error);
+        return;
+    }
+    std::filesystem::rename(tempPath, filePath, error);
+}
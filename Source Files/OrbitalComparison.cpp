@@ -0,0 +1,70 @@
+#include"OrbitalComparison.h"
+
+#include<algorithm>
+#include<cmath>
+
+#include"AdaptiveGrid.h"
+
+// Every orbital of shell n, one per (l, |ml|)
+std::vector<Orbital> shellOrbitals(int n)
+{
+    std::vector<Orbital> orbitals;
+    for (int l = 0; l < n; l++) {
+        for (int ml = 0; ml <= l; ml++) {
+            orbitals.push_back(findOrbital(n, l, ml));
+        }
+    }
+    return orbitals;
+}
+
+// Center of an orbital of shell n in the comparison
+glm::vec3 comparisonOffset(const Orbital& orbital, int n)
+{
+    // n rows (l = 0 ... n-1) of up to n columns (|ml| = 0 ... l)
+    const GLfloat middle = (n - 1) / 2.0f;
+    return glm::vec3((orbital.ml - middle) * COMPARISON_SPACING, (middle - orbital.l) * COMPARISON_SPACING, 0.0f);
+}
+
+// Distance from the origin at which a camera sees all of shell n
+GLfloat comparisonCameraDistance(int n, GLfloat fov)
+{
+    // Half of the n * COMPARISON_SPACING wide and high layout has to fit in half of the field of view,
+    // plus GRID_HALF_EXTENT since the front of the grids is closer than their centers
+    const GLfloat halfSize = n * COMPARISON_SPACING / 2;
+    return halfSize / tanf(fov / 2 * (GLfloat)M_PI / 180) + GRID_HALF_EXTENT;
+}
+
+// Writes the spheres of every orbital of shell n back to back into sphereInstances, each moved to its comparisonOffset
+void evaluateComparison(const std::vector<Orbital>& orbitals, int n, int numSpheres_per_side, bool adaptive,
+                        OrbitalCache* orbitalCache, std::vector<SphereInstance>& sphereInstances)
+{
+    const size_t gridSpheres = (size_t)numSpheres_per_side * numSpheres_per_side * numSpheres_per_side;
+    sphereInstances.clear();
+    std::vector<SphereInstance> octreeSpheres;
+    for (const Orbital& orbital : orbitals) {
+        const size_t first = sphereInstances.size();
+        if (adaptive) {
+            evaluateAdaptive(orbital, adaptiveSettingsFor(numSpheres_per_side), octreeSpheres);
+            sphereInstances.insert(sphereInstances.end(), octreeSpheres.begin(), octreeSpheres.end());
+        } else {
+            sphereInstances.resize(first + gridSpheres);
+            const SphereInstance* cachedSpheres = (orbitalCache != NULL) ? orbitalCache->Map(orbital, numSpheres_per_side) : NULL;
+            if (cachedSpheres != NULL) {
+                std::copy(cachedSpheres, cachedSpheres + gridSpheres, sphereInstances.begin() + first);
+                orbitalCache->Unmap();
+            } else {
+                orbital.evaluate(orbital, numSpheres_per_side, &sphereInstances[first]);
+                if (orbitalCache != NULL) {
+                    orbitalCache->Store(orbital, numSpheres_per_side, &sphereInstances[first]);
+                }
+            }
+        }
+
+        const glm::vec3 offset = comparisonOffset(orbital, n);
+        for (size_t i = first; i < sphereInstances.size(); i++) {
+            sphereInstances[i].x += offset.x;
+            sphereInstances[i].y += offset.y;
+            sphereInstances[i].z += offset.z;
+        }
+    }
+}
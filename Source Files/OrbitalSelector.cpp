@@ -0,0 +1,70 @@
+#include"OrbitalSelector.h"
+
+#include<algorithm>
+#include<cstdlib>
+#include<iostream>
+
+// Hotkeys in the order of wasPressed
+static const int orbitalKeys[6] = {
+    GLFW_KEY_UP, GLFW_KEY_DOWN, GLFW_KEY_RIGHT, GLFW_KEY_LEFT, GLFW_KEY_RIGHT_BRACKET, GLFW_KEY_LEFT_BRACKET
+};
+
+// Parses text into value, false unless text is one integer that fits in an int
+bool parseInt(const std::string& text, int& value)
+{
+    size_t parsed = 0;
+    try {
+        value = std::stoi(text, &parsed);
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+    return text.find_first_not_of(" \t\r", parsed) == std::string::npos;
+}
+
+// Whether n, l and ml can be shown; prints why not otherwise
+bool checkQuantumNumbers(int n, int l, int ml)
+{
+    if (l + 1 > n || abs(ml) > abs(l) || l < 0) {
+        std::cout << "This combination of quantum numbers is not allowed.\n";
+        return false;
+    }
+    // The hotkeys only go up to MAX_PRINCIPAL_QUANTUM_NUMBER, so the simulator starts inside that range
+    if (n > MAX_PRINCIPAL_QUANTUM_NUMBER) {
+        std::cout << "n can be at most " << MAX_PRINCIPAL_QUANTUM_NUMBER << ".\n";
+        return false;
+    }
+    return true;
+}
+
+OrbitalSelector::OrbitalSelector(int n, int l, int ml)
+{
+    OrbitalSelector::n = n;
+    OrbitalSelector::l = l;
+    OrbitalSelector::ml = ml;
+}
+
+bool OrbitalSelector::Inputs(GLFWwindow* window)
+{
+    // Handles key inputs, each key acts once when it goes down
+    bool justPressed[6];
+    for (int key = 0; key < 6; key++) {
+        bool pressed = glfwGetKey(window, orbitalKeys[key]) == GLFW_PRESS;
+        justPressed[key] = pressed && !wasPressed[key];
+        wasPressed[key] = pressed;
+    }
+
+    const int old_n = n, old_l = l, old_ml = ml;
+    if (justPressed[0]) n = std::min(n + 1, MAX_PRINCIPAL_QUANTUM_NUMBER);
+    if (justPressed[1]) n = std::max(n - 1, 1);
+    if (justPressed[2]) l++;
+    if (justPressed[3]) l--;
+    if (justPressed[4]) ml++;
+    if (justPressed[5]) ml--;
+
+    // Keep the combination allowed: 0 <= l < n and |ml| <= l
+    l = std::clamp(l, 0, n - 1);
+    ml = std::clamp(ml, -l, l);
+
+    return n != old_n || l != old_l || ml != old_ml;
+}
@@ -0,0 +1,129 @@
+#include"Orbitals.h"
+#include"Wavefunction.h"
+
+#include<algorithm>
+#include<cstdlib>
+
+// Every supported orbital
+// extentBohr and peakDensity have been manually fitted so that the most interesting parts of each orbital are displayed clearly
+const Orbital orbitals[] =
+{
+    // n, l, ml, extentBohr, peakDensity, evaluate, densities
+    { 1, 0, 0,  1.0f, 0.31f, evaluateGrid<1,0,0>, evaluateDensities<1,0,0> },
+    { 2, 0, 0,  2.0f, 1.00f, evaluateGrid<2,0,0>, evaluateDensities<2,0,0> },
+    { 2, 1, 0,  5.0f, 1.00f, evaluateGrid<2,1,0>, evaluateDensities<2,1,0> },
+    { 2, 1, 1,  5.0f, 1.00f, evaluateGrid<2,1,1>, evaluateDensities<2,1,1> },
+    { 3, 0, 0, 10.0f, 1.00f, evaluateGrid<3,0,0>, evaluateDensities<3,0,0> },
+    { 3, 1, 0,  7.5f, 1.00f, evaluateGrid<3,1,0>, evaluateDensities<3,1,0> },
+    { 3, 1, 1,  7.5f, 1.00f, evaluateGrid<3,1,1>, evaluateDensities<3,1,1> },
+    { 3, 2, 0, 12.5f, 1.00f, evaluateGrid<3,2,0>, evaluateDensities<3,2,0> },
+    { 3, 2, 1, 10.0f, 1.00f, evaluateGrid<3,2,1>, evaluateDensities<3,2,1> },
+    { 3, 2, 2, 10.0f, 1.00f, evaluateGrid<3,2,2>, evaluateDensities<3,2,2> },
+};
+
+// Samples the relative probability density of an orbital onto a grid, x fastest
+void evaluateDensityVolume(const Orbital& orbital, int numSamples_per_side, GLfloat* volume)
+{
+    GLfloat step = 2 * GRID_HALF_EXTENT / (numSamples_per_side - 1);
+
+    // Slabs of constant z are evaluated in parallel, each one writing its own part of volume
+    ScratchArena* arenas = slabArenas();
+    parallelForSlabs(numSamples_per_side, [&](unsigned int slab, size_t k_begin, size_t k_end) {
+        // The densities of a row of constant (j, k) are evaluated together; only x changes along a row
+        ScratchArena& arena = arenas[slab];
+        const ScratchMark mark = arena.Mark();
+        GLfloat* xRow = arena.Allocate<GLfloat>(numSamples_per_side);
+        GLfloat* yRow = arena.Allocate<GLfloat>(numSamples_per_side);
+        GLfloat* zRow = arena.Allocate<GLfloat>(numSamples_per_side);
+        for (int i = 0; i < numSamples_per_side; i++) {
+            xRow[i] = -GRID_HALF_EXTENT + (i * step);
+        }
+
+        for (size_t k = k_begin; k < k_end; k++) {
+            for (int j = 0; j < numSamples_per_side; j++) {
+                std::fill(yRow, yRow + numSamples_per_side, -GRID_HALF_EXTENT + (j * step));
+                std::fill(zRow, zRow + numSamples_per_side, -GRID_HALF_EXTENT + (k * step));
+
+                GLfloat* row = &volume[(k * numSamples_per_side + j) * numSamples_per_side];
+                orbital.densities(orbital, xRow, yRow, zRow, row, numSamples_per_side);
+                for (int i = 0; i < numSamples_per_side; i++) {
+                    row[i] /= orbital.peakDensity;
+                }
+            }
+        }
+        arena.Rewind(mark);
+    });
+}
+
+// Points of a range evaluated together by one thread, so that its temporaries stay small whatever the range
+const size_t RANGE_BATCH_SIZE = 4096;
+
+// Calls densities(first, count, x, y, z, density) for batches of the points [first, first + count) of an N^3 grid,
+// with the coordinates of the grid point whose index is (a * N + b) * N + c at (c, b, a) if xFastest and (a, b, c) if not
+template<typename Densities>
+static void forEachRangeBatch(const Orbital& orbital, int N, size_t first, size_t count, bool xFastest, Densities densities)
+{
+    GLfloat step = 2 * GRID_HALF_EXTENT / (N - 1);
+    ScratchArena* arenas = slabArenas();
+    parallelForSlabs(count, [&](unsigned int slab, size_t p_begin, size_t p_end) {
+        ScratchArena& arena = arenas[slab];
+        const ScratchMark mark = arena.Mark();
+        GLfloat* x = arena.Allocate<GLfloat>(RANGE_BATCH_SIZE);
+        GLfloat* y = arena.Allocate<GLfloat>(RANGE_BATCH_SIZE);
+        GLfloat* z = arena.Allocate<GLfloat>(RANGE_BATCH_SIZE);
+        GLfloat* density = arena.Allocate<GLfloat>(RANGE_BATCH_SIZE);
+        for (size_t batch = p_begin; batch < p_end; batch += RANGE_BATCH_SIZE) {
+            const size_t batchSize = std::min(RANGE_BATCH_SIZE, p_end - batch);
+            for (size_t p = 0; p < batchSize; p++) {
+                const size_t index = first + batch + p;
+                const size_t a = index / ((size_t)N * N), b = (index / N) % N, c = index % N;
+                x[p] = -GRID_HALF_EXTENT + ((xFastest ? c : a) * step);
+                y[p] = -GRID_HALF_EXTENT + (b * step);
+                z[p] = -GRID_HALF_EXTENT + ((xFastest ? a : c) * step);
+            }
+            orbital.densities(orbital, x, y, z, density, batchSize);
+            densities(batch, batchSize, x, y, z, density);
+        }
+        arena.Rewind(mark);
+    });
+}
+
+// Evaluates the spheres [first, first + count) of a numSpheres_per_side^3 grid into spheres[0, count)
+void evaluateGridRange(const Orbital& orbital, int numSpheres_per_side, size_t first, size_t count, SphereInstance* spheres)
+{
+    GLfloat step = 2 * GRID_HALF_EXTENT / (numSpheres_per_side - 1);
+    forEachRangeBatch(orbital, numSpheres_per_side, first, count, false,
+                      [&](size_t batch, size_t batchSize, const GLfloat* x, const GLfloat* y, const GLfloat* z, const GLfloat* density) {
+        for (size_t p = 0; p < batchSize; p++) {
+            SphereInstance& sphere = spheres[batch + p];
+            sphere.x = x[p];
+            sphere.y = y[p];
+            sphere.z = z[p];
+            setSphereDensity(sphere, density[p] / orbital.peakDensity, step);
+        }
+    });
+}
+
+// Same for the samples [first, first + count) of evaluateDensityVolume (x fastest), into volume[0, count)
+void evaluateDensityVolumeRange(const Orbital& orbital, int numSamples_per_side, size_t first, size_t count, GLfloat* volume)
+{
+    forEachRangeBatch(orbital, numSamples_per_side, first, count, true,
+                      [&](size_t batch, size_t batchSize, const GLfloat*, const GLfloat*, const GLfloat*, const GLfloat* density) {
+        for (size_t p = 0; p < batchSize; p++) {
+            volume[batch + p] = density[p] / orbital.peakDensity;
+        }
+    });
+}
+
+// Returns the description of the (n, l, ml) orbital
+Orbital findOrbital(int n, int l, int ml)
+{
+    for (const Orbital& orbital : orbitals) {
+        if (orbital.n == n && orbital.l == l && orbital.ml == abs(ml)) {
+            return orbital;
+        }
+    }
+    // The outermost maximum of the radial probability is near n^2 Bohr, the axes extend a bit beyond it
+    GLfloat extentBohr = 1.5f * n * n;
+    return { n, l, abs(ml), extentBohr, generalPeakDensity(n, l, ml, extentBohr), evaluateGeneralGrid, evaluateGeneralDensities };
+}
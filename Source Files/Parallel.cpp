@@ -0,0 +1,161 @@
+#include"Parallel.h"
+
+#include<algorithm>
+#include<condition_variable>
+#include<deque>
+#include<mutex>
+#include<thread>
+#include<vector>
+
+// Number of worker threads parallelFor splits work across (one per hardware thread)
+unsigned int numWorkerThreads()
+{
+    // hardware_concurrency may return 0 when it cannot be determined
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+namespace {
+
+// One parallelForSlabs call: its slabs are claimed in order by the pool threads and the calling thread
+struct SlabJob
+{
+    const std::function<void(unsigned int slab, size_t begin, size_t end)>* body;
+    size_t count;
+    size_t numSlabs;
+    // Next slab nobody has claimed yet (slab 0 is the caller's)
+    size_t nextSlab = 1;
+    // Slabs that have not finished yet
+    size_t remaining;
+};
+
+// numWorkerThreads() - 1 threads that live as long as the program, so a parallelFor costs a wake-up instead of
+// creating and joining a thread per slab
+class WorkerPool
+{
+public:
+    WorkerPool()
+    {
+        for (unsigned int i = 1; i < numWorkerThreads(); i++) {
+            threads.emplace_back([this]() { work(); });
+        }
+    }
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // Runs every slab of job, slab 0 on the calling thread, and returns once they are all done
+    void Run(SlabJob& job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(&job);
+        }
+        workAvailable.notify_all();
+        runSlab(job, 0);
+
+        // Works on the slabs of job nobody has claimed (also what keeps a parallelFor inside a slab from waiting on
+        // pool threads that are all busy), then waits for the ones that are still running
+        std::unique_lock<std::mutex> lock(mutex);
+        finishSlab(job);
+        while (job.remaining > 0) {
+            if (job.nextSlab < job.numSlabs) {
+                const size_t slab = claimSlab(job);
+                lock.unlock();
+                runSlab(job, slab);
+                lock.lock();
+                finishSlab(job);
+            }
+            else {
+                jobDone.wait(lock);
+            }
+        }
+    }
+private:
+    std::mutex mutex;
+    std::condition_variable workAvailable, jobDone;
+    // Jobs with slabs nobody has claimed yet, oldest first
+    std::deque<SlabJob*> jobs;
+    std::vector<std::thread> threads;
+    bool stopping = false;
+
+    // Loop of a pool thread: claims the next slab of the oldest job until the pool is destroyed
+    void work()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            workAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            SlabJob& job = *jobs.front();
+            const size_t slab = claimSlab(job);
+            lock.unlock();
+            runSlab(job, slab);
+            lock.lock();
+            finishSlab(job);
+        }
+    }
+    // Takes the next slab of job, which must have one left (called with mutex held)
+    size_t claimSlab(SlabJob& job)
+    {
+        const size_t slab = job.nextSlab++;
+        if (job.nextSlab == job.numSlabs) {
+            jobs.erase(std::find(jobs.begin(), jobs.end(), &job));
+        }
+        return slab;
+    }
+    // Counts a slab of job as done (called with mutex held)
+    void finishSlab(SlabJob& job)
+    {
+        if (--job.remaining == 0) {
+            jobDone.notify_all();
+        }
+    }
+    static void runSlab(const SlabJob& job, size_t slab)
+    {
+        (*job.body)((unsigned int)slab, job.count * slab / job.numSlabs, job.count * (slab + 1) / job.numSlabs);
+    }
+};
+
+// Created by the first parallelFor that has more than one slab
+WorkerPool& workerPool()
+{
+    static WorkerPool pool;
+    return pool;
+}
+
+}
+
+// Splits [0, count) into one contiguous slab per worker thread and calls body(begin, end) for every slab in parallel
+void parallelFor(size_t count, const std::function<void(size_t begin, size_t end)>& body)
+{
+    parallelForSlabs(count, [&](unsigned int, size_t begin, size_t end) {
+        body(begin, end);
+    });
+}
+
+// Same as parallelFor, but also passes body the index of its slab
+void parallelForSlabs(size_t count, const std::function<void(unsigned int slab, size_t begin, size_t end)>& body)
+{
+    const size_t numSlabs = std::min<size_t>(numWorkerThreads(), count);
+    if (numSlabs <= 1) {
+        body(0, 0, count);
+        return;
+    }
+
+    // The calling thread works on the first slab while the pool threads take the others
+    SlabJob job;
+    job.body = &body;
+    job.count = count;
+    job.numSlabs = numSlabs;
+    job.remaining = numSlabs;
+    workerPool().Run(job);
+}
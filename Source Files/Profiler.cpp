@@ -0,0 +1,275 @@
+#include"Profiler.h"
+
+#include<algorithm>
+#include<iostream>
+#include<sstream>
+#include<iomanip>
+
+// Milliseconds between two wall-clock times
+static double millisecondsBetween(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Constructor that does not log
+Profiler::Profiler()
+{
+    frameStart = summaryStart = std::chrono::steady_clock::now();
+}
+
+// Logs the stats of every frame to path (JSON if path ends in ".json", CSV otherwise)
+void Profiler::OpenLog(const std::string& path)
+{
+    log.open(path);
+    if (!log) {
+        std::cout << "Could not open the stats log " << path << ".\n";
+        return;
+    }
+    logPath = path;
+    logJson = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    logHeaderWritten = false;
+    loggedSections = 0;
+}
+
+// Starts a frame
+void Profiler::BeginFrame()
+{
+    frameStart = std::chrono::steady_clock::now();
+    instances = triangles = 0;
+    readQueries();
+}
+
+// Creates the section name ahead of its first BeginGpu
+void Profiler::AddGpuSection(const char* name)
+{
+    findSection(name);
+}
+
+// Starts timing the GPU work of a section of the frame
+void Profiler::BeginGpu(const char* name)
+{
+    currentSection = findSection(name);
+    glBeginQuery(GL_TIME_ELAPSED, sections[currentSection].queries[ringFrame]);
+}
+
+// Stops timing the current section
+void Profiler::EndGpu()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    sections[currentSection].issued[ringFrame] = true;
+    currentSection = -1;
+}
+
+// Adds one draw to the counters of this frame
+void Profiler::CountDraw(size_t drawInstances, size_t drawTriangles)
+{
+    instances += drawInstances;
+    triangles += drawTriangles;
+}
+
+// Ends a frame; returns whether the summary was updated
+bool Profiler::EndFrame()
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    frameMs = millisecondsBetween(frameStart, now);
+
+    // GPU times are the latest ones read back (NUM_QUERY_FRAMES frames old)
+    gpuMs = 0;
+    for (const GpuSection& section : sections) {
+        if (section.measured) {
+            gpuMs += section.ms;
+        }
+    }
+    writeLog();
+
+    sumFrameMs += frameMs;
+    sumGpuMs += gpuMs;
+    sumInstances += instances;
+    sumTriangles += triangles;
+    summaryFrames++;
+    frameNumber++;
+    ringFrame = (ringFrame + 1) % NUM_QUERY_FRAMES;
+
+    if (millisecondsBetween(summaryStart, now) < SUMMARY_INTERVAL_SECONDS * 1000) {
+        return false;
+    }
+    avgFrameMs = sumFrameMs / summaryFrames;
+    avgGpuMs = sumGpuMs / summaryFrames;
+    avgInstances = sumInstances / summaryFrames;
+    avgTriangles = sumTriangles / summaryFrames;
+    sumFrameMs = sumGpuMs = 0;
+    sumInstances = sumTriangles = summaryFrames = 0;
+    summaryStart = now;
+    return true;
+}
+
+// One line summary of the averages
+std::string Profiler::Summary()
+{
+    std::ostringstream summary;
+    summary << std::fixed << std::setprecision(1);
+    summary << avgFrameMs << " ms frame (" << (avgFrameMs > 0 ? 1000 / avgFrameMs : 0) << " fps) | " << avgGpuMs << " ms GPU";
+    for (const GpuSection& section : sections) {
+        if (section.measured) {
+            summary << " (" << section.name << " " << section.ms << ")";
+        }
+    }
+    summary << " | " << avgInstances << " instances | " << avgTriangles << " triangles";
+    return summary.str();
+}
+
+// Records the wall-clock time of a CPU scope (and prints it)
+void Profiler::RecordCpu(const std::string& name, double ms)
+{
+    cpuTimes.push_back({ name, ms });
+    std::cout << name << ": " << std::fixed << std::setprecision(2) << ms << " ms.\n" << std::defaultfloat;
+}
+
+// Deletes the queries and closes the log
+void Profiler::Delete()
+{
+    for (GpuSection& section : sections) {
+        glDeleteQueries(NUM_QUERY_FRAMES, section.queries);
+    }
+    sections.clear();
+    if (log.is_open()) {
+        if (logJson) {
+            log << (logHeaderWritten ? "\n]\n" : "[]\n");
+        }
+        log.close();
+    }
+}
+
+// Index of the section name, created if there is none yet
+int Profiler::findSection(const char* name)
+{
+    for (size_t i = 0; i < sections.size(); i++) {
+        if (sections[i].name == name) {
+            return (int)i;
+        }
+    }
+    GpuSection section;
+    section.name = name;
+    glGenQueries(NUM_QUERY_FRAMES, section.queries);
+    std::fill(section.issued, section.issued + NUM_QUERY_FRAMES, false);
+    section.ms = 0;
+    section.measured = false;
+    sections.push_back(section);
+    return (int)sections.size() - 1;
+}
+
+// Reads the queries of the ring frame that is reused next
+void Profiler::readQueries()
+{
+    for (GpuSection& section : sections) {
+        // Sections that were not drawn in that frame have no time
+        section.measured = section.issued[ringFrame];
+        section.ms = 0;
+        if (section.measured) {
+            // Issued NUM_QUERY_FRAMES frames ago, so the result is normally available without waiting
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(section.queries[ringFrame], GL_QUERY_RESULT, &nanoseconds);
+            section.ms = nanoseconds / 1.0e6;
+            section.issued[ringFrame] = false;
+        }
+    }
+}
+
+// Writes the CSV header with a column for every section
+void Profiler::writeCsvHeader()
+{
+    log << "frame,frame_ms,gpu_ms";
+    for (const GpuSection& section : sections) {
+        log << "," << section.name << "_gpu_ms";
+    }
+    log << ",instances,triangles\n";
+    loggedSections = sections.size();
+}
+
+// Rewrites the CSV log with the columns of the sections added since its header was written
+void Profiler::extendCsvLog()
+{
+    log.close();
+    std::vector<std::string> rows;
+    std::ifstream oldLog(logPath);
+    std::string row;
+    std::getline(oldLog, row);
+    while (std::getline(oldLog, row)) {
+        rows.push_back(row);
+    }
+    oldLog.close();
+
+    // The new sections come last, so their cells go right before instances (after frame, frame_ms, gpu_ms and the old sections)
+    const std::string emptyCells(sections.size() - loggedSections, ',');
+    const size_t cellsBefore = 3 + loggedSections;
+    log.open(logPath, std::ios::trunc);
+    writeCsvHeader();
+    for (const std::string& oldRow : rows) {
+        size_t position = 0;
+        for (size_t cell = 0; cell < cellsBefore && position != std::string::npos; cell++) {
+            position = oldRow.find(',', position);
+            position = (position == std::string::npos) ? position : position + 1;
+        }
+        if (position == std::string::npos) {
+            log << oldRow << "\n";
+        } else {
+            log << oldRow.substr(0, position) << emptyCells << oldRow.substr(position) << "\n";
+        }
+    }
+}
+
+// Writes the stats of the last frame to the log
+void Profiler::writeLog()
+{
+    if (!log.is_open()) {
+        return;
+    }
+    if (logJson) {
+        log << (logHeaderWritten ? ",\n" : "[\n");
+        log << "{\"frame\": " << frameNumber << ", \"frame_ms\": " << frameMs << ", \"gpu_ms\": " << gpuMs;
+        for (const GpuSection& section : sections) {
+            if (section.measured) {
+                log << ", \"" << section.name << "_gpu_ms\": " << section.ms;
+            }
+        }
+        log << ", \"instances\": " << instances << ", \"triangles\": " << triangles << "}";
+    } else {
+        // Sections added with AddGpuSection or drawn in the first frame are in the header; later ones extend it
+        if (!logHeaderWritten) {
+            writeCsvHeader();
+        } else if (sections.size() > loggedSections) {
+            extendCsvLog();
+        }
+        log << frameNumber << "," << frameMs << "," << gpuMs;
+        // Empty cells for the sections without a time this frame
+        for (const GpuSection& section : sections) {
+            log << ",";
+            if (section.measured) {
+                log << section.ms;
+            }
+        }
+        log << "," << instances << "," << triangles << "\n";
+    }
+    logHeaderWritten = true;
+}
+
+// Starts measuring
+CpuScope::CpuScope(Profiler& profiler, const std::string& name) : profiler(profiler), name(name)
+{
+    start = std::chrono::steady_clock::now();
+}
+
+// Records the time since the construction (only the first time)
+void CpuScope::End()
+{
+    if (!ended) {
+        profiler.RecordCpu(name, millisecondsBetween(start, std::chrono::steady_clock::now()));
+        ended = true;
+    }
+}
+
+// Records the time since the construction unless End already did
+CpuScope::~CpuScope()
+{
+    End();
+}
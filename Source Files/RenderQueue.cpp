@@ -0,0 +1,54 @@
+#include"RenderQueue.h"
+
+#include<algorithm>
+#include<tuple>
+#include<glm/gtc/type_ptr.hpp>
+
+// Adds a draw to the queue
+void RenderQueue::Submit(const DrawCommand& command)
+{
+    commands.push_back(command);
+}
+
+// Issues every draw submitted since the last Flush and empties the queue
+void RenderQueue::Flush(Camera& camera, Profiler& profiler)
+{
+    // Draws that share a program stay together, then those that share a vertex array, then a texture
+    // (the sort is stable, so draws with the same state keep the order they were submitted in)
+    auto sortKey = [](const DrawCommand& command) {
+        return std::make_tuple(command.shader->ID, command.vao, (command.texture != NULL) ? command.texture->ID : 0);
+    };
+    std::stable_sort(commands.begin(), commands.end(), [&](const DrawCommand& a, const DrawCommand& b) {
+        return sortKey(a) < sortKey(b);
+    });
+
+    programChanges = vaoChanges = textureChanges = 0;
+    const Shader* program = NULL;
+    GLuint vao = 0;
+    const Texture* texture = NULL;
+    for (const DrawCommand& command : commands) {
+        if (command.shader != program) {
+            program = command.shader;
+            command.shader->Activate();
+            // Exports the camera Position and camMatrix once per program
+            glUniform3f(command.shader->Uniform("camPos"), camera.Position.x, camera.Position.y, camera.Position.z);
+            camera.Matrix(*command.shader, "camMatrix");
+            programChanges++;
+        }
+        if (command.vao != vao || vaoChanges == 0) {
+            vao = command.vao;
+            glBindVertexArray(command.vao);
+            vaoChanges++;
+        }
+        if (command.texture != NULL && command.texture != texture) {
+            texture = command.texture;
+            command.texture->Bind();
+            textureChanges++;
+        }
+        glUniformMatrix4fv(command.shader->Uniform("model"), 1, GL_FALSE, glm::value_ptr(command.model));
+        // Draw primitives, number of indices, datatype of indices, index of indices
+        glDrawElements(GL_TRIANGLES, command.count, GL_UNSIGNED_INT, 0);
+        profiler.CountDraw(1, command.count / 3);
+    }
+    commands.clear();
+}
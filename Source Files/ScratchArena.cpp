@@ -0,0 +1,68 @@
+#include"ScratchArena.h"
+
+#include<algorithm>
+
+#include"Parallel.h"
+
+// Size of the first block of an arena
+const size_t FIRST_SCRATCH_BLOCK_SIZE = 64 * 1024;
+
+// Current position of the arena
+ScratchMark ScratchArena::Mark()
+{
+    return { block, used };
+}
+
+// Frees everything allocated since mark was taken
+void ScratchArena::Rewind(ScratchMark mark)
+{
+    block = mark.block;
+    used = mark.used;
+    // Nothing is allocated any more, so the blocks can be merged; the next round fits in the first block
+    if (block == 0 && used == 0 && blocks.size() > 1) {
+        size_t totalSize = 0;
+        for (size_t size : blockSizes) {
+            totalSize += size;
+        }
+        blocks.clear();
+        blocks.emplace_back(new std::max_align_t[totalSize / sizeof(std::max_align_t)]);
+        blockSizes.assign(1, totalSize);
+    }
+}
+
+// Bytes held by the arena
+size_t ScratchArena::Capacity()
+{
+    size_t totalSize = 0;
+    for (size_t size : blockSizes) {
+        totalSize += size;
+    }
+    return totalSize;
+}
+
+// Returns bytes bytes of the current block, moving on to (or adding) a larger block if they do not fit
+void* ScratchArena::allocateBytes(size_t bytes)
+{
+    // Every allocation starts at a multiple of max_align_t
+    bytes = (bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t) * sizeof(std::max_align_t);
+    while (block < blocks.size() && used + bytes > blockSizes[block]) {
+        block++;
+        used = 0;
+    }
+    if (block == blocks.size()) {
+        size_t size = std::max(bytes, blocks.empty() ? FIRST_SCRATCH_BLOCK_SIZE : 2 * blockSizes.back());
+        blocks.emplace_back(new std::max_align_t[size / sizeof(std::max_align_t)]);
+        blockSizes.push_back(size);
+    }
+    void* memory = (char*)blocks[block].get() + used;
+    used += bytes;
+    return memory;
+}
+
+// Arenas of the calling thread, one per slab of parallelForSlabs
+ScratchArena* slabArenas()
+{
+    // Freed when the thread ends
+    thread_local std::vector<ScratchArena> arenas(numWorkerThreads());
+    return arenas.data();
+}
@@ -0,0 +1,253 @@
+#include"Sphere.h"
+
+#include<algorithm>
+#include<array>
+#include<cmath>
+
+#include"Parallel.h"
+
+// Sphere vertices and indices generation from "OpenGL Sphere Tutorial" by Song Ho Ahn
+// https://www.songho.ca/opengl/gl_sphere.html
+
+const float PI = M_PI;
+
+//------------------------------------ UNIT SPHERE TEMPLATE ------------------------------------//
+// The sectorCount x stackCount sphere every baked sphere is a scaled and moved copy of, built at compile time
+
+// Vertex of the unit sphere: position (also the normal) and the octahedral encoded normal of CompactVertex
+struct UnitSphereVertex
+{
+    GLfloat x, y, z;
+    GLbyte octahedral[2];
+};
+
+// sin(angle) for angle in [-2 pi, 2 pi]; the Taylor series is exact to double precision after 40 terms there
+static constexpr double constexprSin(double angle)
+{
+    double term = angle, sum = angle;
+    for (int k = 1; k < 40; k++) {
+        term *= -angle * angle / ((2 * k) * (2 * k + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+// cos(angle) for angle in [-2 pi, 2 pi]
+static constexpr double constexprCos(double angle)
+{
+    double term = 1.0, sum = 1.0;
+    for (int k = 1; k < 40; k++) {
+        term *= -angle * angle / ((2 * k - 1) * (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+// Rounds value in [-1, 1] to a snorm8, half away from zero like quantize
+static constexpr GLbyte constexprSnorm8(double value)
+{
+    return (GLbyte)(int)(value * 127 + (value >= 0 ? 0.5 : -0.5));
+}
+
+// Generates the unit sphere the same way as generateUnitSphereVertices
+static constexpr std::array<UnitSphereVertex, NUM_VERTICES_PER_SPHERE> generateUnitSphereTemplate()
+{
+    std::array<UnitSphereVertex, NUM_VERTICES_PER_SPHERE> unitSphere = {};
+    const double sectorStep = 2 * M_PI / sectorCount;
+    const double stackStep = M_PI / stackCount;
+    int vertex = 0;
+    for (int i_local = 0; i_local <= stackCount; ++i_local)
+    {
+        const double stackAngle = M_PI / 2 - i_local * stackStep;     // starting from pi/2 to -pi/2
+        const double xy_local = constexprCos(stackAngle);             // cos(u)
+        const double z_local = constexprSin(stackAngle);              // sin(u)
+        // first and last vertices of a stack have same position and normal
+        for (int j_local = 0; j_local <= sectorCount; ++j_local)
+        {
+            const double sectorAngle = j_local * sectorStep;          // starting from 0 to 2pi
+            const double nx = xy_local * constexprCos(sectorAngle);   // cos(u) * cos(v)
+            const double ny = xy_local * constexprSin(sectorAngle);   // cos(u) * sin(v)
+            const double nz = z_local;
+
+            UnitSphereVertex& unit = unitSphere[vertex++];
+            unit.x = (GLfloat)nx;
+            unit.y = (GLfloat)ny;
+            unit.z = (GLfloat)nz;
+
+            // projected onto the octahedron |x| + |y| + |z| = 1, the lower half folded over the upper one
+            const double l1 = (nx < 0 ? -nx : nx) + (ny < 0 ? -ny : ny) + (nz < 0 ? -nz : nz);
+            double ox = nx / l1, oy = ny / l1;
+            if (nz < 0) {
+                const double fx = (1 - (oy < 0 ? -oy : oy)) * (ox >= 0 ? 1 : -1);
+                oy = (1 - (ox < 0 ? -ox : ox)) * (oy >= 0 ? 1 : -1);
+                ox = fx;
+            }
+            unit.octahedral[0] = constexprSnorm8(ox);
+            unit.octahedral[1] = constexprSnorm8(oy);
+        }
+    }
+    return unitSphere;
+}
+
+static_assert(NUM_VERTICES_PER_SPHERE == (sectorCount + 1) * (stackCount + 1), "NUM_VERTICES_PER_SPHERE does not match sectorCount and stackCount");
+static constexpr std::array<UnitSphereVertex, NUM_VERTICES_PER_SPHERE> UNIT_SPHERE = generateUnitSphereTemplate();
+
+//------------------------------------ SPHERE GENERATION ------------------------------------//
+
+// Generates the positions of a sphere of radius 1 centered on the origin (also its normals)
+std::vector<GLfloat> generateUnitSphereVertices(int sectors, int stacks)
+{
+    std::vector<GLfloat> unitSphereVertices;
+    unitSphereVertices.reserve((sectors + 1) * (stacks + 1) * 3);
+
+    GLfloat sectorStep = 2 * PI / sectors;
+    GLfloat stackStep = PI / stacks;
+    GLfloat sectorAngle, stackAngle;
+
+    for(int i_local = 0; i_local <= stacks; ++i_local)
+    {
+        stackAngle = PI / 2 - i_local * stackStep;        // starting from pi/2 to -pi/2
+        GLfloat xy_local = cosf(stackAngle);              // cos(u)
+        GLfloat z_local = sinf(stackAngle);               // sin(u)
+        // add (sectors+1) vertices per stack
+        for(int j_local = 0; j_local <= sectors; ++j_local)
+        {
+            sectorAngle = j_local * sectorStep;           // starting from 0 to 2pi
+
+            unitSphereVertices.push_back(xy_local * cosf(sectorAngle));   // cos(u) * cos(v)
+            unitSphereVertices.push_back(xy_local * sinf(sectorAngle));   // cos(u) * sin(v)
+            unitSphereVertices.push_back(z_local);
+        }
+    }
+    return unitSphereVertices;
+}
+
+// Writes the interleaved vertices (coordinates, color, texcoord, normal) of one complete sphere
+// directly into vertices, which must have room for NUM_VERTICES_PER_SPHERE * NUM_FLOATS_PER_VERTEX floats
+void writeSphereVertices(const SphereInstance& sphere, GLfloat* vertices)
+{
+    // Every vertex is the unit sphere vertex scaled by the radius and moved to the center
+    for (const UnitSphereVertex& unit : UNIT_SPHERE)
+    {
+        // COORDINATES:
+        *vertices++ = sphere.x + sphere.radius * unit.x;
+        *vertices++ = sphere.y + sphere.radius * unit.y;
+        *vertices++ = sphere.z + sphere.radius * unit.z;
+        // COLORS:
+        *vertices++ = sphere.red;
+        *vertices++ = sphere.green;
+        *vertices++ = sphere.blue;
+        // TEXCOORD:
+        *vertices++ = 0.0f;                                 // NO TEXTURE
+        *vertices++ = 0.0f;                                 // NO TEXTURE
+        // NORMALS: the unit sphere position (valid for radius 0 too)
+        *vertices++ = unit.x;
+        *vertices++ = unit.y;
+        *vertices++ = unit.z;
+    }
+}
+
+// Writes the vertices of count spheres back to back into vertices (in parallel, each sphere into its own slot)
+void writeSphereMeshVertices(const SphereInstance* spheres, size_t count, GLfloat* vertices)
+{
+    const size_t floatsPerSphere = NUM_VERTICES_PER_SPHERE * NUM_FLOATS_PER_VERTEX;
+    parallelFor(count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            writeSphereVertices(spheres[i], vertices + i * floatsPerSphere);
+        }
+    });
+}
+
+// Rounds value in [-1, 1] to an integer in [-maxValue, maxValue]: a snorm with maxValue = 2^(bits-1) - 1,
+// or a unorm with maxValue = 2^bits - 1 for values in [0, 1]
+static int quantize(GLfloat value, int maxValue)
+{
+    return (int)lroundf(std::min(std::max(value, -1.0f), 1.0f) * maxValue);
+}
+
+// Writes the compact vertices of one complete sphere into vertices
+void writeCompactSphereVertices(const SphereInstance& sphere, CompactVertex* vertices)
+{
+    const GLubyte red = (GLubyte)quantize(sphere.red, 255);
+    const GLubyte green = (GLubyte)quantize(sphere.green, 255);
+    const GLubyte blue = (GLubyte)quantize(sphere.blue, 255);
+
+    for (const UnitSphereVertex& unit : UNIT_SPHERE)
+    {
+        // COORDINATES:
+        vertices->x = (GLshort)quantize((sphere.x + sphere.radius * unit.x) / COMPACT_POSITION_SCALE, 32767);
+        vertices->y = (GLshort)quantize((sphere.y + sphere.radius * unit.y) / COMPACT_POSITION_SCALE, 32767);
+        vertices->z = (GLshort)quantize((sphere.z + sphere.radius * unit.z) / COMPACT_POSITION_SCALE, 32767);
+        // NORMALS: the same for every sphere
+        vertices->normal[0] = unit.octahedral[0];
+        vertices->normal[1] = unit.octahedral[1];
+        // COLORS:
+        vertices->color[0] = red;
+        vertices->color[1] = green;
+        vertices->color[2] = blue;
+        vertices->color[3] = 255;
+        vertices++;
+    }
+}
+
+// Writes the compact vertices of count spheres back to back into vertices (in parallel, each sphere into its own slot)
+void writeCompactSphereMeshVertices(const SphereInstance* spheres, size_t count, CompactVertex* vertices)
+{
+    parallelFor(count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            writeCompactSphereVertices(spheres[i], vertices + i * NUM_VERTICES_PER_SPHERE);
+        }
+    });
+}
+
+// Writes the indices of count spheres back to back into indices, offsetting sphereIndices by NUM_VERTICES_PER_SPHERE per sphere
+void writeSphereMeshIndices(const std::vector<GLuint>& sphereIndices, size_t count, GLuint* indices)
+{
+    parallelFor(count, [&](size_t begin, size_t end) {
+        GLuint* sphereMeshIndices = indices + begin * sphereIndices.size();
+        for (size_t i = begin; i < end; i++) {
+            const GLuint firstVertex = (GLuint)(i * NUM_VERTICES_PER_SPHERE);
+            for (GLuint index : sphereIndices) {
+                *sphereMeshIndices++ = index + firstVertex;
+            }
+        }
+    });
+}
+
+// Generates the CCW index list of the triangles of one sphere
+// k1--k1+1
+// |  / |
+// | /  |
+// k2--k2+1
+std::vector<GLuint> generateSphereIndices(int sectors, int stacks)
+{
+    std::vector<GLuint> singleSphere_IndicesVec;
+    singleSphere_IndicesVec.reserve(2 * sectors * (stacks - 1) * 3);
+    int k1, k2;
+    for(int i = 0; i < stacks; ++i)
+    {
+        k1 = i * (sectors + 1);     // beginning of current stack
+        k2 = k1 + sectors + 1;      // beginning of next stack
+
+        for(int j = 0; j < sectors; ++j, ++k1, ++k2)
+        {
+            // 2 triangles per sector excluding first and last stacks
+            // k1 => k2 => k1+1
+            if(i != 0)
+            {
+                singleSphere_IndicesVec.push_back(k1);
+                singleSphere_IndicesVec.push_back(k2);
+                singleSphere_IndicesVec.push_back(k1 + 1);
+            }
+
+            // k1+1 => k2 => k2+1
+            if(i != (stacks-1))
+            {
+                singleSphere_IndicesVec.push_back(k1 + 1);
+                singleSphere_IndicesVec.push_back(k2);
+                singleSphere_IndicesVec.push_back(k2 + 1);
+            }
+        }
+    }
+    return singleSphere_IndicesVec;
+}
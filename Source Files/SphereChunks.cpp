@@ -0,0 +1,148 @@
+#include"SphereChunks.h"
+
+#include<algorithm>
+#include<cmath>
+
+#include"Orbitals.h"
+#include"ScratchArena.h"
+
+// Chunk of a point of the cube of the axes
+static int chunkOf(const SphereInstance& sphere)
+{
+    int cell[3];
+    const GLfloat coordinates[3] = { sphere.x, sphere.y, sphere.z };
+    for (int axis = 0; axis < 3; axis++) {
+        int c = (int)std::floor((coordinates[axis] + GRID_HALF_EXTENT) / (2 * GRID_HALF_EXTENT) * CHUNKS_PER_SIDE);
+        cell[axis] = std::clamp(c, 0, CHUNKS_PER_SIDE - 1);
+    }
+    return (cell[0] * CHUNKS_PER_SIDE + cell[1]) * CHUNKS_PER_SIDE + cell[2];
+}
+
+// Constructor that generates the source buffer
+SphereChunks::SphereChunks() : sourceVBO(NULL, 0)
+{
+    sourceVBO.Unbind();
+}
+
+// Groups spheres by chunk, uploads them and resizes visibleVBO to hold all of them
+void SphereChunks::Build(const SphereInstance* spheres, size_t count, VBO& visibleVBO, size_t capacity)
+{
+    const int numChunks = CHUNKS_PER_SIDE * CHUNKS_PER_SIDE * CHUNKS_PER_SIDE;
+    this->capacity = std::max(count, capacity);
+    sourceVBO.Resize(NULL, this->capacity * sizeof(SphereInstance));
+    chunkFirst.assign(numChunks + 1, 0);
+    chunkMin.assign(numChunks, glm::vec3(INFINITY));
+    chunkMax.assign(numChunks, glm::vec3(-INFINITY));
+    group(spheres, 0, count, 0);
+    visibleVBO.Resize(NULL, this->capacity * sizeof(SphereInstance), GL_DYNAMIC_COPY);
+    visibleVBO.Unbind();
+    // Forces the next Cull
+    lastCameraMatrix = glm::mat4(0.0f);
+    visibleCount = 0;
+}
+
+// Regroups and uploads only the chunks that spheres[firstChanged, count) fall in
+void SphereChunks::Refresh(const SphereInstance* spheres, size_t count, size_t firstChanged, VBO& visibleVBO)
+{
+    const int chunksPerColumn = CHUNKS_PER_SIDE * CHUNKS_PER_SIDE;
+    const size_t previousCount = chunkFirst.empty() ? 0 : chunkFirst.back();
+    if (count > capacity || firstChanged > previousCount) {
+        Build(spheres, count, visibleVBO, capacity);
+        return;
+    }
+    // The first column of chunks (of constant x) that changed: the one the first changed sphere was in before, or
+    // is in now if that is lower (all spheres before that column are before firstChanged, so they stay as they are)
+    int firstColumn = CHUNKS_PER_SIDE;
+    if (firstChanged < previousCount) {
+        firstColumn = (int)(std::upper_bound(chunkFirst.begin(), chunkFirst.end(), firstChanged) - chunkFirst.begin() - 1) / chunksPerColumn;
+    }
+    if (firstChanged < count) {
+        firstColumn = std::min(firstColumn, chunkOf(spheres[firstChanged]) / chunksPerColumn);
+    }
+    const int firstChunk = firstColumn * chunksPerColumn;
+    if (firstChunk < (int)chunkMin.size()) {
+        std::fill(chunkMin.begin() + firstChunk, chunkMin.end(), glm::vec3(INFINITY));
+        std::fill(chunkMax.begin() + firstChunk, chunkMax.end(), glm::vec3(-INFINITY));
+        group(spheres, chunkFirst[firstChunk], count, firstChunk);
+    }
+    // Forces the next Cull
+    lastCameraMatrix = glm::mat4(0.0f);
+}
+
+// Groups spheres[first, count) into the chunks from firstChunk on and uploads them behind the first spheres
+void SphereChunks::group(const SphereInstance* spheres, size_t first, size_t count, int firstChunk)
+{
+    const int numChunks = (int)chunkMin.size();
+    const size_t groupCount = count - first;
+
+    // The sort temporaries are scratch memory of this thread, freed once the spheres are uploaded
+    ScratchArena& arena = slabArenas()[0];
+    const ScratchMark mark = arena.Mark();
+
+    // Counting sort of the spheres by chunk
+    int* sphereChunk = arena.Allocate<int>(groupCount);
+    std::fill(chunkFirst.begin() + firstChunk + 1, chunkFirst.end(), 0);
+    chunkFirst[firstChunk] = first;
+    for (size_t i = 0; i < groupCount; i++) {
+        sphereChunk[i] = std::max(chunkOf(spheres[first + i]), firstChunk);
+        chunkFirst[sphereChunk[i] + 1]++;
+    }
+    for (int chunk = firstChunk; chunk < numChunks; chunk++) {
+        chunkFirst[chunk + 1] += chunkFirst[chunk];
+    }
+    SphereInstance* groupedSpheres = arena.Allocate<SphereInstance>(groupCount);
+    size_t* next = arena.Allocate<size_t>(numChunks);
+    std::copy(chunkFirst.begin(), chunkFirst.end() - 1, next);
+    for (size_t i = 0; i < groupCount; i++) {
+        const SphereInstance& sphere = spheres[first + i];
+        const int chunk = sphereChunk[i];
+        groupedSpheres[next[chunk]++ - first] = sphere;
+        chunkMin[chunk] = glm::min(chunkMin[chunk], glm::vec3(sphere.x - sphere.radius, sphere.y - sphere.radius, sphere.z - sphere.radius));
+        chunkMax[chunk] = glm::max(chunkMax[chunk], glm::vec3(sphere.x + sphere.radius, sphere.y + sphere.radius, sphere.z + sphere.radius));
+    }
+
+    sourceVBO.Update((const GLfloat*)groupedSpheres, groupCount * sizeof(SphereInstance), first * sizeof(SphereInstance));
+    sourceVBO.Unbind();
+    arena.Rewind(mark);
+}
+
+// Copies the spheres of the chunks inside the frustum of camera to the front of visibleVBO
+void SphereChunks::Cull(Camera& camera, VBO& visibleVBO)
+{
+    if (camera.cameraMatrix == lastCameraMatrix) {
+        return;
+    }
+    lastCameraMatrix = camera.cameraMatrix;
+
+    const Frustum frustum = frustumFromMatrix(camera.cameraMatrix);
+    glBindBuffer(GL_COPY_READ_BUFFER, sourceVBO.ID);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, visibleVBO.ID);
+    visibleCount = 0;
+    // Neighbouring visible chunks are contiguous in sourceVBO, so they are copied together
+    size_t runFirst = 0, runCount = 0;
+    const int numChunks = (int)chunkFirst.size() - 1;
+    for (int chunk = 0; chunk <= numChunks; chunk++) {
+        bool visible = chunk < numChunks && chunkFirst[chunk + 1] > chunkFirst[chunk]
+            && boxInFrustum(frustum, chunkMin[chunk], chunkMax[chunk]);
+        if (visible && runCount == 0) {
+            runFirst = chunkFirst[chunk];
+        }
+        if (visible) {
+            runCount += chunkFirst[chunk + 1] - chunkFirst[chunk];
+        // Empty chunks do not end a run
+        } else if (runCount > 0 && (chunk == numChunks || chunkFirst[chunk + 1] > chunkFirst[chunk])) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, runFirst * sizeof(SphereInstance),
+                                visibleCount * sizeof(SphereInstance), runCount * sizeof(SphereInstance));
+            visibleCount += runCount;
+            runCount = 0;
+        }
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+// Deletes the source buffer
+void SphereChunks::Delete()
+{
+    sourceVBO.Delete();
+}
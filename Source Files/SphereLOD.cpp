@@ -0,0 +1,130 @@
+#include"SphereLOD.h"
+
+#include<cmath>
+
+#include"Parallel.h"
+
+// Constructor that generates and uploads the unit sphere of every level of detail
+SphereLODs::SphereLODs() : instanceVBO(0)
+{
+    for (int lod = 0; lod < NUM_SPHERE_LODS; lod++) {
+        std::vector<GLfloat> vertices = generateUnitSphereVertices(LOD_SEGMENTS[lod], LOD_SEGMENTS[lod]);
+        std::vector<GLuint> indices = generateSphereIndices(LOD_SEGMENTS[lod], LOD_SEGMENTS[lod]);
+        lodIndexCounts[lod] = (GLsizei)indices.size();
+
+        lodVAOs.emplace_back();
+        lodVAOs[lod].Bind();
+        lodVBOs.emplace_back(vertices.data(), vertices.size() * sizeof(GLfloat));
+        lodEBOs.emplace_back(indices.data(), indices.size() * sizeof(GLuint));
+        // Unit sphere coordinates (also used as normals); the per-sphere attributes are linked in Draw
+        lodVAOs[lod].LinkAttrib(lodVBOs[lod], 0, 3, GL_FLOAT, 3 * sizeof(float), (void*)0);
+        lodVAOs[lod].Unbind();
+        lodVBOs[lod].Unbind();
+        lodEBOs[lod].Unbind();
+    }
+}
+
+// Chooses the level of detail of every sphere from its projected radius and uploads them grouped by level
+void SphereLODs::Update(const SphereInstance* spheres, size_t count, Camera& camera, float FOVdeg, bool spheresChanged)
+{
+    if (!spheresChanged && camera.cameraMatrix == lastCameraMatrix) {
+        return;
+    }
+    lastCameraMatrix = camera.cameraMatrix;
+
+    // A sphere of radius r at distance d covers about r / d * pixelsPerRadian pixels
+    const GLfloat pixelsPerRadian = 0.5f * camera.height / std::tan(glm::radians(FOVdeg) / 2);
+    const glm::vec3 eye = camera.Position;
+    const Frustum frustum = frustumFromMatrix(camera.cameraMatrix);
+    sphereLODs.resize(count);
+    parallelFor(count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const SphereInstance& sphere = spheres[i];
+            const glm::vec3 center(sphere.x, sphere.y, sphere.z);
+            if (frustumCulling && !sphereInFrustum(frustum, center, sphere.radius)) {
+                sphereLODs[i] = NUM_SPHERE_LODS;
+                continue;
+            }
+            GLfloat distance = glm::length(center - eye);
+            GLfloat pixelRadius = sphere.radius * pixelsPerRadian / std::fmax(distance, 1e-4f);
+            int lod = 0;
+            while (pixelRadius < LOD_MIN_PIXEL_RADIUS[lod]) {
+                lod++;
+            }
+            sphereLODs[i] = (unsigned char)lod;
+        }
+    });
+
+    // Counting sort of the spheres by level of detail, the culled spheres go last and are not uploaded
+    size_t lodFirst[NUM_SPHERE_LODS + 2] = {};
+    for (size_t i = 0; i < count; i++) {
+        lodFirst[sphereLODs[i] + 1]++;
+    }
+    for (int lod = 0; lod <= NUM_SPHERE_LODS; lod++) {
+        if (lod < NUM_SPHERE_LODS) {
+            lodCounts[lod] = lodFirst[lod + 1];
+        }
+        lodFirst[lod + 1] += lodFirst[lod];
+    }
+    size_t drawnCount = 0;
+    for (int lod = 0; lod < NUM_SPHERE_LODS; lod++) {
+        drawnCount += lodCounts[lod];
+    }
+
+    // The grouped spheres are written straight into the next region of the instance buffer
+    // (the ring only grows, all the spheres fit in a region once it has been reserved for count spheres)
+    if ((GLsizeiptr)(count * sizeof(SphereInstance)) > instanceVBO.regionSize) {
+        instanceVBO.Reserve(count * sizeof(SphereInstance));
+    }
+    SphereInstance* groupedSpheres = (SphereInstance*)instanceVBO.Map(drawnCount * sizeof(SphereInstance));
+    if (groupedSpheres != NULL) {
+        for (size_t i = 0; i < count; i++) {
+            if (sphereLODs[i] < NUM_SPHERE_LODS) {
+                groupedSpheres[lodFirst[sphereLODs[i]]++] = spheres[i];
+            }
+        }
+        instanceVBO.Unmap();
+    }
+    instanceVBO.Unbind();
+}
+
+// Draws every level of detail (the instanced shader must be active)
+void SphereLODs::Draw()
+{
+    size_t first = 0;
+    for (int lod = 0; lod < NUM_SPHERE_LODS; lod++) {
+        if (lodCounts[lod] > 0) {
+            // There is no base instance in OpenGL 3.3, so the per-sphere attributes start at the first sphere of this level
+            const size_t offset = instanceVBO.Offset() + first * sizeof(SphereInstance);
+            lodVAOs[lod].Bind();
+            lodVAOs[lod].LinkAttrib(instanceVBO, 1, 3, GL_FLOAT, sizeof(SphereInstance), (void*)(offset + offsetof(SphereInstance, red)), 1);
+            lodVAOs[lod].LinkAttrib(instanceVBO, 4, 4, GL_FLOAT, sizeof(SphereInstance), (void*)(offset + offsetof(SphereInstance, x)), 1);
+            glDrawElementsInstanced(GL_TRIANGLES, lodIndexCounts[lod], GL_UNSIGNED_INT, 0, (GLsizei)lodCounts[lod]);
+        }
+        first += lodCounts[lod];
+    }
+    glBindVertexArray(0);
+    // The region is not written again until these draws are done
+    instanceVBO.Fence();
+}
+
+// Number of triangles Draw draws
+size_t SphereLODs::DrawnTriangles()
+{
+    size_t drawnTriangles = 0;
+    for (int lod = 0; lod < NUM_SPHERE_LODS; lod++) {
+        drawnTriangles += lodCounts[lod] * (lodIndexCounts[lod] / 3);
+    }
+    return drawnTriangles;
+}
+
+// Deletes the meshes and the instance buffer
+void SphereLODs::Delete()
+{
+    for (int lod = 0; lod < NUM_SPHERE_LODS; lod++) {
+        lodVAOs[lod].Delete();
+        lodVBOs[lod].Delete();
+        lodEBOs[lod].Delete();
+    }
+    instanceVBO.Delete();
+}
@@ -0,0 +1,96 @@
+#include"Superposition.h"
+
+#include<algorithm>
+#include<cmath>
+#include<cstdlib>
+#include<iostream>
+
+#include"Orbitals.h"
+#include"Wavefunction.h"
+#include"Parallel.h"
+
+// Checks and normalizes states
+bool buildSuperposition(const std::vector<SuperposedState>& states, Superposition& superposition)
+{
+    superposition.states.clear();
+    superposition.extentBohr = 0;
+    double norm2 = 0;
+    for (const SuperposedState& state : states) {
+        if (state.l + 1 > state.n || abs(state.ml) > state.l || state.l < 0 || std::norm(state.coefficient) == 0) {
+            std::cout << "Skipping state (" << state.n << ", " << state.l << ", " << state.ml << ") of the superposition: not allowed.\n";
+            continue;
+        }
+        if ((int)superposition.states.size() == MAX_SUPERPOSED_STATES) {
+            std::cout << "Skipping state (" << state.n << ", " << state.l << ", " << state.ml << ") of the superposition: at most " << MAX_SUPERPOSED_STATES << " states.\n";
+            continue;
+        }
+        superposition.states.push_back(state);
+        superposition.extentBohr = std::max(superposition.extentBohr, findOrbital(state.n, state.l, state.ml).extentBohr);
+        norm2 += std::norm(state.coefficient);
+    }
+    for (SuperposedState& state : superposition.states) {
+        state.coefficient /= std::sqrt(norm2);
+    }
+    return !superposition.states.empty();
+}
+
+// Evaluates psi_s of every state once on a grid and sets peakDensity
+void evaluateSuperposition(Superposition& superposition, int numSpheres_per_side, std::vector<SuperpositionInstance>& instances)
+{
+    GLfloat step = 2 * GRID_HALF_EXTENT / (numSpheres_per_side - 1);
+    // conversion factor: GRID_HALF_EXTENT units = extentBohr Bohr radii
+    double bohrPerUnit = superposition.extentBohr / GRID_HALF_EXTENT;
+    instances.resize((size_t)numSpheres_per_side * numSpheres_per_side * numSpheres_per_side);
+
+    // Largest sum_s |c_s psi_s|^2 of every slab: |sum_s c_s psi_s e^(-i E_s t)| can never be larger than sum_s |c_s psi_s|
+    std::vector<GLfloat> slabPeak(numSpheres_per_side, 0.0f);
+    parallelFor(numSpheres_per_side, [&](size_t i_begin, size_t i_end) {
+        for (size_t i = i_begin; i < i_end; i++) {
+            for (int j = 0; j < numSpheres_per_side; j++) {
+                for (int k = 0; k < numSpheres_per_side; k++) {
+                    SuperpositionInstance& instance = instances[(i * numSpheres_per_side + j) * numSpheres_per_side + k];
+                    instance.x = -GRID_HALF_EXTENT + (i * step);
+                    instance.y = -GRID_HALF_EXTENT + (j * step);
+                    instance.z = -GRID_HALF_EXTENT + (k * step);
+                    instance.unused = 0.0f;
+                    std::fill(instance.psi, instance.psi + 2 * MAX_SUPERPOSED_STATES, 0.0f);
+
+                    double amplitudeBound = 0;
+                    for (size_t s = 0; s < superposition.states.size(); s++) {
+                        const SuperposedState& state = superposition.states[s];
+                        std::complex<double> psi = wavefunction(state.n, state.l, state.ml, instance.x * bohrPerUnit, instance.y * bohrPerUnit, instance.z * bohrPerUnit);
+                        instance.psi[2 * s] = psi.real();
+                        instance.psi[2 * s + 1] = psi.imag();
+                        amplitudeBound += std::abs(state.coefficient * psi);
+                    }
+                    slabPeak[i] = std::max(slabPeak[i], (GLfloat)(amplitudeBound * amplitudeBound));
+                }
+            }
+        }
+    });
+    superposition.peakDensity = *std::max_element(slabPeak.begin(), slabPeak.end());
+}
+
+// Writes c_s e^(-i E_s t) of every state as (re, im) pairs into phases
+void superpositionPhases(const Superposition& superposition, double t, GLfloat* phases)
+{
+    std::fill(phases, phases + 2 * MAX_SUPERPOSED_STATES, 0.0f);
+    for (size_t s = 0; s < superposition.states.size(); s++) {
+        const SuperposedState& state = superposition.states[s];
+        const double energy = -0.5 / (state.n * state.n);
+        std::complex<double> phase = state.coefficient * std::polar(1.0, -energy * t);
+        phases[2 * s] = phase.real();
+        phases[2 * s + 1] = phase.imag();
+    }
+}
+
+// Probability density at an instance for the phases of superpositionPhases
+GLfloat superpositionDensity(const SuperpositionInstance& instance, const GLfloat* phases)
+{
+    GLfloat re = 0, im = 0;
+    for (int s = 0; s < MAX_SUPERPOSED_STATES; s++) {
+        re += phases[2 * s] * instance.psi[2 * s] - phases[2 * s + 1] * instance.psi[2 * s + 1];
+        im += phases[2 * s] * instance.psi[2 * s + 1] + phases[2 * s + 1] * instance.psi[2 * s];
+    }
+    return re * re + im * im;
+}
@@ -4,14 +4,22 @@ Texture::Texture(std::string image, GLenum texType, GLenum slot, GLenum format,
 {
     // Assigns the type of the texture ot the texture object
     type = texType;
+    unit = slot;
 
-    // Stores the width, height, and the number of color channels of the image
-    int widthImg, heightImg, numColCh;
-    // Flips the image so it appears right side up
-    stbi_set_flip_vertically_on_load(true);
-    // Reads the image from a file and stores it in bytes
-    const char* image_char = image.c_str();
-    unsigned char* bytes = stbi_load(image_char, &widthImg, &heightImg, &numColCh, 0);
+    // Layout of the pixels, needed once the image is uploaded
+    this->format = format;
+    this->pixelType = pixelType;
+
+    // Reads the image from a file on another thread and stores it in bytes
+    pendingImage = std::async(std::launch::async, [image]() {
+        // Stores the width, height, and the number of color channels of the image
+        DecodedImage decoded;
+        int numColCh;
+        // Flips the image so it appears right side up (the flag is per thread)
+        stbi_set_flip_vertically_on_load_thread(true);
+        decoded.bytes = stbi_load(image.c_str(), &decoded.width, &decoded.height, &numColCh, 0);
+        return decoded;
+    }).share();
 
     // Generates an OpenGL texture object
     glGenTextures(1, &ID);
@@ -31,22 +39,54 @@ Texture::Texture(std::string image, GLenum texType, GLenum slot, GLenum format,
     // float flatColor[] = {1.0f, 1.0f, 1.0f, 1.0f};
     // glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, flatColor);
 
-    // Assigns the image to the OpenGL Texture object
-    glTexImage2D(texType, 0, GL_RGBA, widthImg, heightImg, 0, format, pixelType, bytes);
-    // Generates MipMaps
-    glGenerateMipmap(texType);
+    // Unbinds the OpenGL Texture object so that it can't accidentally be modified
+    glBindTexture(texType, 0);
+}
 
-    // Deletes the image data as it is already in the OpenGL Texture object
-    stbi_image_free(bytes);
+Texture::Texture(const GLfloat* voxels, GLsizei width, GLsizei height, GLsizei depth, GLenum slot)
+{
+    type = GL_TEXTURE_3D;
+    unit = slot;
+
+    // Generates an OpenGL texture object
+    glGenTextures(1, &ID);
+    // Assigns the texture to a Texture Unit
+    glActiveTexture(slot);
+    glBindTexture(type, ID);
+
+    // Trilinear filtering between voxels, no mipmaps (the ray marcher samples at voxel scale)
+    glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Samples outside the grid repeat the edge instead of wrapping to the other side
+    glTexParameteri(type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(type, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+    // Rows of a 3D texture are not padded to 4 bytes (single floats already are, but be explicit)
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    // Half floats are plenty for densities in [0, 1] and halve the memory of a 256^3 grid
+    glTexImage3D(type, 0, GL_R16F, width, height, depth, 0, GL_RED, GL_FLOAT, voxels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
     // Unbinds the OpenGL Texture object so that it can't accidentally be modified
-    glBindTexture(texType, 0);
+    glBindTexture(type, 0);
+}
+
+void Texture::Update(const GLfloat* voxels, GLsizei width, GLsizei height, GLsizei depth)
+{
+    glActiveTexture(unit);
+    glBindTexture(type, ID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage3D(type, 0, 0, 0, 0, width, height, depth, GL_RED, GL_FLOAT, voxels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(type, 0);
 }
 
 void Texture::texUnit(Shader& shader, const char* uniform, GLuint unit)
 {
-    // Gets the location of the uniform
-    GLuint texUni = glGetUniformLocation(shader.ID, uniform);
+    // Gets the location of the uniform (cached by the shader)
+    GLint texUni = shader.Uniform(uniform);
     // Shader needs to be activated before changing the value of a uniform
     shader.Activate();
     // Sets the value of the uniform
@@ -55,7 +95,26 @@ void Texture::texUnit(Shader& shader, const char* uniform, GLuint unit)
 
 void Texture::Bind()
 {
+    glActiveTexture(unit);
     glBindTexture(type, ID);
+    // The first bind of an image texture uploads it
+    if (pendingImage.valid()) {
+        upload();
+    }
+}
+
+void Texture::upload()
+{
+    DecodedImage decoded = pendingImage.get();
+    pendingImage = std::shared_future<DecodedImage>();
+
+    // Assigns the image to the OpenGL Texture object (the bound one, see Bind)
+    glTexImage2D(type, 0, GL_RGBA, decoded.width, decoded.height, 0, format, pixelType, decoded.bytes);
+    // Generates MipMaps
+    glGenerateMipmap(type);
+
+    // Deletes the image data as it is already in the OpenGL Texture object
+    stbi_image_free(decoded.bytes);
 }
 
 void Texture::Unbind()
@@ -65,5 +124,10 @@ void Texture::Unbind()
 
 void Texture::Delete()
 {
+    // Frees an image that was never uploaded
+    if (pendingImage.valid()) {
+        stbi_image_free(pendingImage.get().bytes);
+        pendingImage = std::shared_future<DecodedImage>();
+    }
     glDeleteTextures(1, &ID);
 }
@@ -7,11 +7,12 @@ VAO::VAO()
 }
 
 // Links a VBO Attribute such as a position or color to the VAO
-void VAO::LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset)
+void VAO::LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset, GLuint divisor, GLboolean normalized)
 {
     VBO.Bind();
-    glVertexAttribPointer(layout, numComponents, type, GL_FALSE, stride, offset);
+    glVertexAttribPointer(layout, numComponents, type, normalized, stride, offset);
     glEnableVertexAttribArray(layout);
+    glVertexAttribDivisor(layout, divisor);
     VBO.Unbind();
 }
 
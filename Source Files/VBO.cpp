@@ -8,6 +8,20 @@ VBO::VBO(GLfloat* vertices, GLsizeiptr size)
     glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
 }
 
+// Overwrites size bytes of the VBO starting at offset, without reallocating it
+void VBO::Update(const GLfloat* vertices, GLsizeiptr size, GLintptr offset)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, ID);
+    glBufferSubData(GL_ARRAY_BUFFER, offset, size, vertices);
+}
+
+// Reallocates the VBO to size bytes and fills it with vertices
+void VBO::Resize(const GLfloat* vertices, GLsizeiptr size, GLenum usage)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, ID);
+    glBufferData(GL_ARRAY_BUFFER, size, vertices, usage);
+}
+
 // Binds the VBO
 void VBO::Bind()
 {
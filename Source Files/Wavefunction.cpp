@@ -0,0 +1,189 @@
+#include"Wavefunction.h"
+
+#include<cmath>
+#include<algorithm>
+#include<cstdlib>
+
+#include"Orbitals.h"
+#include"Parallel.h"
+#include"ScratchArena.h"
+
+// Normalized radial wavefunction R_nl(r) of the hydrogen atom, r in Bohr
+double radialWavefunction(int n, int l, double r)
+{
+    const int k = n - l - 1;        // degree of the Laguerre polynomial
+    const int alpha = 2 * l + 1;
+    const double rho = 2.0 * r / n;
+
+    // L^alpha_k(rho) from L_0 = 1, L_1 = 1 + alpha - rho and
+    // (j+1) L_(j+1) = (2j + 1 + alpha - rho) L_j - (j + alpha) L_(j-1)
+    double laguerre = 1.0;
+    double laguerre_prev = 0.0;
+    for (int j = 0; j < k; j++) {
+        double laguerre_next = ((2 * j + 1 + alpha - rho) * laguerre - (j + alpha) * laguerre_prev) / (j + 1);
+        laguerre_prev = laguerre;
+        laguerre = laguerre_next;
+    }
+
+    return std::exp(logRadialNormalization(n, l) - rho / 2) * std::pow(rho, l) * laguerre;
+}
+
+// Logarithm of the normalization constant of R_nl
+double logRadialNormalization(int n, int l)
+{
+    // sqrt((2/n)^3 (n-l-1)! / (2n (n+l)!)), in logs so that high n does not overflow
+    return 0.5 * (3.0 * std::log(2.0 / n) + std::lgamma(n - l) - std::log(2.0 * n) - std::lgamma(n + l + 1));
+}
+
+// Normalization constant of |Y_l^ml|^2
+double angularNormalization(int l, int ml)
+{
+    const int m = abs(ml);
+    // (2l+1)/(4 pi) (l-m)!/(l+m)!
+    return (2 * l + 1) / (4 * M_PI) * std::exp(std::lgamma(l - m + 1) - std::lgamma(l + m + 1));
+}
+
+// Associated Legendre polynomial P_l^|ml|(cos(theta)), without the (-1)^m Condon-Shortley phase
+double associatedLegendre(int l, int ml, double cosTheta)
+{
+    const int m = abs(ml);
+    const double sinTheta = std::sqrt(std::fmax(0.0, 1.0 - cosTheta * cosTheta));
+
+    // P_m^m = (2m-1)!! sin^m
+    double legendre = 1.0;
+    for (int j = 1; j <= m; j++) {
+        legendre *= (2 * j - 1) * sinTheta;
+    }
+    // P_(m+1)^m = (2m+1) cos P_m^m and
+    // (j-m) P_j^m = (2j-1) cos P_(j-1)^m - (j+m-1) P_(j-2)^m
+    double legendre_prev = 0.0;
+    for (int j = m + 1; j <= l; j++) {
+        double legendre_next = ((2 * j - 1) * cosTheta * legendre - (j + m - 1) * legendre_prev) / (j - m);
+        legendre_prev = legendre;
+        legendre = legendre_next;
+    }
+    return legendre;
+}
+
+// Angular probability density |Y_l^ml(theta, phi)|^2 as a function of cos(theta)
+double angularDensity(int l, int ml, double cosTheta)
+{
+    const double legendre = associatedLegendre(l, ml, cosTheta);
+    return angularNormalization(l, ml) * legendre * legendre;
+}
+
+// Complex wavefunction psi_nlm = R_nl(r) Y_l^ml(theta, phi) at (x, y, z) in Bohr
+std::complex<double> wavefunction(int n, int l, int ml, double x, double y, double z)
+{
+    const double r = std::sqrt(x * x + y * y + z * z);
+    const double cosTheta = (r > 0.0) ? z / r : 1.0;
+    const double amplitude = radialWavefunction(n, l, r) * std::sqrt(angularNormalization(l, ml)) * associatedLegendre(l, ml, cosTheta);
+    // e^(i ml phi), with phi = atan2(y, x)
+    return std::polar(amplitude, ml * std::atan2(y, x));
+}
+
+// Largest probability density of (n, l, ml) within extentBohr of the nucleus
+GLfloat generalPeakDensity(int n, int l, int ml, GLfloat extentBohr)
+{
+    // Both factors are sampled finely enough to resolve the lobes between their nodes
+    const int numSamples = 4096;
+    double maxRadial = 0.0, maxAngular = 0.0;
+    for (int i = 0; i <= numSamples; i++) {
+        double R = radialWavefunction(n, l, extentBohr * i / numSamples);
+        maxRadial = std::fmax(maxRadial, R * R);
+        maxAngular = std::fmax(maxAngular, angularDensity(l, ml, -1.0 + 2.0 * i / numSamples));
+    }
+    return maxRadial * maxAngular;
+}
+
+// Batch density evaluation for any allowed (n, l, ml), with cos(theta) = z/r instead of acos
+void evaluateGeneralDensities(const Orbital& orbital, const GLfloat* x, const GLfloat* y, const GLfloat* z, GLfloat* density, size_t count)
+{
+    const double bohrPerUnit = orbital.extentBohr / GRID_HALF_EXTENT;
+    for (size_t i = 0; i < count; i++) {
+        double X = x[i] * bohrPerUnit, Y = y[i] * bohrPerUnit, Z = z[i] * bohrPerUnit;
+        double r = std::sqrt(X * X + Y * Y + Z * Z);
+        double R = radialWavefunction(orbital.n, orbital.l, r);
+        density[i] = R * R * angularDensity(orbital.l, orbital.ml, (r > 0.0) ? Z / r : 1.0);
+    }
+}
+
+// Grid loop for any allowed (n, l, ml)
+void evaluateGeneralGrid(const Orbital& orbital, int numSpheres_per_side, SphereInstance* sphereInstances)
+{
+    GLfloat step = 2 * GRID_HALF_EXTENT / (numSpheres_per_side - 1);
+    // conversion factor: GRID_HALF_EXTENT units = extentBohr Bohr radii
+    GLfloat bohrPerUnit = orbital.extentBohr / GRID_HALF_EXTENT;
+
+    // Grid points are addressed by their offset from the origin in half steps, a = 2i - (numSpheres_per_side - 1),
+    // so that x = a * step/2 and r^2 = (a^2 + b^2 + c^2) * (step/2)^2 for both odd and even grid sides
+    const int maxOffset = numSpheres_per_side - 1;
+    const GLfloat halfStep = step / 2;
+
+    // The tables are scratch memory of this thread, freed once the grid is written
+    ScratchArena& arena = slabArenas()[0];
+    const ScratchMark mark = arena.Mark();
+
+    //------------------------------ RADIAL CACHE -----------------------------------//
+    // R_nl(r)^2 for every s = a^2 + b^2 + c^2 the grid can hold
+    const size_t numRadii = 3 * maxOffset * maxOffset + 1;
+    GLfloat* radialCache = arena.Allocate<GLfloat>(numRadii);
+    parallelFor(numRadii, [&](size_t s_begin, size_t s_end) {
+        for (size_t s = s_begin; s < s_end; s++) {
+            double R = radialWavefunction(orbital.n, orbital.l, std::sqrt((double)s) * halfStep * bohrPerUnit);
+            radialCache[s] = R * R;
+        }
+    });
+
+    //------------------------------ ANGULAR CACHE ----------------------------------//
+    // |Y_lm|^2 only depends on cos(theta) = c / sqrt(q + c^2) with q = a^2 + b^2, so it is stored once per (q, |c|)
+    // Every distinct q of the grid gets a slot of maxOffset + 1 entries
+    const size_t numQ = 2 * maxOffset * maxOffset + 1;
+    int* qSlot = arena.Allocate<int>(numQ);
+    std::fill(qSlot, qSlot + numQ, -1);
+    // There are at most as many distinct q as columns of the grid
+    int* slotQ = arena.Allocate<int>((size_t)numSpheres_per_side * numSpheres_per_side);
+    size_t numSlots = 0;
+    for (int i = 0; i < numSpheres_per_side; i++) {
+        for (int j = 0; j < numSpheres_per_side; j++) {
+            int a = 2 * i - maxOffset, b = 2 * j - maxOffset;
+            int q = a * a + b * b;
+            if (qSlot[q] < 0) {
+                qSlot[q] = (int)numSlots;
+                slotQ[numSlots++] = q;
+            }
+        }
+    }
+    GLfloat* angularCache = arena.Allocate<GLfloat>(numSlots * (maxOffset + 1));
+    parallelFor(numSlots, [&](size_t slot_begin, size_t slot_end) {
+        for (size_t slot = slot_begin; slot < slot_end; slot++) {
+            for (int c = 0; c <= maxOffset; c++) {
+                int s = slotQ[slot] + c * c;
+                double cosTheta = (s == 0) ? 1.0 : c / std::sqrt((double)s);
+                angularCache[slot * (maxOffset + 1) + c] = angularDensity(orbital.l, orbital.ml, cosTheta);
+            }
+        }
+    });
+
+    //------------------------------ DENSITIES --------------------------------------//
+    // Slabs of constant x are evaluated in parallel, each one writing its own part of sphereInstances
+    parallelFor(numSpheres_per_side, [&](size_t i_begin, size_t i_end) {
+        for (size_t i = i_begin; i < i_end; i++) {
+            for (int j = 0; j < numSpheres_per_side; j++) {
+                int a = 2 * (int)i - maxOffset, b = 2 * j - maxOffset;
+                int q = a * a + b * b;
+                const GLfloat* angularRow = &angularCache[qSlot[q] * (maxOffset + 1)];
+                for (int k = 0; k < numSpheres_per_side; k++) {
+                    int c = 2 * k - maxOffset;
+
+                    SphereInstance& sphere = sphereInstances[(i * numSpheres_per_side + j) * numSpheres_per_side + k];
+                    sphere.x = a * halfStep;
+                    sphere.y = b * halfStep;
+                    sphere.z = c * halfStep;
+                    setSphereDensity(sphere, radialCache[q + c * c] * angularRow[abs(c)] / orbital.peakDensity, step);
+                }
+            }
+        }
+    });
+    arena.Rewind(mark);
+}
@@ -1,5 +1,68 @@
 #include"shaderClass.h"
 
+#include<GLFW/glfw3.h>
+#include<cstdio>
+#include<filesystem>
+
+#include"Assets.h"
+
+// ARB_get_program_binary (core since OpenGL 4.1, so not in the 3.3 loader), loaded the first time a program is built
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+typedef void (APIENTRYP PFNGETPROGRAMBINARY)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNPROGRAMBINARY)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNPROGRAMPARAMETERI)(GLuint program, GLenum pname, GLint value);
+static PFNGETPROGRAMBINARY getProgramBinary = NULL;
+static PFNPROGRAMBINARY programBinary = NULL;
+static PFNPROGRAMPARAMETERI programParameteri = NULL;
+
+// Header of a program cache file, followed by the length bytes of the binary
+struct ProgramCacheHeader
+{
+    char magic[8];                  // "ORBPROG1"
+    uint32_t format;                // Binary format reported by the driver
+    uint32_t length;                // Size of the binary
+};
+
+std::string Shader::programCacheDir = "";
+
+// Whether the context can save and load program binaries (macOS and some drivers report no binary formats)
+static bool programBinariesSupported()
+{
+    static int supported = -1;
+    if (supported < 0) {
+        GLint major = 0, minor = 0, numExtensions = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        bool available = major > 4 || (major == 4 && minor >= 1);
+        glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+        for (GLint i = 0; i < numExtensions && !available; i++) {
+            available = std::strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), "GL_ARB_get_program_binary") == 0;
+        }
+        GLint numFormats = 0;
+        if (available) {
+            getProgramBinary = (PFNGETPROGRAMBINARY)glfwGetProcAddress("glGetProgramBinary");
+            programBinary = (PFNPROGRAMBINARY)glfwGetProcAddress("glProgramBinary");
+            programParameteri = (PFNPROGRAMPARAMETERI)glfwGetProcAddress("glProgramParameteri");
+            if (getProgramBinary != NULL && programBinary != NULL && programParameteri != NULL) {
+                glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+            }
+        }
+        supported = (numFormats > 0) ? 1 : 0;
+    }
+    return supported == 1;
+}
+
+// 64-bit FNV-1a hash of data, continued from hash
+static uint64_t fnv1a(const std::string& data, uint64_t hash = 14695981039346656037ULL)
+{
+    for (unsigned char c : data) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return hash;
+}
+
 // Reads a text file and outputs a string with everything in the text file
 std::string get_file_contents(const char* filename)
 {
@@ -21,11 +84,19 @@ std::string get_file_contents(const char* filename)
 // Constructor that build the Shader Program from 2 different shaders
 Shader::Shader(std::string vertexFile, std::string fragmentFile)
 {
-    // Read vertexFile and fragmentFile and store the strings
-    const char* char_vertexFile = vertexFile.c_str();
-    std::string vertexCode = get_file_contents(char_vertexFile);
-    const char* char_fragmentFile = fragmentFile.c_str();
-    std::string fragmentCode = get_file_contents(char_fragmentFile);
+    // Read vertexFile and fragmentFile (or their embedded copies) and store the strings
+    std::string vertexCode = shaderSource(vertexFile);
+    std::string fragmentCode = shaderSource(fragmentFile);
+
+    // Create Shader Program Object and get its reference
+    ID = glCreateProgram();
+    // Skips compiling if the same sources were linked by this driver before
+    const std::string cachePath = programCachePath(vertexCode, fragmentCode);
+    if (!cachePath.empty() && loadBinary(cachePath)) {
+        fromCache = true;
+        cacheUniforms();
+        return;
+    }
 
     // Convert the shader source strings into character arrays
     const char* vertexSource = vertexCode.c_str();
@@ -49,15 +120,23 @@ Shader::Shader(std::string vertexFile, std::string fragmentFile)
     // Checks if Shader compiled succesfully
     compileErrors(fragmentShader, "FRAGMENT");
 
-    // Create Shader Program Object and get its reference
-    ID = glCreateProgram();
     // Attach the Vertex and Fragment Shaders to the Shader Program
     glAttachShader(ID, vertexShader);
     glAttachShader(ID, fragmentShader);
+    // Asks the driver to keep the binary around for storeBinary
+    if (!cachePath.empty()) {
+        programParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     // Wrap-up/Link all the shaders together into the Shader Program
     glLinkProgram(ID);
     // Checks if Shaders linked succesfully
     compileErrors(ID, "PROGRAM");
+    // Saves the linked program for the next run
+    if (!cachePath.empty()) {
+        storeBinary(cachePath);
+    }
+    // Looks up every uniform the program uses once
+    cacheUniforms();
 
     // Delete the now useless Vertex and Fragment Shader objects
     glDeleteShader(vertexShader);
@@ -65,6 +144,108 @@ Shader::Shader(std::string vertexFile, std::string fragmentFile)
 
 }
 
+// Empty Shader Program (ID 0), for a program the render settings never draw with
+Shader::Shader() : ID(0)
+{
+}
+
+// Location of a uniform, looked up when the program was linked
+GLint Shader::Uniform(const std::string& name) const
+{
+    std::unordered_map<std::string, GLint>::const_iterator location = uniformLocations.find(name);
+    return (location != uniformLocations.end()) ? location->second : -1;
+}
+
+// Fills uniformLocations from the linked program
+void Shader::cacheUniforms()
+{
+    GLint numUniforms = 0, maxNameLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &numUniforms);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+    std::vector<GLchar> nameBuffer(maxNameLength + 1);
+    for (GLint i = 0; i < numUniforms; i++) {
+        GLsizei nameLength = 0;
+        GLint size;
+        GLenum type;
+        glGetActiveUniform(ID, i, (GLsizei)nameBuffer.size(), &nameLength, &size, &type, nameBuffer.data());
+        const std::string name(nameBuffer.data(), nameLength);
+        const GLint location = glGetUniformLocation(ID, name.c_str());
+        uniformLocations[name] = location;
+        // Arrays are listed as name[0], and set by name
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            uniformLocations[name.substr(0, name.size() - 3)] = location;
+        }
+    }
+}
+
+// Cache file of the program of vertexCode and fragmentCode for this driver, empty if programs are not cached
+std::string Shader::programCachePath(const std::string& vertexCode, const std::string& fragmentCode)
+{
+    if (programCacheDir.empty() || !programBinariesSupported()) {
+        return "";
+    }
+    // Binaries only load on the same driver, so it is part of the key along with the sources
+    uint64_t hash = fnv1a(vertexCode);
+    hash = fnv1a(std::string(1, '\0') + fragmentCode, hash);
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        hash = fnv1a(std::string(1, '\0') + (const char*)glGetString(name), hash);
+    }
+    char fileName[32];
+    std::snprintf(fileName, sizeof(fileName), "%016llx.bin", (unsigned long long)hash);
+    return programCacheDir + "/" + fileName;
+}
+
+// Links the program from its cache file, returns false if there is none or the driver rejects it
+bool Shader::loadBinary(const std::string& cachePath)
+{
+    std::ifstream in(cachePath, std::ios::binary);
+    ProgramCacheHeader header;
+    if (!in.read((char*)&header, sizeof(header)) || std::memcmp(header.magic, "ORBPROG1", 8) != 0) {
+        return false;
+    }
+    std::vector<char> binary(header.length);
+    if (!in.read(binary.data(), binary.size())) {
+        return false;
+    }
+    programBinary(ID, header.format, binary.data(), (GLsizei)binary.size());
+    // A driver update makes old binaries fail to link, then the program is compiled (and stored) again
+    GLint linked = GL_FALSE;
+    glGetProgramiv(ID, GL_LINK_STATUS, &linked);
+    return linked == GL_TRUE;
+}
+
+// Writes the linked program to its cache file
+void Shader::storeBinary(const std::string& cachePath)
+{
+    GLint linked = GL_FALSE, length = 0;
+    glGetProgramiv(ID, GL_LINK_STATUS, &linked);
+    glGetProgramiv(ID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (linked != GL_TRUE || length <= 0) {
+        return;
+    }
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    getProgramBinary(ID, length, &length, &format, binary.data());
+
+    ProgramCacheHeader header;
+    std::memcpy(header.magic, "ORBPROG1", 8);
+    header.format = format;
+    header.length = (uint32_t)length;
+    // Written next to the final file and renamed, so other runs never read half a binary
+    std::error_code error;
+    std::filesystem::create_directories(programCacheDir, error);
+    const std::string tmpPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        out.write((const char*)&header, sizeof(header));
+        out.write(binary.data(), length);
+        if (!out) {
+            return;
+        }
+    }
+    std::filesystem::rename(tmpPath, cachePath, error);
+}
+
 // Activates the Shader Program
 void Shader::Activate()
 {
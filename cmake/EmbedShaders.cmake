@@ -0,0 +1,17 @@
+# Writes OUTPUT with one { "name", R"glsl(source)glsl" } entry per shader of SHADER_DIR, included by Assets.cpp
+#     cmake -DSHADER_DIR=Shaders -DOUTPUT=EmbeddedShaders.inc -P EmbedShaders.cmake
+file(GLOB shaders "${SHADER_DIR}/*.vert" "${SHADER_DIR}/*.frag")
+list(SORT shaders)
+set(content "// Generated from the Shaders folder by cmake/EmbedShaders.cmake, do not edit\n")
+foreach(shader ${shaders})
+    get_filename_component(name "${shader}" NAME)
+    file(READ "${shader}" source)
+    string(APPEND content "{ \"${name}\", R\"glsl(${source})glsl\" },\n")
+endforeach()
+# Only rewritten when a shader changed, so Assets.cpp is not rebuilt for nothing
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" previous)
+endif()
+if(NOT "${content}" STREQUAL "${previous}")
+    file(WRITE "${OUTPUT}" "${content}")
+endif()
@@ -29,6 +29,10 @@ CONTROLS:
  D : move right upon the plane of the screen
  CNTRL : down (-y)
  SPACE : up (+y)
+ UP / DOWN : increase / decrease n
+ RIGHT / LEFT : increase / decrease l
+ ] / [ : increase / decrease ml
+ . / , : raise / lower the isosurface levels (with showIsosurfaces)
 
 
 ----------------------------------- ACKNOWLEDGEMENTS -----------------------------------------------
@@ -48,6 +52,9 @@ https://github.com/VictorGordan/opengl-tutorials
 namespace fs = std::filesystem;
 
 #include <iostream>
+#include <string>
+#include <cstddef>
+#include <iterator>
 #include "glad.h"
 #include <GLFW/glfw3.h>
 #include "stb_image.h"
@@ -61,18 +68,43 @@ namespace fs = std::filesystem;
 #include "VBO.h"
 #include "EBO.h"
 #include "Camera.h"
+#include "Sphere.h"
+#include "Orbitals.h"
+#include "Parallel.h"
+#include "GpuDensity.h"
+#include "OrbitalSelector.h"
+#include "OrbitalCache.h"
+#include "AdaptiveGrid.h"
+#include "SphereLOD.h"
+#include "SphereChunks.h"
+#include "Profiler.h"
+#include "Superposition.h"
+#include "OITBuffer.h"
+#include "OrbitalComparison.h"
+#include "GridExport.h"
+#include "GridWorker.h"
+#include "Isosurface.h"
+#include "ElectronCloud.h"
+#include "RenderQueue.h"
+#include "Assets.h"
 
 const unsigned int WIDTH = 1700;
 const unsigned int HEIGHT = 1000;
-const float PI = M_PI;
-
-// How many sectors and stacks each sphere has graphically
-const int sectorCount = 9;
-const int stackCount = 9;
-const int NUM_VERTICES_PER_SPHERE = 100;
-const int NUM_TRIANGLES_PER_SPHERE = 144;
-
-const int numSpheres = pow(11,3);
+// Vertical field of view of the camera in degrees
+const float FOV = 45.0f;
+
+// How the sphere array is drawn
+// INSTANCED: a single unit sphere is uploaded once and drawn once per grid point with a per-sphere center, radius and color
+// BAKED_MESH: the vertices of every sphere are generated on the CPU and uploaded as one large mesh
+// GPU_DENSITY: like INSTANCED, but gpuDensity.vert evaluates the wavefunction of each grid point itself,
+//              so nothing but the unit sphere is uploaded and the quantum numbers are only uniforms
+// IMPOSTOR: each sphere is a camera facing quad (2 triangles) and impostor.frag ray casts the exact sphere inside it
+// VOLUME: no spheres, the densities of the grid are uploaded as a 3D texture and volume.frag ray marches through it
+// SUPERPOSITION: like INSTANCED, but the spheres show the time evolution of superposedStates; psi_s of every state is
+//                cached per grid point once and superposition.vert only recombines it with new phases every frame
+// ELECTRON_CLOUD: no grid, electron positions drawn at random from |psi|^2 are added as points every frame until
+//                 MAX_ELECTRONS of them are on the GPU, blended additively so the cloud is brightest where psi is largest
+enum RenderMode { BAKED_MESH, INSTANCED, GPU_DENSITY, IMPOSTOR, VOLUME, SUPERPOSITION, ELECTRON_CLOUD };
 
 //-------------------------------------- DEFAULT QUANTUM NUMBERS ----------------------------------------//
 int n = 1; // Principal quantum number
@@ -80,22 +112,43 @@ int l = 0; // Angular momentum quantum number
 int ml = 0; // Magnetic quantum number
 //------------------------------------ END DEFAULT QUANTUM NUMBERS --------------------------------------//
 //-------------------------------------------------------------------------------------------------------//
-//----------------------------------------- FUNCTION HEADERS --------------------------------------------//
-GLfloat r_of (GLfloat x, GLfloat y, GLfloat z);
-GLfloat theta_of (GLfloat x, GLfloat y, GLfloat z);
-GLfloat phi_of (GLfloat x, GLfloat y, GLfloat z);
-
-GLfloat _100_eq(GLfloat r, GLfloat theta, GLfloat phi);
-GLfloat _200_eq(GLfloat r, GLfloat theta, GLfloat phi);
-GLfloat _210_eq(GLfloat r, GLfloat theta, GLfloat phi);
-GLfloat _211_eq(GLfloat r, GLfloat theta, GLfloat phi);
-GLfloat _300_eq(GLfloat r, GLfloat theta, GLfloat phi);
-GLfloat _310_eq(GLfloat r, GLfloat theta, GLfloat phi);
-GLfloat _311_eq(GLfloat r, GLfloat theta, GLfloat phi);
-GLfloat _320_eq(GLfloat r, GLfloat theta, GLfloat phi);
-GLfloat _321_eq(GLfloat r, GLfloat theta, GLfloat phi);
-GLfloat _322_eq(GLfloat r, GLfloat theta, GLfloat phi);
-//-------------------------------------- END FUNCTION HEADERS --------------------------------------------------//
+//-------------------------------------- DEFAULT SUPERPOSITION ------------------------------------------//
+// States (n, l, ml) and coefficients at t = 0 of SUPERPOSITION mode (normalized, at most MAX_SUPERPOSED_STATES)
+// (|100> + |210>)/sqrt(2) sloshes along z; states with the same n have the same energy and do not beat
+std::vector<SuperposedState> superposedStates = { { 1, 0, 0, { 1.0, 0.0 } }, { 2, 1, 0, { 1.0, 0.0 } } };
+double atomicTimeUnitsPerSecond = 4.0; // Speed of the animation (1 atomic time unit = 2.42e-17 s)
+//------------------------------------ END DEFAULT SUPERPOSITION ----------------------------------------//
+//-------------------------------------------------------------------------------------------------------//
+//------------------------------------- DEFAULT RENDER SETTINGS -----------------------------------------//
+RenderMode renderMode = INSTANCED;
+bool useOrbitalCache = true; // Reuse the sphere grids evaluated by earlier runs (stored in the Cache folder)
+bool useProgramCache = true; // Reuse the shader programs linked by earlier runs (stored in Cache/Programs, where the driver supports it)
+bool asyncGeneration = true; // Evaluate grids on a worker thread and show a coarse grid until they are done (INSTANCED and IMPOSTOR modes, not with adaptiveSampling or compareShell)
+bool adaptiveSampling = false; // Octree sampling that skips near-zero densities and refines lobes and nodes (not in GPU_DENSITY, VOLUME, SUPERPOSITION or ELECTRON_CLOUD mode)
+bool compactVertices = true; // 12 byte quantized sphere vertices instead of 11 floats (BAKED_MESH mode only)
+bool useSphereLODs = true; // Coarser sphere meshes for spheres that are small on screen (INSTANCED mode only)
+bool translucentSpheres = false; // Denser spheres are more opaque, drawn with weighted blended OIT (not in IMPOSTOR, VOLUME or ELECTRON_CLOUD mode)
+GLfloat sphereOpacity = 0.8f; // Alpha of the spheres at the peak density with translucentSpheres
+bool compareShell = false; // Every orbital of shell n side by side, all in one instance buffer (not in GPU_DENSITY, VOLUME, SUPERPOSITION or ELECTRON_CLOUD mode)
+bool showIsosurfaces = false; // Surfaces of constant density over the spheres, extracted from the same grid (not in GPU_DENSITY, SUPERPOSITION or ELECTRON_CLOUD mode, not with adaptiveSampling or compareShell)
+std::vector<GLfloat> isoLevels = { 0.25f }; // Densities of the isosurfaces relative to the peak density, changed with . and ,
+GLfloat isosurfaceOpacity = 0.35f; // Alpha of the isosurfaces
+GLfloat electronBrightness = 0.05f; // Brightness every electron position adds to its pixel in ELECTRON_CLOUD mode
+GLfloat electronPointSize = 1.0f; // Size of the electron positions in pixels in ELECTRON_CLOUD mode
+bool frustumCulling = true; // Skip the spheres outside the view of the camera (INSTANCED and IMPOSTOR modes)
+bool showStats = true; // Frame times, instances and triangles in the window title
+std::string statsLogPath = ""; // Log of the stats of every frame (CSV, or JSON if it ends in .json), empty for none
+//----------------------------------- END DEFAULT RENDER SETTINGS ---------------------------------------//
+//-------------------------------------------------------------------------------------------------------//
+//------------------------------------ DEFAULT GRID RESOLUTION ------------------------------------------//
+int numSpheres_per_side = 11; // The grid holds numSpheres_per_side^3 spheres
+// Largest numSpheres_per_side accepted at the prompt: 256^3 spheres are 16.7M instances (470 MB of SphereInstance)
+const int MAX_SPHERES_PER_SIDE = 256;
+// Largest numSpheres_per_side in BAKED_MESH mode, where every sphere is 100 vertices and 432 indices (64^3 spheres
+// are 1.2 GB of float vertices and 113M indices, well inside the GLsizei count of the draw call)
+const int MAX_BAKED_SPHERES_PER_SIDE = 64;
+//---------------------------------- END DEFAULT GRID RESOLUTION ----------------------------------------//
+//-------------------------------------------------------------------------------------------------------//
 
 //----------------------------- AXIS ARRAYS ---------------------------------------------------------------//
 // AXIS VERTICES
@@ -316,27 +369,136 @@ GLuint lightIndices[] =
     4, 5, 6,   // Back face
     4, 6, 7
 };
+// IMPOSTOR QUAD
+GLfloat impostorQuadVertices[] =
+{ // CORNERS //
+    -1.0f, -1.0f,
+     1.0f, -1.0f,
+     1.0f,  1.0f,
+    -1.0f,  1.0f
+};
+
+GLuint impostorQuadIndices[] =
+{
+    0, 1, 2,
+    2, 3, 0
+};
+// VOLUME BOX
+GLfloat volumeBoxVertices[] =
+{ //                  COORDINATES                        //
+    -GRID_HALF_EXTENT, -GRID_HALF_EXTENT, -GRID_HALF_EXTENT,
+     GRID_HALF_EXTENT, -GRID_HALF_EXTENT, -GRID_HALF_EXTENT,
+    -GRID_HALF_EXTENT,  GRID_HALF_EXTENT, -GRID_HALF_EXTENT,
+     GRID_HALF_EXTENT,  GRID_HALF_EXTENT, -GRID_HALF_EXTENT,
+    -GRID_HALF_EXTENT, -GRID_HALF_EXTENT,  GRID_HALF_EXTENT,
+     GRID_HALF_EXTENT, -GRID_HALF_EXTENT,  GRID_HALF_EXTENT,
+    -GRID_HALF_EXTENT,  GRID_HALF_EXTENT,  GRID_HALF_EXTENT,
+     GRID_HALF_EXTENT,  GRID_HALF_EXTENT,  GRID_HALF_EXTENT
+};
+
+GLuint volumeBoxIndices[] =
+{   // CCW seen from outside the box
+    4, 6, 2,   // -x face
+    2, 0, 4,
+    1, 3, 7,   // +x face
+    7, 5, 1,
+    1, 5, 4,   // -y face
+    4, 0, 1,
+    2, 6, 7,   // +y face
+    7, 3, 2,
+    2, 3, 1,   // -z face
+    1, 0, 2,
+    4, 5, 7,   // +z face
+    7, 6, 4
+};
 //------------------------- END AXIS ARRAYS ----------------------------------------------------------------//
 //----------------------------------------------------------------------------------------------------------//
 //--------------------------- MAIN METHOD ------------------------------------------------------------------//
-int main()
+int main(int argc, char** argv)
 {
-    //Relative path
-    std::string parentDir = (fs::current_path().fs::path::parent_path()).string();
+    // Before anything runs the kernels, so that an AVX2 build says why instead of crashing on an older CPU
+    if (!cpuSupportsLanes()) {
+        std::cout << "This build needs a CPU with AVX2 and FMA. Rebuild with -DORBITAL_AVX2=OFF.\n";
+        return 1;
+    }
+    // With arguments the simulator exports an orbital to disk instead of opening a window (see GridExport.h)
+    if (argc > 1) {
+        return runExportCommand(argc, argv);
+    }
+
+    //Relative path (to the executable, so the simulator can be started from any folder)
+    std::string parentDir = dataDir();
 
     //--------------------------- END USER INPUT ---------------------------------------------------------//
-    std::cout << "Hydrogen Atom Orbital Simulator.\n";// (Currently only n=1,2,3, l=0,1,2, ml=+/-0,1,2 are supported)\n";
+    // Reads one line of input into value, false unless the whole line is one integer that fits in an int
+    auto readInt = [](int& value) {
+        std::string line;
+        return std::getline(std::cin, line) && parseInt(line, value);
+    };
+    std::cout << "Hydrogen Atom Orbital Simulator.\n";
     std::cout << "Enter desired principal quantum number........ n = ";
-    std::cin >> n;
+    bool validInput = readInt(n);
     std::cout << "Enter desired angular momentum quantum number. l = ";
-    std::cin >> l;
+    validInput = readInt(l) && validInput;
     std::cout << "Enter desired magnetic quantum number........ ml = ";
-    std::cin >> ml;
+    validInput = readInt(ml) && validInput;
+    std::cout << "Enter desired number of spheres per grid side. N = ";
+    validInput = readInt(numSpheres_per_side) && validInput;
     std::cout << "\n";
-    
+
+    if (!validInput) {
+        std::cout << "Every input must be a whole number.\n";
+        return 0;
+    }
     // Check if quanutm numbers are allowed
-    if (l+1>n || abs(ml)>abs(l) || l<0) {
-        std::cout << "This combination of quantum numbers is not allowed.\n";
+    if (!checkQuantumNumbers(n, l, ml)) {
+        return 0;
+    }
+    // The grid needs at least 2 spheres per side to span the axes
+    if (numSpheres_per_side < 2) {
+        std::cout << "The grid needs at least 2 spheres per side.\n";
+        return 0;
+    }
+    // Larger grids overflow the sphere counts and buffer sizes long before they fit in memory
+    const int maxSpheres_per_side = (renderMode == BAKED_MESH) ? MAX_BAKED_SPHERES_PER_SIDE : MAX_SPHERES_PER_SIDE;
+    if (numSpheres_per_side > maxSpheres_per_side) {
+        std::cout << "The grid can have at most " << maxSpheres_per_side << " spheres per side, using N = " << maxSpheres_per_side << ".\n";
+        numSpheres_per_side = maxSpheres_per_side;
+    }
+    // With adaptiveSampling this becomes the number of octree spheres once the orbital is sampled
+    size_t numSpheres = (size_t)numSpheres_per_side * numSpheres_per_side * numSpheres_per_side;
+    if (renderMode == GPU_DENSITY || renderMode == VOLUME || renderMode == SUPERPOSITION || renderMode == ELECTRON_CLOUD) {
+        adaptiveSampling = false;
+    }
+    if (renderMode != INSTANCED) {
+        useSphereLODs = false;
+    }
+    if (renderMode != BAKED_MESH) {
+        compactVertices = false;
+    }
+    if (renderMode == IMPOSTOR || renderMode == VOLUME || renderMode == ELECTRON_CLOUD) {
+        translucentSpheres = false;
+    }
+    if (renderMode == GPU_DENSITY || renderMode == VOLUME || renderMode == SUPERPOSITION || renderMode == ELECTRON_CLOUD) {
+        compareShell = false;
+    }
+    if ((renderMode != INSTANCED && renderMode != IMPOSTOR) || adaptiveSampling || compareShell) {
+        asyncGeneration = false;
+    }
+    if (renderMode == GPU_DENSITY || renderMode == SUPERPOSITION || renderMode == ELECTRON_CLOUD || adaptiveSampling || compareShell) {
+        showIsosurfaces = false;
+    }
+
+    Orbital orbital = findOrbital(n, l, ml);
+    // The orbitals shown side by side with compareShell (l and ml are not used then)
+    std::vector<Orbital> comparedOrbitals;
+    if (compareShell) {
+        comparedOrbitals = shellOrbitals(n);
+    }
+    // The states of SUPERPOSITION mode, checked and normalized
+    Superposition superposition;
+    if (renderMode == SUPERPOSITION && !buildSuperposition(superposedStates, superposition)) {
+        std::cout << "The superposition has no allowed states.\n";
         return 0;
     }
     //--------------------------- END USER INPUT ---------------------------------------------------------//
@@ -354,8 +516,17 @@ int main()
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
     // Create a window
-    //std::char title = "Hydrogen Atom Sim - n = " + std::to_string(n) + ", l = " + std::to_string(l) + ", ml = " + std::to_string(ml);
-    GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Hydrogen Atom Orbital Simulation", NULL, NULL);
+    std::string title = "Hydrogen Atom Sim - n = " + std::to_string(n) + ", l = " + std::to_string(l) + ", ml = " + std::to_string(ml);
+    if (compareShell) {
+        title = "Hydrogen Atom Sim - every orbital of n = " + std::to_string(n) + " (rows l, columns |ml|)";
+    }
+    if (renderMode == SUPERPOSITION) {
+        title = "Hydrogen Atom Sim - superposition of";
+        for (const SuperposedState& state : superposition.states) {
+            title += " |" + std::to_string(state.n) + std::to_string(state.l) + std::to_string(state.ml) + ">";
+        }
+    }
+    GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, title.c_str(), NULL, NULL);
     // Error check if the window fails to create
     if (window == NULL)
     {
@@ -370,1275 +541,147 @@ int main()
     gladLoadGL();
     // Specify the viewport of OpenGL in the Window
     glViewport(0, 0, WIDTH, HEIGHT);
+    // Linked shader programs are saved and loaded instead of compiled at every start
+    Shader::programCacheDir = useProgramCache ? parentDir + "/Cache/Programs" : "";
+    // Decodes the brick texture (see MULTIPLE SPHERES) while the grid is evaluated
+    Texture brickTex(parentDir + "/Debug/brick.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
     //------------------------ END WINDOW SETUP ---------------------------------------------------------//
     //---------------------------------------------------------------------------------------------------//
     //-----------------------  MULTIPLE SPHERES ---------------------------------------------------------//
     //----------------------------------------------------------------------------------------------//
     //-------------------- GENERATE TOTAL VERTICES VECTOR ------------------------------------------//
 
-    // allSpheres_VertexVec will be formatted such that each vector stored in it will be a formatted vertex/attributes vector
-    std::vector<std::vector<GLfloat>> allSpheres_VertexVec;
-    
-    // 125 spheres -> 5x5x5 cube // LATER I will make the number of spheres variable based on the largest r of the wavefunction that produces a probability density above some constant
-    int numSpheres_per_side = cbrt(numSpheres);
-    GLfloat step = 10.00 / (numSpheres_per_side - 1); // 5.00 units = 1 Bohr radius
-    
-    // Add sphere vectors to allSpheres_VertexVec
-    // each sphere represents the probabiility density at that location
-    // sphereRadius and sphereColor of each sphere based on the probability density of the wavefunction at that point
-
-    // 1s1 Orbital:
-    if (n == 1 && l == 0 && ml == 0) {
-        std::cout << "Scale factor: axes extend to 1 Bohr (0.5 A).\n";
-        // Nested for loops traverse a cube centered on the origin in 3D space
-        for (int i = 0; i < numSpheres_per_side; i++) {
-            for (int j = 0; j < numSpheres_per_side; j++) {
-                for (int k = 0; k < numSpheres_per_side; k++) {
-                    // At each point on the cube of traversed values, we create an array of vertices for the probability density sphere at that point
-                    // NOTE: r IS THE DISTANCE OF THE SPHERE FROM THE ORIGIN, sphereRadius IS THE SPHERE RADIUS
-                    GLfloat x = -5.00f + (i * step); // x,y,x is the center of the probability sphere
-                    GLfloat y = -5.00f + (j * step);
-                    GLfloat z = -5.00f + (k * step);
-
-                    GLfloat r = r_of(x,y,z);
-                    GLfloat theta = theta_of(x,y,z);
-                    GLfloat phi = phi_of(x,y,z);
-                    
-                    // conversion factor: 5.0 = 1 Bohr radius
-                    GLfloat probDensity = _100_eq(r/5.0f,theta,phi);
-                    //std::cout << "Prob Density is: " << probDensity << std::endl;
-
-                    // Conversion factor: step/2 => sphereRadius is maximum (subject to change)
-                    // 0.31f is the maximum of the 1s1 prob density
-                    GLfloat sphereRadius = step/1.5f * probDensity/0.31f;
-                    GLfloat sphereColor_red = 1.0f * (1-probDensity/0.31f); // More red = lower prob density
-                    GLfloat sphereColor_green = 1.0f * probDensity/0.31f;   // More green = higher prob density
-                    GLfloat sphereColor_blue = 0.2f;                        // Blue is constant for now
-                    
-                    //------------------------------ GENERATE SPHERE -----------------------------------//
-                    //-------------------------------------------------------------------//
-                    //------------ GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    std::vector<GLfloat> sphereVertices;
-                    std::vector<GLfloat> sphereNormals;
-                    std::vector<GLfloat> sphereTexCoords;
-
-                    std::vector<GLfloat>().swap(sphereVertices);
-                    std::vector<GLfloat>().swap(sphereNormals);
-                    std::vector<GLfloat>().swap(sphereTexCoords);
-                    GLfloat x_local,y_local,z_local,xy_local;               // vertex position
-                    GLfloat nx, ny, nz, lengthInv = 1.0f / sphereRadius;    // vertex normal
-                    GLfloat s, t;                                           // vertex texCoord
-
-                    GLfloat sectorStep = 2 * PI / sectorCount;
-                    GLfloat stackStep = PI / stackCount;
-                    GLfloat sectorAngle, stackAngle;
-                    
-                    for(int i_local = 0; i_local <= stackCount; ++i_local)
-                    {
-                        stackAngle = PI / 2 - i_local * stackStep;        // starting from pi/2 to -pi/2
-                        xy_local = sphereRadius * cosf(stackAngle);             // r * cos(u)
-                        z_local = sphereRadius * sinf(stackAngle);              // r * sin(u)
-                        // add (sectorCount+1) vertices per stack
-                        // first and last vertices have same position and normal, but different tex coords
-                        for(int j_local = 0; j_local <= sectorCount; ++j_local)
-                        {
-                            sectorAngle = j_local * sectorStep;           // starting from 0 to 2pi
-
-                            // vertex position with respect to (x, y, z) is (x_local, y_local, z_local)
-                            x_local = xy_local * cosf(sectorAngle);             // r * cos(u) * cos(v)
-                            y_local = xy_local * sinf(sectorAngle);             // r * cos(u) * sin(v)
-
-                            sphereVertices.push_back(x_local + x);
-                            sphereVertices.push_back(y_local + y);              // + x,y,z
-                            sphereVertices.push_back(z_local + z);
-
-                            // normalized vertex normal (nx, ny, nz)
-                            nx = x_local * lengthInv;
-                            ny = y_local * lengthInv;
-                            nz = z_local * lengthInv;
-                            sphereNormals.push_back(nx);
-                            sphereNormals.push_back(ny);
-                            sphereNormals.push_back(nz);
-
-                            // vertex tex coord (s, t) range between [0, 1]
-                            s = (GLfloat)i_local / sectorCount;
-                            t = (GLfloat)i_local / stackCount;
-                            sphereTexCoords.push_back(s);
-                            sphereTexCoords.push_back(t);
-                        }
-                    }
-                    //---------- END GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    //---------------------------------------------------------------------//
-                    //-------------- GENERATE COMPLETE VERTEX VECTOR ----------------------//
-                    std::vector<GLfloat> completeSphereVertexVec;
-                    int length_completeSphereVertexVec = (int) ((sphereVertices.size() * 11.0)/3);
-                    
-                    int j_a = 0;
-                    for (int i_a = 0; i_a < length_completeSphereVertexVec;) {
-                        // COORDINATES:
-                        for (int k_a = j_a; k_a < j_a+3; k_a++) {
-                            completeSphereVertexVec.push_back(sphereVertices.at(k_a)); i_a++;
-                        }
-                        j_a += 3;
-                        // COLORS:
-                        completeSphereVertexVec.push_back(sphereColor_red); i_a++;// RED
-                        completeSphereVertexVec.push_back(sphereColor_green); i_a++; // GREEN
-                        completeSphereVertexVec.push_back(sphereColor_blue); i_a++; // BLUE
-                        // TEXCOORD:
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        // NORMALS:
-                        for (int k_a = j_a-3; k_a < j_a; k_a++) {
-                            completeSphereVertexVec.push_back(sphereNormals.at(k_a)); i_a++;
-                        }
-                    }
-                    //------------- END GENERATE COMPLETE VERTEX VECTOR ------------------//
-                    //--------------------------------------------------------------------//
-                    //------- ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec ---------//
-                    allSpheres_VertexVec.push_back(completeSphereVertexVec);
-                
-                    //----- END ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec -------//
-                    //--------------------------------------------------------------------//
-                    //-----------------------------END GENERATE SPHERE ------------------------------//
+    // Times the startup steps, the GPU work of every frame and counts what is drawn
+    Profiler profiler;
+    if (!statsLogPath.empty()) {
+        profiler.OpenLog(statsLogPath);
+    }
+    // Every section the render settings draw, so that the log has all their columns from the first frame
+    profiler.AddGpuSection("axes and light");
+    profiler.AddGpuSection("spheres");
+    if (showIsosurfaces) {
+        profiler.AddGpuSection("isosurfaces");
+    }
 
-                }
-            }
+    // sphereInstances holds the center, radius and color of every sphere, in grid order
+    std::vector<SphereInstance> sphereInstances;
+    // Grids evaluated before are memory mapped from the cache instead of evaluated again
+    OrbitalCache orbitalCache(parentDir + "/Cache");
+    // Returns the spheres of the current orbital: mapped from the cache (valid until orbitalCache.Unmap)
+    // or evaluated into sphereInstances and added to the cache
+    // The levels of detail are chosen on the CPU every time the camera moves, so then they are always kept in sphereInstances
+    auto loadSpheres = [&]() -> const SphereInstance* {
+        // Every orbital of the shell, one after the other
+        if (compareShell) {
+            evaluateComparison(comparedOrbitals, n, numSpheres_per_side, adaptiveSampling, useOrbitalCache ? &orbitalCache : NULL, sphereInstances);
+            numSpheres = sphereInstances.size();
+            return sphereInstances.data();
         }
-        
-    } else if (n == 2 && l == 0 && ml == 0) {
-        std::cout << "Scale factor: axes extend to 2 Bohr (1.0 A).\n";
-        // Nested for loops traverse a cube centered on the origin in 3D space
-        for (int i = 0; i < numSpheres_per_side; i++) {
-            for (int j = 0; j < numSpheres_per_side; j++) {
-                for (int k = 0; k < numSpheres_per_side; k++) {
-                    // At each point on the cube of traversed values, we create an array of vertices for the probability density sphere at that point
-                    // NOTE: r IS THE DISTANCE OF THE SPHERE FROM THE ORIGIN, sphereRadius IS THE SPHERE RADIUS
-                    GLfloat x = -5.00f + (i * step); // x,y,x is the center of the probability sphere
-                    GLfloat y = -5.00f + (j * step);
-                    GLfloat z = -5.00f + (k * step);
-                    
-                    GLfloat r = r_of(x,y,z);
-                    GLfloat theta = theta_of(x,y,z);
-                    GLfloat phi = phi_of(x,y,z);
-                    
-                    // conversion factor: 2.5 = 1 Bohr radius
-                    GLfloat probDensity = _200_eq(r/2.5f,theta,phi);
-                    //std::cout << "Prob Density is: " << probDensity << std::endl;
-                    
-                    // Conversion factor: step/2 => sphereRadius is maximum (subject to change)
-                    // maximum of the 2s prob density
-                    GLfloat sphereRadius = step/1.5f * probDensity;
-                    GLfloat sphereColor_red = 1.0f * (1-probDensity); // More red = lower prob density
-                    GLfloat sphereColor_green = 1.0f * probDensity;   // More green = higher prob density
-                    GLfloat sphereColor_blue = 0.2f;                        // Blue is constant for now
-                    
-                    //------------------------------ GENERATE SPHERE -----------------------------------//
-                    //-------------------------------------------------------------------//
-                    //------------ GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    std::vector<GLfloat> sphereVertices;
-                    std::vector<GLfloat> sphereNormals;
-                    std::vector<GLfloat> sphereTexCoords;
-                    
-                    std::vector<GLfloat>().swap(sphereVertices);
-                    std::vector<GLfloat>().swap(sphereNormals);
-                    std::vector<GLfloat>().swap(sphereTexCoords);
-                    GLfloat x_local,y_local,z_local,xy_local;               // vertex position
-                    GLfloat nx, ny, nz, lengthInv = 1.0f / sphereRadius;    // vertex normal
-                    GLfloat s, t;                                           // vertex texCoord
-                    
-                    GLfloat sectorStep = 2 * PI / sectorCount;
-                    GLfloat stackStep = PI / stackCount;
-                    GLfloat sectorAngle, stackAngle;
-                    
-                    for(int i_local = 0; i_local <= stackCount; ++i_local)
-                    {
-                        stackAngle = PI / 2 - i_local * stackStep;        // starting from pi/2 to -pi/2
-                        xy_local = sphereRadius * cosf(stackAngle);             // r * cos(u)
-                        z_local = sphereRadius * sinf(stackAngle);              // r * sin(u)
-                        // add (sectorCount+1) vertices per stack
-                        // first and last vertices have same position and normal, but different tex coords
-                        for(int j_local = 0; j_local <= sectorCount; ++j_local)
-                        {
-                            sectorAngle = j_local * sectorStep;           // starting from 0 to 2pi
-                            
-                            // vertex position with respect to (x, y, z) is (x_local, y_local, z_local)
-                            x_local = xy_local * cosf(sectorAngle);             // r * cos(u) * cos(v)
-                            y_local = xy_local * sinf(sectorAngle);             // r * cos(u) * sin(v)
-                            
-                            sphereVertices.push_back(x_local + x);
-                            sphereVertices.push_back(y_local + y);              // + x,y,z
-                            sphereVertices.push_back(z_local + z);
-                            
-                            // normalized vertex normal (nx, ny, nz)
-                            nx = x_local * lengthInv;
-                            ny = y_local * lengthInv;
-                            nz = z_local * lengthInv;
-                            sphereNormals.push_back(nx);
-                            sphereNormals.push_back(ny);
-                            sphereNormals.push_back(nz);
-                            
-                            // vertex tex coord (s, t) range between [0, 1]
-                            s = (GLfloat)i_local / sectorCount;
-                            t = (GLfloat)i_local / stackCount;
-                            sphereTexCoords.push_back(s);
-                            sphereTexCoords.push_back(t);
-                        }
-                    }
-                    //---------- END GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    //---------------------------------------------------------------------//
-                    //-------------- GENERATE COMPLETE VERTEX VECTOR ----------------------//
-                    std::vector<GLfloat> completeSphereVertexVec;
-                    int length_completeSphereVertexVec = (int) ((sphereVertices.size() * 11.0)/3);
-                    
-                    int j_a = 0;
-                    for (int i_a = 0; i_a < length_completeSphereVertexVec;) {
-                        // COORDINATES:
-                        for (int k_a = j_a; k_a < j_a+3; k_a++) {
-                            completeSphereVertexVec.push_back(sphereVertices.at(k_a)); i_a++;
-                            //std::cout << sphereVertices.at(k_a) << std::endl;
-                        }
-                        j_a += 3;
-                        // COLORS:
-                        completeSphereVertexVec.push_back(sphereColor_red); i_a++;// RED
-                        completeSphereVertexVec.push_back(sphereColor_green); i_a++; // GREEN
-                        completeSphereVertexVec.push_back(sphereColor_blue); i_a++; // BLUE
-                        // TEXCOORD:
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        // NORMALS:
-                        for (int k_a = j_a-3; k_a < j_a; k_a++) {
-                            completeSphereVertexVec.push_back(sphereNormals.at(k_a)); i_a++;
-                        }
-                    }
-                    //------------- END GENERATE COMPLETE VERTEX VECTOR ------------------//
-                    //--------------------------------------------------------------------//
-                    //------- ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec ---------//
-                    allSpheres_VertexVec.push_back(completeSphereVertexVec);
-                    
-                    //----- END ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec -------//
-                    //--------------------------------------------------------------------//
-                    //-----------------------------END GENERATE SPHERE ------------------------------//
-                    
-                }
-            }
+        // Octree samples are not cached, their number depends on the orbital
+        if (adaptiveSampling) {
+            evaluateAdaptive(orbital, adaptiveSettingsFor(numSpheres_per_side), sphereInstances);
+            numSpheres = sphereInstances.size();
+            return sphereInstances.data();
         }
-    } else if (n == 2 && l == 1 && ml == 0) {
-        std::cout << "Scale factor: axes extend to 1 Bohr (0.5 A).\n";
-        // Nested for loops traverse a cube centered on the origin in 3D space
-        for (int i = 0; i < numSpheres_per_side; i++) {
-            for (int j = 0; j < numSpheres_per_side; j++) {
-                for (int k = 0; k < numSpheres_per_side; k++) {
-                    // At each point on the cube of traversed values, we create an array of vertices for the probability density sphere at that point
-                    // NOTE: r IS THE DISTANCE OF THE SPHERE FROM THE ORIGIN, sphereRadius IS THE SPHERE RADIUS
-                    GLfloat x = -5.00f + (i * step); // x,y,x is the center of the probability sphere
-                    GLfloat y = -5.00f + (j * step);
-                    GLfloat z = -5.00f + (k * step);
-                    
-                    GLfloat r = r_of(x,y,z);
-                    GLfloat theta = theta_of(x,y,z);
-                    GLfloat phi = phi_of(x,y,z);
-                    
-                    // conversion factor: 5.0 = 1 Bohr radius
-                    GLfloat probDensity = _210_eq(r,theta,phi);
-                    //std::cout << "Prob Density is: " << probDensity << std::endl;
-                    
-                    // Conversion factor: step/2 => sphereRadius is maximum (subject to change)
-                    // maximum of the 2s prob density
-                    GLfloat sphereRadius = step/1.5f * probDensity;
-                    GLfloat sphereColor_red = 1.0f * (1-probDensity); // More red = lower prob density
-                    GLfloat sphereColor_green = 1.0f * probDensity;   // More green = higher prob density
-                    GLfloat sphereColor_blue = 0.2f;                        // Blue is constant for now
-                    
-                    //------------------------------ GENERATE SPHERE -----------------------------------//
-                    //-------------------------------------------------------------------//
-                    //------------ GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    std::vector<GLfloat> sphereVertices;
-                    std::vector<GLfloat> sphereNormals;
-                    std::vector<GLfloat> sphereTexCoords;
-                    
-                    std::vector<GLfloat>().swap(sphereVertices);
-                    std::vector<GLfloat>().swap(sphereNormals);
-                    std::vector<GLfloat>().swap(sphereTexCoords);
-                    GLfloat x_local,y_local,z_local,xy_local;               // vertex position
-                    GLfloat nx, ny, nz, lengthInv = 1.0f / sphereRadius;    // vertex normal
-                    GLfloat s, t;                                           // vertex texCoord
-                    
-                    GLfloat sectorStep = 2 * PI / sectorCount;
-                    GLfloat stackStep = PI / stackCount;
-                    GLfloat sectorAngle, stackAngle;
-                    
-                    for(int i_local = 0; i_local <= stackCount; ++i_local)
-                    {
-                        stackAngle = PI / 2 - i_local * stackStep;        // starting from pi/2 to -pi/2
-                        xy_local = sphereRadius * cosf(stackAngle);             // r * cos(u)
-                        z_local = sphereRadius * sinf(stackAngle);              // r * sin(u)
-                        // add (sectorCount+1) vertices per stack
-                        // first and last vertices have same position and normal, but different tex coords
-                        for(int j_local = 0; j_local <= sectorCount; ++j_local)
-                        {
-                            sectorAngle = j_local * sectorStep;           // starting from 0 to 2pi
-                            
-                            // vertex position with respect to (x, y, z) is (x_local, y_local, z_local)
-                            x_local = xy_local * cosf(sectorAngle);             // r * cos(u) * cos(v)
-                            y_local = xy_local * sinf(sectorAngle);             // r * cos(u) * sin(v)
-                            
-                            sphereVertices.push_back(x_local + x);
-                            sphereVertices.push_back(y_local + y);              // + x,y,z
-                            sphereVertices.push_back(z_local + z);
-                            
-                            // normalized vertex normal (nx, ny, nz)
-                            nx = x_local * lengthInv;
-                            ny = y_local * lengthInv;
-                            nz = z_local * lengthInv;
-                            sphereNormals.push_back(nx);
-                            sphereNormals.push_back(ny);
-                            sphereNormals.push_back(nz);
-                            
-                            // vertex tex coord (s, t) range between [0, 1]
-                            s = (GLfloat)i_local / sectorCount;
-                            t = (GLfloat)i_local / stackCount;
-                            sphereTexCoords.push_back(s);
-                            sphereTexCoords.push_back(t);
-                        }
-                    }
-                    //---------- END GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    //---------------------------------------------------------------------//
-                    //-------------- GENERATE COMPLETE VERTEX VECTOR ----------------------//
-                    std::vector<GLfloat> completeSphereVertexVec;
-                    int length_completeSphereVertexVec = (int) ((sphereVertices.size() * 11.0)/3);
-                    
-                    int j_a = 0;
-                    for (int i_a = 0; i_a < length_completeSphereVertexVec;) {
-                        // COORDINATES:
-                        for (int k_a = j_a; k_a < j_a+3; k_a++) {
-                            completeSphereVertexVec.push_back(sphereVertices.at(k_a)); i_a++;
-                            //std::cout << sphereVertices.at(k_a) << std::endl;
-                        }
-                        j_a += 3;
-                        // COLORS:
-                        completeSphereVertexVec.push_back(sphereColor_red); i_a++;// RED
-                        completeSphereVertexVec.push_back(sphereColor_green); i_a++; // GREEN
-                        completeSphereVertexVec.push_back(sphereColor_blue); i_a++; // BLUE
-                        // TEXCOORD:
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        // NORMALS:
-                        for (int k_a = j_a-3; k_a < j_a; k_a++) {
-                            completeSphereVertexVec.push_back(sphereNormals.at(k_a)); i_a++;
-                        }
-                    }
-                    //------------- END GENERATE COMPLETE VERTEX VECTOR ------------------//
-                    //--------------------------------------------------------------------//
-                    //------- ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec ---------//
-                    allSpheres_VertexVec.push_back(completeSphereVertexVec);
-                    
-                    //----- END ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec -------//
-                    //--------------------------------------------------------------------//
-                    //-----------------------------END GENERATE SPHERE ------------------------------//
-                    
-                }
+        if (useOrbitalCache) {
+            const SphereInstance* cachedSpheres = orbitalCache.Map(orbital, numSpheres_per_side);
+            if (cachedSpheres != NULL && useSphereLODs) {
+                sphereInstances.assign(cachedSpheres, cachedSpheres + numSpheres);
+                orbitalCache.Unmap();
+                return sphereInstances.data();
             }
-        }
-    } else if (n == 2 && l == 1 && (ml == 1 || ml == -1)) {
-        std::cout << "Scale factor: axes extend to 5 Bohr (2.5 A).\n";
-        // Nested for loops traverse a cube centered on the origin in 3D space
-        for (int i = 0; i < numSpheres_per_side; i++) {
-            for (int j = 0; j < numSpheres_per_side; j++) {
-                for (int k = 0; k < numSpheres_per_side; k++) {
-                    // At each point on the cube of traversed values, we create an array of vertices for the probability density sphere at that point
-                    // NOTE: r IS THE DISTANCE OF THE SPHERE FROM THE ORIGIN, sphereRadius IS THE SPHERE RADIUS
-                    GLfloat x = -5.00f + (i * step); // x,y,x is the center of the probability sphere
-                    GLfloat y = -5.00f + (j * step);
-                    GLfloat z = -5.00f + (k * step);
-                    
-                    GLfloat r = r_of(x,y,z);
-                    GLfloat theta = theta_of(x,y,z);
-                    GLfloat phi = phi_of(x,y,z);
-                    
-                    // conversion factor: 1.0 = 1 Bohr radius
-                    GLfloat probDensity = _211_eq(r/1.0,theta,phi);
-                    //std::cout << "Prob Density is: " << probDensity << std::endl;
-                    
-                    // Conversion factor: step/2 => sphereRadius is maximum (subject to change)
-                    // maximum of the 2s prob density
-                    GLfloat sphereRadius = step/1.5f * probDensity;
-                    GLfloat sphereColor_red = 1.0f * (1-probDensity); // More red = lower prob density
-                    GLfloat sphereColor_green = 1.0f * probDensity;   // More green = higher prob density
-                    GLfloat sphereColor_blue = 0.2f;                        // Blue is constant for now
-                    
-                    //------------------------------ GENERATE SPHERE -----------------------------------//
-                    //-------------------------------------------------------------------//
-                    //------------ GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    std::vector<GLfloat> sphereVertices;
-                    std::vector<GLfloat> sphereNormals;
-                    std::vector<GLfloat> sphereTexCoords;
-                    
-                    std::vector<GLfloat>().swap(sphereVertices);
-                    std::vector<GLfloat>().swap(sphereNormals);
-                    std::vector<GLfloat>().swap(sphereTexCoords);
-                    GLfloat x_local,y_local,z_local,xy_local;               // vertex position
-                    GLfloat nx, ny, nz, lengthInv = 1.0f / sphereRadius;    // vertex normal
-                    GLfloat s, t;                                           // vertex texCoord
-                    
-                    GLfloat sectorStep = 2 * PI / sectorCount;
-                    GLfloat stackStep = PI / stackCount;
-                    GLfloat sectorAngle, stackAngle;
-                    
-                    for(int i_local = 0; i_local <= stackCount; ++i_local)
-                    {
-                        stackAngle = PI / 2 - i_local * stackStep;        // starting from pi/2 to -pi/2
-                        xy_local = sphereRadius * cosf(stackAngle);             // r * cos(u)
-                        z_local = sphereRadius * sinf(stackAngle);              // r * sin(u)
-                        // add (sectorCount+1) vertices per stack
-                        // first and last vertices have same position and normal, but different tex coords
-                        for(int j_local = 0; j_local <= sectorCount; ++j_local)
-                        {
-                            sectorAngle = j_local * sectorStep;           // starting from 0 to 2pi
-                            
-                            // vertex position with respect to (x, y, z) is (x_local, y_local, z_local)
-                            x_local = xy_local * cosf(sectorAngle);             // r * cos(u) * cos(v)
-                            y_local = xy_local * sinf(sectorAngle);             // r * cos(u) * sin(v)
-                            
-                            sphereVertices.push_back(x_local + x);
-                            sphereVertices.push_back(y_local + y);              // + x,y,z
-                            sphereVertices.push_back(z_local + z);
-                            
-                            // normalized vertex normal (nx, ny, nz)
-                            nx = x_local * lengthInv;
-                            ny = y_local * lengthInv;
-                            nz = z_local * lengthInv;
-                            sphereNormals.push_back(nx);
-                            sphereNormals.push_back(ny);
-                            sphereNormals.push_back(nz);
-                            
-                            // vertex tex coord (s, t) range between [0, 1]
-                            s = (GLfloat)i_local / sectorCount;
-                            t = (GLfloat)i_local / stackCount;
-                            sphereTexCoords.push_back(s);
-                            sphereTexCoords.push_back(t);
-                        }
-                    }
-                    //---------- END GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    //---------------------------------------------------------------------//
-                    //-------------- GENERATE COMPLETE VERTEX VECTOR ----------------------//
-                    std::vector<GLfloat> completeSphereVertexVec;
-                    int length_completeSphereVertexVec = (int) ((sphereVertices.size() * 11.0)/3);
-                    
-                    int j_a = 0;
-                    for (int i_a = 0; i_a < length_completeSphereVertexVec;) {
-                        // COORDINATES:
-                        for (int k_a = j_a; k_a < j_a+3; k_a++) {
-                            completeSphereVertexVec.push_back(sphereVertices.at(k_a)); i_a++;
-                            //std::cout << sphereVertices.at(k_a) << std::endl;
-                        }
-                        j_a += 3;
-                        // COLORS:
-                        completeSphereVertexVec.push_back(sphereColor_red); i_a++;// RED
-                        completeSphereVertexVec.push_back(sphereColor_green); i_a++; // GREEN
-                        completeSphereVertexVec.push_back(sphereColor_blue); i_a++; // BLUE
-                        // TEXCOORD:
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        // NORMALS:
-                        for (int k_a = j_a-3; k_a < j_a; k_a++) {
-                            completeSphereVertexVec.push_back(sphereNormals.at(k_a)); i_a++;
-                        }
-                    }
-                    //------------- END GENERATE COMPLETE VERTEX VECTOR ------------------//
-                    //--------------------------------------------------------------------//
-                    //------- ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec ---------//
-                    allSpheres_VertexVec.push_back(completeSphereVertexVec);
-                    
-                    //----- END ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec -------//
-                    //--------------------------------------------------------------------//
-                    //-----------------------------END GENERATE SPHERE ------------------------------//
-                    
-                }
+            if (cachedSpheres != NULL) {
+                return cachedSpheres;
             }
         }
-    } else if (n == 3 && l == 0 && ml == 0) {
-        std::cout << "Scale factor: axes extend to 10 Bohr (5.0 A).\n";
-        // Nested for loops traverse a cube centered on the origin in 3D space
-        for (int i = 0; i < numSpheres_per_side; i++) {
-            for (int j = 0; j < numSpheres_per_side; j++) {
-                for (int k = 0; k < numSpheres_per_side; k++) {
-                    // At each point on the cube of traversed values, we create an array of vertices for the probability density sphere at that point
-                    // NOTE: r IS THE DISTANCE OF THE SPHERE FROM THE ORIGIN, sphereRadius IS THE SPHERE RADIUS
-                    GLfloat x = -5.00f + (i * step); // x,y,x is the center of the probability sphere
-                    GLfloat y = -5.00f + (j * step);
-                    GLfloat z = -5.00f + (k * step);
-                    
-                    GLfloat r = r_of(x,y,z);
-                    GLfloat theta = theta_of(x,y,z);
-                    GLfloat phi = phi_of(x,y,z);
-                    
-                    // conversion factor: 0.5 = 1 Bohr radius
-                    GLfloat probDensity = _300_eq(r/0.5,theta,phi);
-                    //std::cout << "Prob Density is: " << probDensity << std::endl;
-                    
-                    // Conversion factor: step/2 => sphereRadius is maximum (subject to change)
-                    // maximum of the 2s prob density
-                    GLfloat sphereRadius = step/1.5f * probDensity;
-                    GLfloat sphereColor_red = 1.0f * (1-probDensity); // More red = lower prob density
-                    GLfloat sphereColor_green = 1.0f * probDensity;   // More green = higher prob density
-                    GLfloat sphereColor_blue = 0.2f;                        // Blue is constant for now
-                    
-                    //------------------------------ GENERATE SPHERE -----------------------------------//
-                    //-------------------------------------------------------------------//
-                    //------------ GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    std::vector<GLfloat> sphereVertices;
-                    std::vector<GLfloat> sphereNormals;
-                    std::vector<GLfloat> sphereTexCoords;
-                    
-                    std::vector<GLfloat>().swap(sphereVertices);
-                    std::vector<GLfloat>().swap(sphereNormals);
-                    std::vector<GLfloat>().swap(sphereTexCoords);
-                    GLfloat x_local,y_local,z_local,xy_local;               // vertex position
-                    GLfloat nx, ny, nz, lengthInv = 1.0f / sphereRadius;    // vertex normal
-                    GLfloat s, t;                                           // vertex texCoord
-                    
-                    GLfloat sectorStep = 2 * PI / sectorCount;
-                    GLfloat stackStep = PI / stackCount;
-                    GLfloat sectorAngle, stackAngle;
-                    
-                    for(int i_local = 0; i_local <= stackCount; ++i_local)
-                    {
-                        stackAngle = PI / 2 - i_local * stackStep;        // starting from pi/2 to -pi/2
-                        xy_local = sphereRadius * cosf(stackAngle);             // r * cos(u)
-                        z_local = sphereRadius * sinf(stackAngle);              // r * sin(u)
-                        // add (sectorCount+1) vertices per stack
-                        // first and last vertices have same position and normal, but different tex coords
-                        for(int j_local = 0; j_local <= sectorCount; ++j_local)
-                        {
-                            sectorAngle = j_local * sectorStep;           // starting from 0 to 2pi
-                            
-                            // vertex position with respect to (x, y, z) is (x_local, y_local, z_local)
-                            x_local = xy_local * cosf(sectorAngle);             // r * cos(u) * cos(v)
-                            y_local = xy_local * sinf(sectorAngle);             // r * cos(u) * sin(v)
-                            
-                            sphereVertices.push_back(x_local + x);
-                            sphereVertices.push_back(y_local + y);              // + x,y,z
-                            sphereVertices.push_back(z_local + z);
-                            
-                            // normalized vertex normal (nx, ny, nz)
-                            nx = x_local * lengthInv;
-                            ny = y_local * lengthInv;
-                            nz = z_local * lengthInv;
-                            sphereNormals.push_back(nx);
-                            sphereNormals.push_back(ny);
-                            sphereNormals.push_back(nz);
-                            
-                            // vertex tex coord (s, t) range between [0, 1]
-                            s = (GLfloat)i_local / sectorCount;
-                            t = (GLfloat)i_local / stackCount;
-                            sphereTexCoords.push_back(s);
-                            sphereTexCoords.push_back(t);
-                        }
-                    }
-                    //---------- END GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    //---------------------------------------------------------------------//
-                    //-------------- GENERATE COMPLETE VERTEX VECTOR ----------------------//
-                    std::vector<GLfloat> completeSphereVertexVec;
-                    int length_completeSphereVertexVec = (int) ((sphereVertices.size() * 11.0)/3);
-                    
-                    int j_a = 0;
-                    for (int i_a = 0; i_a < length_completeSphereVertexVec;) {
-                        // COORDINATES:
-                        for (int k_a = j_a; k_a < j_a+3; k_a++) {
-                            completeSphereVertexVec.push_back(sphereVertices.at(k_a)); i_a++;
-                            //std::cout << sphereVertices.at(k_a) << std::endl;
-                        }
-                        j_a += 3;
-                        // COLORS:
-                        completeSphereVertexVec.push_back(sphereColor_red); i_a++;// RED
-                        completeSphereVertexVec.push_back(sphereColor_green); i_a++; // GREEN
-                        completeSphereVertexVec.push_back(sphereColor_blue); i_a++; // BLUE
-                        // TEXCOORD:
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        // NORMALS:
-                        for (int k_a = j_a-3; k_a < j_a; k_a++) {
-                            completeSphereVertexVec.push_back(sphereNormals.at(k_a)); i_a++;
-                        }
-                    }
-                    //------------- END GENERATE COMPLETE VERTEX VECTOR ------------------//
-                    //--------------------------------------------------------------------//
-                    //------- ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec ---------//
-                    allSpheres_VertexVec.push_back(completeSphereVertexVec);
-                    
-                    //----- END ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec -------//
-                    //--------------------------------------------------------------------//
-                    //-----------------------------END GENERATE SPHERE ------------------------------//
-                    
-                }
-            }
-        }
-    } else if (n == 3 && l == 1 && ml == 0) {
-        std::cout << "Scale factor: axes extend to 7.5 Bohr (3.75 A).\n";
-        // Nested for loops traverse a cube centered on the origin in 3D space
-        for (int i = 0; i < numSpheres_per_side; i++) {
-            for (int j = 0; j < numSpheres_per_side; j++) {
-                for (int k = 0; k < numSpheres_per_side; k++) {
-                    // At each point on the cube of traversed values, we create an array of vertices for the probability density sphere at that point
-                    // NOTE: r IS THE DISTANCE OF THE SPHERE FROM THE ORIGIN, sphereRadius IS THE SPHERE RADIUS
-                    GLfloat x = -5.00f + (i * step); // x,y,x is the center of the probability sphere
-                    GLfloat y = -5.00f + (j * step);
-                    GLfloat z = -5.00f + (k * step);
-                    
-                    GLfloat r = r_of(x,y,z);
-                    GLfloat theta = theta_of(x,y,z);
-                    GLfloat phi = phi_of(x,y,z);
-                    
-                    // conversion factor: 0.666666666 = 1 Bohr radius
-                    GLfloat probDensity = _310_eq(r/0.666666666f,theta,phi);
-                    //std::cout << "Prob Density is: " << probDensity << std::endl;
-                    
-                    // Conversion factor: step/2 => sphereRadius is maximum (subject to change)
-                    // maximum of the 2s prob density
-                    GLfloat sphereRadius = step/1.5f * probDensity;
-                    GLfloat sphereColor_red = 1.0f * (1-probDensity); // More red = lower prob density
-                    GLfloat sphereColor_green = 1.0f * probDensity;   // More green = higher prob density
-                    GLfloat sphereColor_blue = 0.2f;                        // Blue is constant for now
-                    
-                    //------------------------------ GENERATE SPHERE -----------------------------------//
-                    //-------------------------------------------------------------------//
-                    //------------ GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    std::vector<GLfloat> sphereVertices;
-                    std::vector<GLfloat> sphereNormals;
-                    std::vector<GLfloat> sphereTexCoords;
-                    
-                    std::vector<GLfloat>().swap(sphereVertices);
-                    std::vector<GLfloat>().swap(sphereNormals);
-                    std::vector<GLfloat>().swap(sphereTexCoords);
-                    GLfloat x_local,y_local,z_local,xy_local;               // vertex position
-                    GLfloat nx, ny, nz, lengthInv = 1.0f / sphereRadius;    // vertex normal
-                    GLfloat s, t;                                           // vertex texCoord
-                    
-                    GLfloat sectorStep = 2 * PI / sectorCount;
-                    GLfloat stackStep = PI / stackCount;
-                    GLfloat sectorAngle, stackAngle;
-                    
-                    for(int i_local = 0; i_local <= stackCount; ++i_local)
-                    {
-                        stackAngle = PI / 2 - i_local * stackStep;        // starting from pi/2 to -pi/2
-                        xy_local = sphereRadius * cosf(stackAngle);             // r * cos(u)
-                        z_local = sphereRadius * sinf(stackAngle);              // r * sin(u)
-                        // add (sectorCount+1) vertices per stack
-                        // first and last vertices have same position and normal, but different tex coords
-                        for(int j_local = 0; j_local <= sectorCount; ++j_local)
-                        {
-                            sectorAngle = j_local * sectorStep;           // starting from 0 to 2pi
-                            
-                            // vertex position with respect to (x, y, z) is (x_local, y_local, z_local)
-                            x_local = xy_local * cosf(sectorAngle);             // r * cos(u) * cos(v)
-                            y_local = xy_local * sinf(sectorAngle);             // r * cos(u) * sin(v)
-                            
-                            sphereVertices.push_back(x_local + x);
-                            sphereVertices.push_back(y_local + y);              // + x,y,z
-                            sphereVertices.push_back(z_local + z);
-                            
-                            // normalized vertex normal (nx, ny, nz)
-                            nx = x_local * lengthInv;
-                            ny = y_local * lengthInv;
-                            nz = z_local * lengthInv;
-                            sphereNormals.push_back(nx);
-                            sphereNormals.push_back(ny);
-                            sphereNormals.push_back(nz);
-                            
-                            // vertex tex coord (s, t) range between [0, 1]
-                            s = (GLfloat)i_local / sectorCount;
-                            t = (GLfloat)i_local / stackCount;
-                            sphereTexCoords.push_back(s);
-                            sphereTexCoords.push_back(t);
-                        }
-                    }
-                    //---------- END GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    //---------------------------------------------------------------------//
-                    //-------------- GENERATE COMPLETE VERTEX VECTOR ----------------------//
-                    std::vector<GLfloat> completeSphereVertexVec;
-                    int length_completeSphereVertexVec = (int) ((sphereVertices.size() * 11.0)/3);
-                    
-                    int j_a = 0;
-                    for (int i_a = 0; i_a < length_completeSphereVertexVec;) {
-                        // COORDINATES:
-                        for (int k_a = j_a; k_a < j_a+3; k_a++) {
-                            completeSphereVertexVec.push_back(sphereVertices.at(k_a)); i_a++;
-                            //std::cout << sphereVertices.at(k_a) << std::endl;
-                        }
-                        j_a += 3;
-                        // COLORS:
-                        completeSphereVertexVec.push_back(sphereColor_red); i_a++;// RED
-                        completeSphereVertexVec.push_back(sphereColor_green); i_a++; // GREEN
-                        completeSphereVertexVec.push_back(sphereColor_blue); i_a++; // BLUE
-                        // TEXCOORD:
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        // NORMALS:
-                        for (int k_a = j_a-3; k_a < j_a; k_a++) {
-                            completeSphereVertexVec.push_back(sphereNormals.at(k_a)); i_a++;
-                        }
-                    }
-                    //------------- END GENERATE COMPLETE VERTEX VECTOR ------------------//
-                    //--------------------------------------------------------------------//
-                    //------- ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec ---------//
-                    allSpheres_VertexVec.push_back(completeSphereVertexVec);
-                    
-                    //----- END ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec -------//
-                    //--------------------------------------------------------------------//
-                    //-----------------------------END GENERATE SPHERE ------------------------------//
-                    
-                }
-            }
-        }
-    } else if (n == 3 && l == 1 && (ml == 1 || ml == -1)) {
-        std::cout << "Scale factor: axes extend to 6.7 Bohr (3.3 A).\n";
-        // Nested for loops traverse a cube centered on the origin in 3D space
-        for (int i = 0; i < numSpheres_per_side; i++) {
-            for (int j = 0; j < numSpheres_per_side; j++) {
-                for (int k = 0; k < numSpheres_per_side; k++) {
-                    // At each point on the cube of traversed values, we create an array of vertices for the probability density sphere at that point
-                    // NOTE: r IS THE DISTANCE OF THE SPHERE FROM THE ORIGIN, sphereRadius IS THE SPHERE RADIUS
-                    GLfloat x = -5.00f + (i * step); // x,y,x is the center of the probability sphere
-                    GLfloat y = -5.00f + (j * step);
-                    GLfloat z = -5.00f + (k * step);
-                    
-                    GLfloat r = r_of(x,y,z);
-                    GLfloat theta = theta_of(x,y,z);
-                    GLfloat phi = phi_of(x,y,z);
-                    
-                    // conversion factor: 0.75 = 1 Bohr radius
-                    GLfloat probDensity = _311_eq(r/0.666666666666f,theta,phi);
-                    
-                    // Conversion factor: step/2 => sphereRadius is maximum (subject to change)
-                    // maximum of the 2s prob density
-                    GLfloat sphereRadius = step/1.5f * probDensity;
-                    GLfloat sphereColor_red = 1.0f * (1-probDensity); // More red = lower prob density
-                    GLfloat sphereColor_green = 1.0f * probDensity;   // More green = higher prob density
-                    GLfloat sphereColor_blue = 0.2f;                        // Blue is constant for now
-                    
-                    //------------------------------ GENERATE SPHERE -----------------------------------//
-                    //-------------------------------------------------------------------//
-                    //------------ GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    std::vector<GLfloat> sphereVertices;
-                    std::vector<GLfloat> sphereNormals;
-                    std::vector<GLfloat> sphereTexCoords;
-                    
-                    std::vector<GLfloat>().swap(sphereVertices);
-                    std::vector<GLfloat>().swap(sphereNormals);
-                    std::vector<GLfloat>().swap(sphereTexCoords);
-                    GLfloat x_local,y_local,z_local,xy_local;               // vertex position
-                    GLfloat nx, ny, nz, lengthInv = 1.0f / sphereRadius;    // vertex normal
-                    GLfloat s, t;                                           // vertex texCoord
-                    
-                    GLfloat sectorStep = 2 * PI / sectorCount;
-                    GLfloat stackStep = PI / stackCount;
-                    GLfloat sectorAngle, stackAngle;
-                    
-                    for(int i_local = 0; i_local <= stackCount; ++i_local)
-                    {
-                        stackAngle = PI / 2 - i_local * stackStep;        // starting from pi/2 to -pi/2
-                        xy_local = sphereRadius * cosf(stackAngle);             // r * cos(u)
-                        z_local = sphereRadius * sinf(stackAngle);              // r * sin(u)
-                        // add (sectorCount+1) vertices per stack
-                        // first and last vertices have same position and normal, but different tex coords
-                        for(int j_local = 0; j_local <= sectorCount; ++j_local)
-                        {
-                            sectorAngle = j_local * sectorStep;           // starting from 0 to 2pi
-                            
-                            // vertex position with respect to (x, y, z) is (x_local, y_local, z_local)
-                            x_local = xy_local * cosf(sectorAngle);             // r * cos(u) * cos(v)
-                            y_local = xy_local * sinf(sectorAngle);             // r * cos(u) * sin(v)
-                            
-                            sphereVertices.push_back(x_local + x);
-                            sphereVertices.push_back(y_local + y);              // + x,y,z
-                            sphereVertices.push_back(z_local + z);
-                            
-                            // normalized vertex normal (nx, ny, nz)
-                            nx = x_local * lengthInv;
-                            ny = y_local * lengthInv;
-                            nz = z_local * lengthInv;
-                            sphereNormals.push_back(nx);
-                            sphereNormals.push_back(ny);
-                            sphereNormals.push_back(nz);
-                            
-                            // vertex tex coord (s, t) range between [0, 1]
-                            s = (GLfloat)i_local / sectorCount;
-                            t = (GLfloat)i_local / stackCount;
-                            sphereTexCoords.push_back(s);
-                            sphereTexCoords.push_back(t);
-                        }
-                    }
-                    //---------- END GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    //---------------------------------------------------------------------//
-                    //-------------- GENERATE COMPLETE VERTEX VECTOR ----------------------//
-                    std::vector<GLfloat> completeSphereVertexVec;
-                    int length_completeSphereVertexVec = (int) ((sphereVertices.size() * 11.0)/3);
-                    
-                    int j_a = 0;
-                    for (int i_a = 0; i_a < length_completeSphereVertexVec;) {
-                        // COORDINATES:
-                        for (int k_a = j_a; k_a < j_a+3; k_a++) {
-                            completeSphereVertexVec.push_back(sphereVertices.at(k_a)); i_a++;
-                            //std::cout << sphereVertices.at(k_a) << std::endl;
-                        }
-                        j_a += 3;
-                        // COLORS:
-                        completeSphereVertexVec.push_back(sphereColor_red); i_a++;// RED
-                        completeSphereVertexVec.push_back(sphereColor_green); i_a++; // GREEN
-                        completeSphereVertexVec.push_back(sphereColor_blue); i_a++; // BLUE
-                        // TEXCOORD:
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        // NORMALS:
-                        for (int k_a = j_a-3; k_a < j_a; k_a++) {
-                            completeSphereVertexVec.push_back(sphereNormals.at(k_a)); i_a++;
-                        }
-                    }
-                    //------------- END GENERATE COMPLETE VERTEX VECTOR ------------------//
-                    //--------------------------------------------------------------------//
-                    //------- ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec ---------//
-                    allSpheres_VertexVec.push_back(completeSphereVertexVec);
-                    
-                    //----- END ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec -------//
-                    //--------------------------------------------------------------------//
-                    //-----------------------------END GENERATE SPHERE ------------------------------//
-                    
-                }
-            }
-        }
-    } else if (n == 3 && l == 2 && ml == 0) {
-        std::cout << "Scale factor: axes extend to 10 Bohr (5 A).\n";
-        // Nested for loops traverse a cube centered on the origin in 3D space
-        for (int i = 0; i < numSpheres_per_side; i++) {
-            for (int j = 0; j < numSpheres_per_side; j++) {
-                for (int k = 0; k < numSpheres_per_side; k++) {
-                    // At each point on the cube of traversed values, we create an array of vertices for the probability density sphere at that point
-                    // NOTE: r IS THE DISTANCE OF THE SPHERE FROM THE ORIGIN, sphereRadius IS THE SPHERE RADIUS
-                    GLfloat x = -5.00f + (i * step); // x,y,x is the center of the probability sphere
-                    GLfloat y = -5.00f + (j * step);
-                    GLfloat z = -5.00f + (k * step);
-                    
-                    GLfloat r = r_of(x,y,z);
-                    GLfloat theta = theta_of(x,y,z);
-                    GLfloat phi = phi_of(x,y,z);
-                    
-                    // conversion factor: 0.5 = 1 Bohr radius
-                    GLfloat probDensity = _320_eq(r/0.4f,theta,phi);
-                    
-                    // Conversion factor: step/2 => sphereRadius is maximum (subject to change)
-                    // maximum of the 2s prob density
-                    GLfloat sphereRadius = step/1.5f * probDensity;
-                    GLfloat sphereColor_red = 1.0f * (1-probDensity); // More red = lower prob density
-                    GLfloat sphereColor_green = 1.0f * probDensity;   // More green = higher prob density
-                    GLfloat sphereColor_blue = 0.2f;                        // Blue is constant for now
-                    
-                    //------------------------------ GENERATE SPHERE -----------------------------------//
-                    //-------------------------------------------------------------------//
-                    //------------ GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    std::vector<GLfloat> sphereVertices;
-                    std::vector<GLfloat> sphereNormals;
-                    std::vector<GLfloat> sphereTexCoords;
-                    
-                    std::vector<GLfloat>().swap(sphereVertices);
-                    std::vector<GLfloat>().swap(sphereNormals);
-                    std::vector<GLfloat>().swap(sphereTexCoords);
-                    GLfloat x_local,y_local,z_local,xy_local;               // vertex position
-                    GLfloat nx, ny, nz, lengthInv = 1.0f / sphereRadius;    // vertex normal
-                    GLfloat s, t;                                           // vertex texCoord
-                    
-                    GLfloat sectorStep = 2 * PI / sectorCount;
-                    GLfloat stackStep = PI / stackCount;
-                    GLfloat sectorAngle, stackAngle;
-                    
-                    for(int i_local = 0; i_local <= stackCount; ++i_local)
-                    {
-                        stackAngle = PI / 2 - i_local * stackStep;        // starting from pi/2 to -pi/2
-                        xy_local = sphereRadius * cosf(stackAngle);             // r * cos(u)
-                        z_local = sphereRadius * sinf(stackAngle);              // r * sin(u)
-                        // add (sectorCount+1) vertices per stack
-                        // first and last vertices have same position and normal, but different tex coords
-                        for(int j_local = 0; j_local <= sectorCount; ++j_local)
-                        {
-                            sectorAngle = j_local * sectorStep;           // starting from 0 to 2pi
-                            
-                            // vertex position with respect to (x, y, z) is (x_local, y_local, z_local)
-                            x_local = xy_local * cosf(sectorAngle);             // r * cos(u) * cos(v)
-                            y_local = xy_local * sinf(sectorAngle);             // r * cos(u) * sin(v)
-                            
-                            sphereVertices.push_back(x_local + x);
-                            sphereVertices.push_back(y_local + y);              // + x,y,z
-                            sphereVertices.push_back(z_local + z);
-                            
-                            // normalized vertex normal (nx, ny, nz)
-                            nx = x_local * lengthInv;
-                            ny = y_local * lengthInv;
-                            nz = z_local * lengthInv;
-                            sphereNormals.push_back(nx);
-                            sphereNormals.push_back(ny);
-                            sphereNormals.push_back(nz);
-                            
-                            // vertex tex coord (s, t) range between [0, 1]
-                            s = (GLfloat)i_local / sectorCount;
-                            t = (GLfloat)i_local / stackCount;
-                            sphereTexCoords.push_back(s);
-                            sphereTexCoords.push_back(t);
-                        }
-                    }
-                    //---------- END GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    //---------------------------------------------------------------------//
-                    //-------------- GENERATE COMPLETE VERTEX VECTOR ----------------------//
-                    std::vector<GLfloat> completeSphereVertexVec;
-                    int length_completeSphereVertexVec = (int) ((sphereVertices.size() * 11.0)/3);
-                    
-                    int j_a = 0;
-                    for (int i_a = 0; i_a < length_completeSphereVertexVec;) {
-                        // COORDINATES:
-                        for (int k_a = j_a; k_a < j_a+3; k_a++) {
-                            completeSphereVertexVec.push_back(sphereVertices.at(k_a)); i_a++;
-                            //std::cout << sphereVertices.at(k_a) << std::endl;
-                        }
-                        j_a += 3;
-                        // COLORS:
-                        completeSphereVertexVec.push_back(sphereColor_red); i_a++;// RED
-                        completeSphereVertexVec.push_back(sphereColor_green); i_a++; // GREEN
-                        completeSphereVertexVec.push_back(sphereColor_blue); i_a++; // BLUE
-                        // TEXCOORD:
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        // NORMALS:
-                        for (int k_a = j_a-3; k_a < j_a; k_a++) {
-                            completeSphereVertexVec.push_back(sphereNormals.at(k_a)); i_a++;
-                        }
-                    }
-                    //------------- END GENERATE COMPLETE VERTEX VECTOR ------------------//
-                    //--------------------------------------------------------------------//
-                    //------- ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec ---------//
-                    allSpheres_VertexVec.push_back(completeSphereVertexVec);
-                    
-                    //----- END ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec -------//
-                    //--------------------------------------------------------------------//
-                    //-----------------------------END GENERATE SPHERE ------------------------------//
-                    
-                }
-            }
-        }
-    } else if (n == 3 && l == 2 && (ml == 1 || ml == -1)) {
-        std::cout << "Scale factor: axes extend to 10 Bohr (5 A).\n";
-        // Nested for loops traverse a cube centered on the origin in 3D space
-        for (int i = 0; i < numSpheres_per_side; i++) {
-            for (int j = 0; j < numSpheres_per_side; j++) {
-                for (int k = 0; k < numSpheres_per_side; k++) {
-                    // At each point on the cube of traversed values, we create an array of vertices for the probability density sphere at that point
-                    // NOTE: r IS THE DISTANCE OF THE SPHERE FROM THE ORIGIN, sphereRadius IS THE SPHERE RADIUS
-                    GLfloat x = -5.00f + (i * step); // x,y,x is the center of the probability sphere
-                    GLfloat y = -5.00f + (j * step);
-                    GLfloat z = -5.00f + (k * step);
-                    
-                    GLfloat r = r_of(x,y,z);
-                    GLfloat theta = theta_of(x,y,z);
-                    GLfloat phi = phi_of(x,y,z);
-                    
-                    // conversion factor: 0.5 = 1 Bohr radius
-                    GLfloat probDensity = _321_eq(r/0.5f,theta,phi);
-                    
-                    // Conversion factor: step/2 => sphereRadius is maximum (subject to change)
-                    // maximum of the 2s prob density
-                    GLfloat sphereRadius = step/1.5f * probDensity;
-                    GLfloat sphereColor_red = 1.0f * (1-probDensity); // More red = lower prob density
-                    GLfloat sphereColor_green = 1.0f * probDensity;   // More green = higher prob density
-                    GLfloat sphereColor_blue = 0.2f;                        // Blue is constant for now
-                    
-                    //------------------------------ GENERATE SPHERE -----------------------------------//
-                    //-------------------------------------------------------------------//
-                    //------------ GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    std::vector<GLfloat> sphereVertices;
-                    std::vector<GLfloat> sphereNormals;
-                    std::vector<GLfloat> sphereTexCoords;
-                    
-                    std::vector<GLfloat>().swap(sphereVertices);
-                    std::vector<GLfloat>().swap(sphereNormals);
-                    std::vector<GLfloat>().swap(sphereTexCoords);
-                    GLfloat x_local,y_local,z_local,xy_local;               // vertex position
-                    GLfloat nx, ny, nz, lengthInv = 1.0f / sphereRadius;    // vertex normal
-                    GLfloat s, t;                                           // vertex texCoord
-                    
-                    GLfloat sectorStep = 2 * PI / sectorCount;
-                    GLfloat stackStep = PI / stackCount;
-                    GLfloat sectorAngle, stackAngle;
-                    
-                    for(int i_local = 0; i_local <= stackCount; ++i_local)
-                    {
-                        stackAngle = PI / 2 - i_local * stackStep;        // starting from pi/2 to -pi/2
-                        xy_local = sphereRadius * cosf(stackAngle);             // r * cos(u)
-                        z_local = sphereRadius * sinf(stackAngle);              // r * sin(u)
-                        // add (sectorCount+1) vertices per stack
-                        // first and last vertices have same position and normal, but different tex coords
-                        for(int j_local = 0; j_local <= sectorCount; ++j_local)
-                        {
-                            sectorAngle = j_local * sectorStep;           // starting from 0 to 2pi
-                            
-                            // vertex position with respect to (x, y, z) is (x_local, y_local, z_local)
-                            x_local = xy_local * cosf(sectorAngle);             // r * cos(u) * cos(v)
-                            y_local = xy_local * sinf(sectorAngle);             // r * cos(u) * sin(v)
-                            
-                            sphereVertices.push_back(x_local + x);
-                            sphereVertices.push_back(y_local + y);              // + x,y,z
-                            sphereVertices.push_back(z_local + z);
-                            
-                            // normalized vertex normal (nx, ny, nz)
-                            nx = x_local * lengthInv;
-                            ny = y_local * lengthInv;
-                            nz = z_local * lengthInv;
-                            sphereNormals.push_back(nx);
-                            sphereNormals.push_back(ny);
-                            sphereNormals.push_back(nz);
-                            
-                            // vertex tex coord (s, t) range between [0, 1]
-                            s = (GLfloat)i_local / sectorCount;
-                            t = (GLfloat)i_local / stackCount;
-                            sphereTexCoords.push_back(s);
-                            sphereTexCoords.push_back(t);
-                        }
-                    }
-                    //---------- END GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    //---------------------------------------------------------------------//
-                    //-------------- GENERATE COMPLETE VERTEX VECTOR ----------------------//
-                    std::vector<GLfloat> completeSphereVertexVec;
-                    int length_completeSphereVertexVec = (int) ((sphereVertices.size() * 11.0)/3);
-                    
-                    int j_a = 0;
-                    for (int i_a = 0; i_a < length_completeSphereVertexVec;) {
-                        // COORDINATES:
-                        for (int k_a = j_a; k_a < j_a+3; k_a++) {
-                            completeSphereVertexVec.push_back(sphereVertices.at(k_a)); i_a++;
-                            //std::cout << sphereVertices.at(k_a) << std::endl;
-                        }
-                        j_a += 3;
-                        // COLORS:
-                        completeSphereVertexVec.push_back(sphereColor_red); i_a++;// RED
-                        completeSphereVertexVec.push_back(sphereColor_green); i_a++; // GREEN
-                        completeSphereVertexVec.push_back(sphereColor_blue); i_a++; // BLUE
-                        // TEXCOORD:
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        // NORMALS:
-                        for (int k_a = j_a-3; k_a < j_a; k_a++) {
-                            completeSphereVertexVec.push_back(sphereNormals.at(k_a)); i_a++;
-                        }
-                    }
-                    //------------- END GENERATE COMPLETE VERTEX VECTOR ------------------//
-                    //--------------------------------------------------------------------//
-                    //------- ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec ---------//
-                    allSpheres_VertexVec.push_back(completeSphereVertexVec);
-                    
-                    //----- END ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec -------//
-                    //--------------------------------------------------------------------//
-                    //-----------------------------END GENERATE SPHERE ------------------------------//
-                    
-                }
-            }
+        sphereInstances.resize(numSpheres);
+        orbital.evaluate(orbital, numSpheres_per_side, sphereInstances.data());
+        if (useOrbitalCache) {
+            orbitalCache.Store(orbital, numSpheres_per_side, sphereInstances.data());
         }
-    } else if (n == 3 && l == 2 && (ml == 2 || ml == -2)) {
-        std::cout << "Scale factor: axes extend to 10 Bohr (5 A).\n";
-        // Nested for loops traverse a cube centered on the origin in 3D space
-        for (int i = 0; i < numSpheres_per_side; i++) {
-            for (int j = 0; j < numSpheres_per_side; j++) {
-                for (int k = 0; k < numSpheres_per_side; k++) {
-                    // At each point on the cube of traversed values, we create an array of vertices for the probability density sphere at that point
-                    // NOTE: r IS THE DISTANCE OF THE SPHERE FROM THE ORIGIN, sphereRadius IS THE SPHERE RADIUS
-                    GLfloat x = -5.00f + (i * step); // x,y,x is the center of the probability sphere
-                    GLfloat y = -5.00f + (j * step);
-                    GLfloat z = -5.00f + (k * step);
-                    
-                    GLfloat r = r_of(x,y,z);
-                    GLfloat theta = theta_of(x,y,z);
-                    GLfloat phi = phi_of(x,y,z);
-                    
-                    // conversion factor: 0.5 = 1 Bohr radius
-                    GLfloat probDensity = _322_eq(r/0.5f,theta,phi);
-                    
-                    // Conversion factor: step/2 => sphereRadius is maximum (subject to change)
-                    // maximum of the 2s prob density
-                    GLfloat sphereRadius = step/1.5f * probDensity;
-                    GLfloat sphereColor_red = 1.0f * (1-probDensity); // More red = lower prob density
-                    GLfloat sphereColor_green = 1.0f * probDensity;   // More green = higher prob density
-                    GLfloat sphereColor_blue = 0.2f;                        // Blue is constant for now
-                    
-                    //std::cout << "Color : " << (int)(sphereColor_red*255) << " " << (int)(sphereColor_green*255) << " " << (int)(sphereColor_blue*255) << "\n";
-                    
-                    //------------------------------ GENERATE SPHERE -----------------------------------//
-                    //-------------------------------------------------------------------//
-                    //------------ GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    std::vector<GLfloat> sphereVertices;
-                    std::vector<GLfloat> sphereNormals;
-                    std::vector<GLfloat> sphereTexCoords;
-                    
-                    std::vector<GLfloat>().swap(sphereVertices);
-                    std::vector<GLfloat>().swap(sphereNormals);
-                    std::vector<GLfloat>().swap(sphereTexCoords);
-                    GLfloat x_local,y_local,z_local,xy_local;               // vertex position
-                    GLfloat nx, ny, nz, lengthInv = 1.0f / sphereRadius;    // vertex normal
-                    GLfloat s, t;                                           // vertex texCoord
-                    
-                    GLfloat sectorStep = 2 * PI / sectorCount;
-                    GLfloat stackStep = PI / stackCount;
-                    GLfloat sectorAngle, stackAngle;
-                    
-                    for(int i_local = 0; i_local <= stackCount; ++i_local)
-                    {
-                        stackAngle = PI / 2 - i_local * stackStep;        // starting from pi/2 to -pi/2
-                        xy_local = sphereRadius * cosf(stackAngle);             // r * cos(u)
-                        z_local = sphereRadius * sinf(stackAngle);              // r * sin(u)
-                        // add (sectorCount+1) vertices per stack
-                        // first and last vertices have same position and normal, but different tex coords
-                        for(int j_local = 0; j_local <= sectorCount; ++j_local)
-                        {
-                            sectorAngle = j_local * sectorStep;           // starting from 0 to 2pi
-                            
-                            // vertex position with respect to (x, y, z) is (x_local, y_local, z_local)
-                            x_local = xy_local * cosf(sectorAngle);             // r * cos(u) * cos(v)
-                            y_local = xy_local * sinf(sectorAngle);             // r * cos(u) * sin(v)
-                            
-                            sphereVertices.push_back(x_local + x);
-                            sphereVertices.push_back(y_local + y);              // + x,y,z
-                            sphereVertices.push_back(z_local + z);
-                            
-                            // normalized vertex normal (nx, ny, nz)
-                            nx = x_local * lengthInv;
-                            ny = y_local * lengthInv;
-                            nz = z_local * lengthInv;
-                            sphereNormals.push_back(nx);
-                            sphereNormals.push_back(ny);
-                            sphereNormals.push_back(nz);
-                            
-                            // vertex tex coord (s, t) range between [0, 1]
-                            s = (GLfloat)i_local / sectorCount;
-                            t = (GLfloat)i_local / stackCount;
-                            sphereTexCoords.push_back(s);
-                            sphereTexCoords.push_back(t);
-                        }
-                    }
-                    //---------- END GENERATE VERTEX,NORMAL,TEXCOORD VECTORS --------------//
-                    //---------------------------------------------------------------------//
-                    //-------------- GENERATE COMPLETE VERTEX VECTOR ----------------------//
-                    std::vector<GLfloat> completeSphereVertexVec;
-                    int length_completeSphereVertexVec = (int) ((sphereVertices.size() * 11.0)/3);
-                    
-                    int j_a = 0;
-                    for (int i_a = 0; i_a < length_completeSphereVertexVec;) {
-                        // COORDINATES:
-                        for (int k_a = j_a; k_a < j_a+3; k_a++) {
-                            completeSphereVertexVec.push_back(sphereVertices.at(k_a)); i_a++;
-                            //std::cout << sphereVertices.at(k_a) << std::endl;
-                        }
-                        j_a += 3;
-                        // COLORS:
-                        completeSphereVertexVec.push_back(sphereColor_red); i_a++;// RED
-                        completeSphereVertexVec.push_back(sphereColor_green); i_a++; // GREEN
-                        completeSphereVertexVec.push_back(sphereColor_blue); i_a++; // BLUE
-                        // TEXCOORD:
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        completeSphereVertexVec.push_back(0.0f); i_a++; // NO TEXTURE
-                        // NORMALS:
-                        for (int k_a = j_a-3; k_a < j_a; k_a++) {
-                            completeSphereVertexVec.push_back(sphereNormals.at(k_a)); i_a++;
-                        }
-                    }
-                    //------------- END GENERATE COMPLETE VERTEX VECTOR ------------------//
-                    //--------------------------------------------------------------------//
-                    //------- ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec ---------//
-                    allSpheres_VertexVec.push_back(completeSphereVertexVec);
-                    
-                    //----- END ADD COMPLETE VERTEX VECTOR TO allSpheres_VertexVec -------//
-                    //--------------------------------------------------------------------//
-                    //-----------------------------END GENERATE SPHERE ------------------------------//
-                    
-                }
-            }
-        }
-    } else {
-        std::cout << "The quantum numbers entered are not yet supported.\n";
-        return 0;
+        return sphereInstances.data();
+    };
+
+    // numSpheres_per_side^3 spheres on a cube, or with adaptiveSampling only where the density is significant
+    // Add spheres to sphereInstances
+    // each sphere represents the probabiility density at that location
+    // sphereRadius and sphereColor of each sphere based on the probability density of the wavefunction at that point
+    const GLfloat extentBohr = (renderMode == SUPERPOSITION) ? superposition.extentBohr : orbital.extentBohr;
+    std::cout << "Scale factor: axes extend to " << extentBohr << " Bohr (" << extentBohr / 2 << " A).\n";
+    for (const Orbital& compared : comparedOrbitals) {
+        std::cout << "l = " << compared.l << ", |ml| = " << compared.ml << ": axes extend to " << compared.extentBohr << " Bohr (" << compared.extentBohr / 2 << " A).\n";
+    }
+    // GPU_DENSITY evaluates the grid in the vertex shader instead, VOLUME and SUPERPOSITION have their own grids (below)
+    // and ELECTRON_CLOUD has none
+    const SphereInstance* spheres = NULL;
+    // With asyncGeneration the grids are evaluated (or read from the cache) by gridWorker and the render loop picks
+    // them up; until the first one is done no spheres are drawn
+    GridWorker gridWorker(useOrbitalCache ? parentDir + "/Cache" : "");
+    const size_t numGridSpheres = numSpheres;
+    if (asyncGeneration) {
+        gridWorker.Start(orbital, numSpheres_per_side);
+        numSpheres = 0;
+    } else if (renderMode != GPU_DENSITY && renderMode != VOLUME && renderMode != SUPERPOSITION && renderMode != ELECTRON_CLOUD) {
+        CpuScope gridScope(profiler, "Grid evaluation");
+        spheres = loadSpheres();
+    }
+
+    // The isosurfaces are extracted from the grid of the spheres (or of the density volume) once it is evaluated
+    IsosurfaceExtractor isosurfaces;
+    // Names the grid of the current orbital with N points per side in the cache of isosurfaces
+    auto isoGridKey = [&](int N) {
+        return std::to_string(orbital.n) + "_" + std::to_string(orbital.l) + "_" + std::to_string(orbital.ml) + "_" + std::to_string(N);
+    };
+    // Whether the grid of isosurfaces changed since the surfaces were last extracted
+    bool isoGridChanged = false;
+    if (showIsosurfaces && spheres != NULL) {
+        isosurfaces.SetSphereGrid(isoGridKey(numSpheres_per_side), spheres, numSpheres_per_side);
+        isoGridChanged = true;
     }
     //----------------------- END GENERATE TOTAL VERTICES VEC ---------------------------------------//
     //-----------------------------------------------------------------------------------------------//
-    //----------------------- CONVERT TOTAL VERTICES VEC TO ARRAY -----------------------------------//
-
-    GLfloat allSpheres_VertexArr[numSpheres * allSpheres_VertexVec.at(0).size()];
-    int i_arr = 0;
-    for (int i = 0; i < allSpheres_VertexVec.size(); i++) {
-        for (int j = 0; j < allSpheres_VertexVec.at(i).size(); j++) {
-            allSpheres_VertexArr[i_arr++] = allSpheres_VertexVec.at(i).at(j);
+    //----------------------- GENERATE SPHERE MESH --------------------------------------------------//
+    // INSTANCED, GPU_DENSITY, SUPERPOSITION: the mesh is a single unit sphere, scaled and translated per sphere in
+    // instanced.vert (gpuDensity.vert, superposition.vert)
+    // BAKED_MESH: the mesh is every sphere of spheres, with the indices repeated numSpheres times
+    //             (in compactMesh_Vertices with compactVertices)
+    // IMPOSTOR: the mesh is a single quad, placed per sphere in impostor.vert
+    // VOLUME: the mesh is the box around the grid, the rays are marched from its back faces
+    // ELECTRON_CLOUD: no mesh, the points are in electronCloud
+    CpuScope meshScope(profiler, "Sphere mesh generation");
+    std::vector<GLuint> singleSphere_IndicesVec = generateSphereIndices();
+
+    std::vector<GLfloat> sphereMesh_Vertices;
+    std::vector<CompactVertex> compactMesh_Vertices;
+    std::vector<GLuint> sphereMesh_Indices;
+    if (renderMode == IMPOSTOR) {
+        sphereMesh_Vertices.assign(std::begin(impostorQuadVertices), std::end(impostorQuadVertices));
+        sphereMesh_Indices.assign(std::begin(impostorQuadIndices), std::end(impostorQuadIndices));
+    } else if (renderMode == VOLUME) {
+        sphereMesh_Vertices.assign(std::begin(volumeBoxVertices), std::end(volumeBoxVertices));
+        sphereMesh_Indices.assign(std::begin(volumeBoxIndices), std::end(volumeBoxIndices));
+    } else if (renderMode == ELECTRON_CLOUD) {
+        // Nothing, the points are drawn straight from electronCloud
+    } else if (renderMode != BAKED_MESH) {
+        sphereMesh_Vertices = generateUnitSphereVertices();
+        sphereMesh_Indices = singleSphere_IndicesVec;
+    } else {
+        // One allocation holds every sphere; each sphere writes its vertices straight into its own slot
+        if (compactVertices) {
+            compactMesh_Vertices.resize(numSpheres * NUM_VERTICES_PER_SPHERE);
+            writeCompactSphereMeshVertices(spheres, numSpheres, compactMesh_Vertices.data());
+        } else {
+            sphereMesh_Vertices.resize(numSpheres * NUM_VERTICES_PER_SPHERE * NUM_FLOATS_PER_VERTEX);
+            writeSphereMeshVertices(spheres, numSpheres, sphereMesh_Vertices.data());
         }
-    }
-    /*for (int i = 0; i<sizeof(allSpheres_VertexArr)/sizeof(GLfloat); i++) {
-        std::cout << "This is allSpheres_VertexArr: " << allSpheres_VertexArr[i] << "\n";
-    }*/
-
-    //--------------------- END CONVERT TOTAL VERTICES VEC TO ARRAY ----------------------------------//
-    //------------------------------------------------------------------------------------------------//
-    //----------------------- GENERATE SINGLE INDICES ARRAY -------------------------------------------//
-    // Generate CCW index list of sphere triangles
-    // k1--k1+1
-    // |  / |
-    // | /  |
-    // k2--k2+1
-    std::vector<int> singleSphere_IndicesVec;
-    std::vector<int> lineIndices;
-    int k1, k2;
-    for(int i = 0; i < stackCount; ++i)
-    {
-        k1 = i * (sectorCount + 1);     // beginning of current stack
-        k2 = k1 + sectorCount + 1;      // beginning of next stack
-
-        for(int j = 0; j < sectorCount; ++j, ++k1, ++k2)
-        {
-            // 2 triangles per sector excluding first and last stacks
-            // k1 => k2 => k1+1
-            if(i != 0)
-            {
-                singleSphere_IndicesVec.push_back(k1);
-                singleSphere_IndicesVec.push_back(k2);
-                singleSphere_IndicesVec.push_back(k1 + 1);
-            }
-
-            // k1+1 => k2 => k2+1
-            if(i != (stackCount-1))
-            {
-                singleSphere_IndicesVec.push_back(k1 + 1);
-                singleSphere_IndicesVec.push_back(k2);
-                singleSphere_IndicesVec.push_back(k2 + 1);
-            }
 
-            // store indices for lines
-            // vertical lines for all stacks, k1 => k2
-            lineIndices.push_back(k1);
-            lineIndices.push_back(k2);
-            if(i != 0)  // horizontal lines except 1st stack, k1 => k+1
-            {
-                lineIndices.push_back(k1);
-                lineIndices.push_back(k1 + 1);
-            }
-        }
-    }
-    //--------------------- END GENERATE SINGLE INDICES ARRAY ----------------------------------------//
-    //------------------------------------------------------------------------------------------------//
-    //----------------------- GENERATE TOTAL INDICES ARRAY -------------------------------------------//
-    // Create a total indices ARRAY by adding numSpheres number of single sphere indices vectors
-    // Length is numSpheres * length of a single sphere indices vector
-    GLuint allSpheres_IndicesArr[numSpheres * singleSphere_IndicesVec.size()];
-    for (int i = 0; i < sizeof(allSpheres_IndicesArr) / sizeof(GLuint); i++) {
-        int mod_i = i % singleSphere_IndicesVec.size();
-        int n = i / singleSphere_IndicesVec.size();
-        allSpheres_IndicesArr[i] = singleSphere_IndicesVec.at(mod_i) + NUM_VERTICES_PER_SPHERE * n;
+        // Create a total indices vector by adding numSpheres number of single sphere indices vectors
+        // Length is numSpheres * length of a single sphere indices vector
+        sphereMesh_Indices.resize(numSpheres * singleSphere_IndicesVec.size());
+        writeSphereMeshIndices(singleSphere_IndicesVec, numSpheres, sphereMesh_Indices.data());
     }
-    /*std::cout << "Length of singleSphere_IndicesArr: " << singleSphere_IndicesVec.size() << std::endl;
-
-    std::cout << "Length of allSpheres_IndicesArr: " << sizeof(allSpheres_IndicesArr)/sizeof(GLuint) << std::endl;
-    std::cout << "This is the length of singleSphere_VertexArr: " <<  sizeof(singleSphere_VertexArr)/sizeof(GLfloat) << std::endl;
-    std::cout << "This is the length of allSpheres_VertexArr: " <<  sizeof(allSpheres_VertexArr)/sizeof(GLfloat) << std::endl;*/
-
-    //---------------------- END GENERATE TOTAL INDICES ARRAY ----------------------------------------//
+    meshScope.End();
+    //---------------------- END GENERATE SPHERE MESH ------------------------------------------------//
     //------------------------------------------------------------------------------------------------//
     //-------------------- END MULTIPLE SPHERES ---------------------------------------------------------//
     //---------------------------------------------------------------------------------------------------//
@@ -1648,82 +691,207 @@ int main()
     std::string frag_path = parentDir + "/Debug/default.frag";
 
     Shader shaderProgram(vert_path, frag_path);
+    // The sphere programs are only built (compiled or loaded from the program cache) for the render settings that
+    // draw with them, the others stay empty Shaders (ID 0) that are never used
+    auto modeShader = [](bool needed, const std::string& vertexFile, const std::string& fragmentFile) {
+        return needed ? Shader(vertexFile, fragmentFile) : Shader();
+    };
+    // The spheres are shaded by oit.frag instead of default.frag when they are translucent
+    std::string sphere_frag_path = translucentSpheres ? parentDir + "/Debug/oit.frag" : frag_path;
+    // Generates Shader object for the baked spheres using shaders default.vert (compact.vert with compactVertices)
+    std::string compact_vert_path = parentDir + "/Debug/compact.vert";
+
+    Shader bakedShader = modeShader(renderMode == BAKED_MESH, compactVertices ? compact_vert_path : vert_path, sphere_frag_path);
+    // Generates Shader object for the instanced spheres using shaders instanced.vert and default.frag
+    std::string instanced_vert_path = parentDir + "/Debug/instanced.vert";
+
+    Shader instancedShader = modeShader(renderMode == INSTANCED, instanced_vert_path, sphere_frag_path);
+    // Generates Shader object for the ray cast spheres using shaders impostor.vert and impostor.frag
+    std::string impostor_vert_path = parentDir + "/Debug/impostor.vert";
+    std::string impostor_frag_path = parentDir + "/Debug/impostor.frag";
+
+    Shader impostorShader = modeShader(renderMode == IMPOSTOR, impostor_vert_path, impostor_frag_path);
+    // Generates Shader object for the GPU evaluated spheres using shaders gpuDensity.vert and default.frag
+    std::string gpuDensity_vert_path = parentDir + "/Debug/gpuDensity.vert";
+
+    Shader gpuDensityShader = modeShader(renderMode == GPU_DENSITY, gpuDensity_vert_path, sphere_frag_path);
+    if (renderMode == GPU_DENSITY) {
+        setDensityUniforms(gpuDensityShader, orbital, numSpheres_per_side);
+    }
+    // Generates Shader object for the density volume using shaders volume.vert and volume.frag
+    std::string volume_vert_path = parentDir + "/Debug/volume.vert";
+    std::string volume_frag_path = parentDir + "/Debug/volume.frag";
+
+    Shader volumeShader = modeShader(renderMode == VOLUME, volume_vert_path, volume_frag_path);
+    if (renderMode == VOLUME) {
+        volumeShader.Activate();
+        glUniform1i(volumeShader.Uniform("volumeSize"), numSpheres_per_side);
+        glUniform1f(volumeShader.Uniform("gridHalfExtent"), GRID_HALF_EXTENT);
+        // About 2 samples per grid point along the diagonal of the box
+        glUniform1i(volumeShader.Uniform("numSteps"), (int)(2 * sqrt(3.0f) * numSpheres_per_side));
+        glUniform1f(volumeShader.Uniform("opacityScale"), 2.0f);
+    }
+    // Generates Shader object for the superposition spheres using shaders superposition.vert and default.frag
+    std::string superposition_vert_path = parentDir + "/Debug/superposition.vert";
+
+    Shader superpositionShader = modeShader(renderMode == SUPERPOSITION, superposition_vert_path, sphere_frag_path);
+    // Generates Shader object that blends the translucent spheres over the rest using shaders oitComposite.vert and oitComposite.frag
+    std::string oitComposite_vert_path = parentDir + "/Debug/oitComposite.vert";
+    std::string oitComposite_frag_path = parentDir + "/Debug/oitComposite.frag";
+
+    Shader oitCompositeShader = modeShader(translucentSpheres, oitComposite_vert_path, oitComposite_frag_path);
+    // Generates Shader object for the electron positions using shaders electron.vert and electron.frag
+    std::string electron_vert_path = parentDir + "/Debug/electron.vert";
+    std::string electron_frag_path = parentDir + "/Debug/electron.frag";
+
+    Shader electronShader = modeShader(renderMode == ELECTRON_CLOUD, electron_vert_path, electron_frag_path);
     
-    // ----- FOR X AXIS -------- //
-    // Generates Vertex Array Object and binds it
-    VAO VAO1;
-    VAO1.Bind();
-    // Generates Vertex Buffer Object and links it to vertices
-    VBO VBO1(xAxisVertices, sizeof(xAxisVertices));
-    // Generates Element Buffer Object and links it to indices
-    EBO EBO1(xAxisIndices, sizeof(xAxisIndices));
-    // Links VBO attributes such as coordinates and colors to VAO
-    VAO1.LinkAttrib(VBO1, 0, 3, GL_FLOAT, 11 * sizeof(float), (void*)0);
-    VAO1.LinkAttrib(VBO1, 1, 3, GL_FLOAT, 11 * sizeof(float), (void*)(3 * sizeof(float)));
-    VAO1.LinkAttrib(VBO1, 2, 2, GL_FLOAT, 11 * sizeof(float), (void*)(6 * sizeof(float)));
-    VAO1.LinkAttrib(VBO1, 3, 3, GL_FLOAT, 11 * sizeof(float), (void*)(8 * sizeof(float)));
-    // Unbind all to prevent accidentally modifying them
-    VAO1.Unbind();
-    VBO1.Unbind();
-    EBO1.Unbind();
-    
-    // ----- FOR Y AXIS ------- //
-    // Generates Vertex Array Object and binds it
-    VAO VAO2;
-    VAO2.Bind();
-    // Generates Vertex Buffer Object and links it to vertices
-    VBO VBO2(yAxisVertices, sizeof(yAxisVertices));
-    // Generates Element Buffer Object and links it to indices
-    EBO EBO2(yAxisIndices, sizeof(yAxisIndices));
-    // Links VBO attributes such as coordinates and colors to VAO
-    VAO2.LinkAttrib(VBO2, 0, 3, GL_FLOAT, 11 * sizeof(float), (void*)0);
-    VAO2.LinkAttrib(VBO2, 1, 3, GL_FLOAT, 11 * sizeof(float), (void*)(3 * sizeof(float)));
-    VAO2.LinkAttrib(VBO2, 2, 2, GL_FLOAT, 11 * sizeof(float), (void*)(6 * sizeof(float)));
-    VAO2.LinkAttrib(VBO2, 3, 3, GL_FLOAT, 11 * sizeof(float), (void*)(8 * sizeof(float)));
-    // Unbind all to prevent accidentally modifying them
-    VAO2.Unbind();
-    VBO2.Unbind();
-    EBO2.Unbind();
-    
-    // ----- FOR Z AXIS -------- //
+    // ----- FOR AXES -------- //
+    // The three axes share one vertex layout, so they are one mesh: their vertices back to back and their indices
+    // offset to match, drawn with a single draw call
+    std::vector<GLfloat> axesVertices;
+    std::vector<GLuint> axesIndices;
+    auto appendAxis = [&](const GLfloat* vertices, size_t numFloats, const GLuint* indices, size_t numIndices) {
+        const GLuint firstVertex = (GLuint)(axesVertices.size() / 11);
+        axesVertices.insert(axesVertices.end(), vertices, vertices + numFloats);
+        for (size_t i = 0; i < numIndices; i++) {
+            axesIndices.push_back(firstVertex + indices[i]);
+        }
+    };
+    appendAxis(xAxisVertices, std::size(xAxisVertices), xAxisIndices, std::size(xAxisIndices));
+    appendAxis(yAxisVertices, std::size(yAxisVertices), yAxisIndices, std::size(yAxisIndices));
+    appendAxis(zAxisVertices, std::size(zAxisVertices), zAxisIndices, std::size(zAxisIndices));
     // Generates Vertex Array Object and binds it
-    VAO VAO3;
-    VAO3.Bind();
+    VAO axesVAO;
+    axesVAO.Bind();
     // Generates Vertex Buffer Object and links it to vertices
-    VBO VBO3(zAxisVertices, sizeof(zAxisVertices));
+    VBO axesVBO(axesVertices.data(), axesVertices.size() * sizeof(GLfloat));
     // Generates Element Buffer Object and links it to indices
-    EBO EBO3(zAxisIndices, sizeof(zAxisIndices));
+    EBO axesEBO(axesIndices.data(), axesIndices.size() * sizeof(GLuint));
     // Links VBO attributes such as coordinates and colors to VAO
-    VAO3.LinkAttrib(VBO3, 0, 3, GL_FLOAT, 11 * sizeof(float), (void*)0);
-    VAO3.LinkAttrib(VBO3, 1, 3, GL_FLOAT, 11 * sizeof(float), (void*)(3 * sizeof(float)));
-    VAO3.LinkAttrib(VBO3, 2, 2, GL_FLOAT, 11 * sizeof(float), (void*)(6 * sizeof(float)));
-    VAO3.LinkAttrib(VBO3, 3, 3, GL_FLOAT, 11 * sizeof(float), (void*)(8 * sizeof(float)));
+    axesVAO.LinkAttrib(axesVBO, 0, 3, GL_FLOAT, 11 * sizeof(float), (void*)0);
+    axesVAO.LinkAttrib(axesVBO, 1, 3, GL_FLOAT, 11 * sizeof(float), (void*)(3 * sizeof(float)));
+    axesVAO.LinkAttrib(axesVBO, 2, 2, GL_FLOAT, 11 * sizeof(float), (void*)(6 * sizeof(float)));
+    axesVAO.LinkAttrib(axesVBO, 3, 3, GL_FLOAT, 11 * sizeof(float), (void*)(8 * sizeof(float)));
     // Unbind all to prevent accidentally modifying them
-    VAO3.Unbind();
-    VBO3.Unbind();
-    EBO3.Unbind();
+    axesVAO.Unbind();
+    axesVBO.Unbind();
+    axesEBO.Unbind();
     
     // ----- FOR SPHERES -------- //
+    // Everything up to the end of the sphere chunks is the upload of the spheres
+    CpuScope uploadScope(profiler, "Sphere upload");
     // Generates Vertex Array Object and binds it
     VAO VAO4;
     VAO4.Bind();
     // Generates Vertex Buffer Object and links it to vertices
-    VBO VBO4(allSpheres_VertexArr, sizeof(allSpheres_VertexArr));
+    VBO VBO4(compactVertices ? (GLfloat*)compactMesh_Vertices.data() : sphereMesh_Vertices.data(),
+             compactVertices ? compactMesh_Vertices.size() * sizeof(CompactVertex) : sphereMesh_Vertices.size() * sizeof(GLfloat));
     // Generates Element Buffer Object and links it to indices
-    EBO EBO4(allSpheres_IndicesArr, sizeof(allSpheres_IndicesArr));
+    EBO EBO4(sphereMesh_Indices.data(), sphereMesh_Indices.size() * sizeof(GLuint));
+    // Generates Vertex Buffer Object and links it to the per-sphere centers, radii and colors
+    // (straight from the cache mapping when the grid was cached, nothing in GPU_DENSITY mode or with useSphereLODs)
+    // With frustumCulling it only holds the visible chunks of sphereChunks (filled below)
+    const bool usesInstanceVBO = (renderMode == INSTANCED && !useSphereLODs) || renderMode == IMPOSTOR;
+    const bool usesSphereChunks = usesInstanceVBO && frustumCulling;
+    // With asyncGeneration it has room for the requested grid followed by the coarse one, filled slab by slab
+    const size_t instanceCapacity = asyncGeneration ? numGridSpheres + COARSE_SPHERES_PER_SIDE * COARSE_SPHERES_PER_SIDE * COARSE_SPHERES_PER_SIDE : numSpheres;
+    VBO instanceVBO((GLfloat*)spheres, (usesInstanceVBO && !usesSphereChunks) ? instanceCapacity * sizeof(SphereInstance) : 0);
+    // Generates Vertex Buffer Object and links it to the per-sphere centers and cached psi_s (only in SUPERPOSITION mode)
+    // It never changes, the animation only changes the phases uniform of superposition.vert
+    std::vector<SuperpositionInstance> superpositionInstances;
+    if (renderMode == SUPERPOSITION) {
+        CpuScope superpositionScope(profiler, "Superposition evaluation");
+        evaluateSuperposition(superposition, numSpheres_per_side, superpositionInstances);
+    }
+    VBO superpositionVBO((GLfloat*)superpositionInstances.data(), superpositionInstances.size() * sizeof(SuperpositionInstance));
     // Links VBO attributes such as coordinates and colors to VAO
-    VAO4.LinkAttrib(VBO4, 0, 3, GL_FLOAT, 11 * sizeof(float), (void*)0);
-    VAO4.LinkAttrib(VBO4, 1, 3, GL_FLOAT, 11 * sizeof(float), (void*)(3 * sizeof(float)));
-    VAO4.LinkAttrib(VBO4, 2, 2, GL_FLOAT, 11 * sizeof(float), (void*)(6 * sizeof(float)));
-    VAO4.LinkAttrib(VBO4, 3, 3, GL_FLOAT, 11 * sizeof(float), (void*)(8 * sizeof(float)));
+    if (renderMode == INSTANCED) {
+        // Unit sphere coordinates (also used as normals)
+        VAO4.LinkAttrib(VBO4, 0, 3, GL_FLOAT, 3 * sizeof(float), (void*)0);
+        // Per-sphere color and center + radius, advanced once per instance instead of once per vertex
+        VAO4.LinkAttrib(instanceVBO, 1, 3, GL_FLOAT, sizeof(SphereInstance), (void*)offsetof(SphereInstance, red), 1);
+        VAO4.LinkAttrib(instanceVBO, 4, 4, GL_FLOAT, sizeof(SphereInstance), (void*)offsetof(SphereInstance, x), 1);
+    } else if (renderMode == GPU_DENSITY) {
+        // Unit sphere coordinates (also used as normals); everything per sphere comes from gl_InstanceID
+        VAO4.LinkAttrib(VBO4, 0, 3, GL_FLOAT, 3 * sizeof(float), (void*)0);
+    } else if (renderMode == IMPOSTOR) {
+        // Quad corners
+        VAO4.LinkAttrib(VBO4, 0, 2, GL_FLOAT, 2 * sizeof(float), (void*)0);
+        // Per-sphere color and center + radius, advanced once per instance instead of once per vertex
+        VAO4.LinkAttrib(instanceVBO, 1, 3, GL_FLOAT, sizeof(SphereInstance), (void*)offsetof(SphereInstance, red), 1);
+        VAO4.LinkAttrib(instanceVBO, 4, 4, GL_FLOAT, sizeof(SphereInstance), (void*)offsetof(SphereInstance, x), 1);
+    } else if (renderMode == VOLUME) {
+        // Box corners
+        VAO4.LinkAttrib(VBO4, 0, 3, GL_FLOAT, 3 * sizeof(float), (void*)0);
+    } else if (renderMode == SUPERPOSITION) {
+        // Unit sphere coordinates (also used as normals)
+        VAO4.LinkAttrib(VBO4, 0, 3, GL_FLOAT, 3 * sizeof(float), (void*)0);
+        // Per-sphere center and psi_s of states 0 and 1 and of states 2 and 3, advanced once per instance
+        VAO4.LinkAttrib(superpositionVBO, 4, 4, GL_FLOAT, sizeof(SuperpositionInstance), (void*)offsetof(SuperpositionInstance, x), 1);
+        VAO4.LinkAttrib(superpositionVBO, 5, 4, GL_FLOAT, sizeof(SuperpositionInstance), (void*)offsetof(SuperpositionInstance, psi), 1);
+        VAO4.LinkAttrib(superpositionVBO, 6, 4, GL_FLOAT, sizeof(SuperpositionInstance), (void*)(offsetof(SuperpositionInstance, psi) + 4 * sizeof(GLfloat)), 1);
+    } else if (renderMode == ELECTRON_CLOUD) {
+        // Nothing, electronCloud has its own VAO
+    } else if (compactVertices) {
+        // Quantized coordinates, colors and normals, read as floats by normalizing them
+        VAO4.LinkAttrib(VBO4, 0, 3, GL_SHORT, sizeof(CompactVertex), (void*)offsetof(CompactVertex, x), 0, GL_TRUE);
+        VAO4.LinkAttrib(VBO4, 1, 4, GL_UNSIGNED_BYTE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, color), 0, GL_TRUE);
+        VAO4.LinkAttrib(VBO4, 3, 2, GL_BYTE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, normal), 0, GL_TRUE);
+    } else {
+        VAO4.LinkAttrib(VBO4, 0, 3, GL_FLOAT, 11 * sizeof(float), (void*)0);
+        VAO4.LinkAttrib(VBO4, 1, 3, GL_FLOAT, 11 * sizeof(float), (void*)(3 * sizeof(float)));
+        VAO4.LinkAttrib(VBO4, 2, 2, GL_FLOAT, 11 * sizeof(float), (void*)(6 * sizeof(float)));
+        VAO4.LinkAttrib(VBO4, 3, 3, GL_FLOAT, 11 * sizeof(float), (void*)(8 * sizeof(float)));
+    }
     // Unbind all to prevent accidentally modifying them
     VAO4.Unbind();
     VBO4.Unbind();
     EBO4.Unbind();
+    // Points the per-sphere attributes of VAO4 at the spheres starting at offset bytes into instanceVBO
+    // (the level of gridWorker that is drawn)
+    auto linkInstanceAttribs = [&](GLintptr offset) {
+        VAO4.Bind();
+        VAO4.LinkAttrib(instanceVBO, 1, 3, GL_FLOAT, sizeof(SphereInstance), (void*)(offset + offsetof(SphereInstance, red)), 1);
+        VAO4.LinkAttrib(instanceVBO, 4, 4, GL_FLOAT, sizeof(SphereInstance), (void*)(offset + offsetof(SphereInstance, x)), 1);
+        VAO4.Unbind();
+    };
+
+    // ----- SPHERE CHUNKS -------- //
+    // Spheres grouped by chunk on the GPU; the chunks inside the view are copied to instanceVBO when the camera moves
+    SphereChunks sphereChunks;
+    if (usesSphereChunks) {
+        sphereChunks.Build(spheres, numSpheres, instanceVBO);
+    }
+    // The spheres are on the GPU now
+    orbitalCache.Unmap();
+    uploadScope.End();
+
+    // ----- DENSITY VOLUME -------- //
+    // Relative densities of every grid point, x fastest (only in VOLUME mode, uploaded to volumeTex below)
+    std::vector<GLfloat> densityVolume;
+    if (renderMode == VOLUME) {
+        CpuScope volumeScope(profiler, "Density volume evaluation");
+        densityVolume.resize(numSpheres);
+        evaluateDensityVolume(orbital, numSpheres_per_side, densityVolume.data());
+        if (showIsosurfaces) {
+            isosurfaces.SetVolumeGrid(isoGridKey(numSpheres_per_side), densityVolume.data(), numSpheres_per_side);
+            isoGridChanged = true;
+        }
+    }
+
+    // ----- SPHERE LEVELS OF DETAIL -------- //
+    // Unit spheres of every level of detail, with their own instance buffer that is refilled when the camera moves
+    SphereLODs sphereLODs;
+    sphereLODs.frustumCulling = frustumCulling;
+    // Whether sphereLODs has to regroup the spheres even if the camera did not move
+    bool spheresChanged = true;
+    // Spheres of the requested grid of gridWorker that replaced its coarse grid so far (at the front of sphereInstances)
+    size_t refinedSpheres = 0;
     
     // ------------ LIGHT --------------- //
     // Shader for light cube
-    Shader lightShader("/Users/chrisgudmundsen/Desktop/Coding Projects/Orbital Simulation/Shaders/light.vert", "/Users/chrisgudmundsen/Desktop/Coding Projects/Orbital Simulation/Shaders/light.frag");
+    Shader lightShader(parentDir + "/Debug/light.vert", parentDir + "/Debug/light.frag");
     // Generates Vertex Array Object and binds it
     VAO lightVAO;
     lightVAO.Bind();
@@ -1738,6 +906,69 @@ int main()
     lightVBO.Unbind();
     lightEBO.Unbind();
 
+    // ------------ ISOSURFACES --------------- //
+    // Generates Shader object for the isosurfaces using shaders isosurface.vert and isosurface.frag
+    std::string isosurface_vert_path = parentDir + "/Debug/isosurface.vert";
+    std::string isosurface_frag_path = parentDir + "/Debug/isosurface.frag";
+
+    Shader isosurfaceShader = modeShader(showIsosurfaces, isosurface_vert_path, isosurface_frag_path);
+    // Generates Vertex Array Object and binds it
+    VAO isoVAO;
+    isoVAO.Bind();
+    // Generates Vertex Buffer Object for the triangles of every level, one level after the other (filled below)
+    VBO isoVBO(NULL, 0);
+    // Links VBO attributes such as coordinates and normals to VAO
+    isoVAO.LinkAttrib(isoVBO, 0, 3, GL_FLOAT, sizeof(IsosurfaceVertex), (void*)offsetof(IsosurfaceVertex, x));
+    isoVAO.LinkAttrib(isoVBO, 3, 3, GL_FLOAT, sizeof(IsosurfaceVertex), (void*)offsetof(IsosurfaceVertex, nx));
+    // Unbind all to prevent accidentally modifying them
+    isoVAO.Unbind();
+    isoVBO.Unbind();
+    // Changes isoLevels from the keyboard
+    IsoLevelSelector isoLevelSelector(isoLevels);
+    // First vertex and number of vertices of every level in isoVBO
+    std::vector<GLint> isoFirsts;
+    std::vector<GLsizei> isoCounts;
+    // Extracts the surfaces of every level from the current grid (or takes them from the cache) and uploads them
+    std::vector<IsosurfaceVertex> isoVertices;
+    auto updateIsosurfaces = [&]() {
+        CpuScope isoScope(profiler, "Isosurface extraction");
+        isoVertices.clear();
+        isoFirsts.clear();
+        isoCounts.clear();
+        std::cout << "Isosurfaces:";
+        for (GLfloat level : isoLevelSelector.levels) {
+            const std::vector<IsosurfaceVertex>& surface = isosurfaces.Extract(level);
+            isoFirsts.push_back((GLint)isoVertices.size());
+            isoCounts.push_back((GLsizei)surface.size());
+            isoVertices.insert(isoVertices.end(), surface.begin(), surface.end());
+            std::cout << " " << level << " (" << surface.size() / 3 << " triangles" << (isosurfaces.lastWasCached ? ", cached)" : ")");
+        }
+        std::cout << "\n";
+        isoVBO.Resize((const GLfloat*)isoVertices.data(), isoVertices.size() * sizeof(IsosurfaceVertex));
+        isoVBO.Unbind();
+    };
+    // Draws every level over what is already drawn, blended and without hiding what is behind it
+    auto drawIsosurfaces = [&](Camera& camera) {
+        profiler.BeginGpu("isosurfaces");
+        isosurfaceShader.Activate();
+        glUniform3f(isosurfaceShader.Uniform("camPos"), camera.Position.x, camera.Position.y, camera.Position.z);
+        camera.Matrix(isosurfaceShader, "camMatrix");
+        isoVAO.Bind();
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthMask(GL_FALSE);
+        for (size_t level = 0; level < isoCounts.size(); level++) {
+            // Same colors as spheres of the density of the level
+            const GLfloat density = isoLevelSelector.levels[level];
+            glUniform4f(isosurfaceShader.Uniform("surfaceColor"), 1.0f - density, density, 0.2f, isosurfaceOpacity);
+            glDrawArrays(GL_TRIANGLES, isoFirsts[level], isoCounts[level]);
+            profiler.CountDraw(1, isoCounts[level] / 3);
+        }
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+        profiler.EndGpu();
+    };
+
     glm::vec4 lightColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
     glm::vec3 lightPos = glm::vec3(5.0f, 5.0f, 5.0f);
     glm::mat4 lightModel = glm::mat4(1.0f);
@@ -1748,12 +979,64 @@ int main()
     pyramidModel = glm::translate(pyramidModel, pyramidPos);
 
     lightShader.Activate();
-    glUniformMatrix4fv(glGetUniformLocation(lightShader.ID, "model"), 1, GL_FALSE, glm::value_ptr(lightModel));
-    glUniform4f(glGetUniformLocation(lightShader.ID, "lightColor"), lightColor.x, lightColor.y, lightColor.z, lightColor.w);
+    glUniformMatrix4fv(lightShader.Uniform("model"), 1, GL_FALSE, glm::value_ptr(lightModel));
+    glUniform4f(lightShader.Uniform("lightColor"), lightColor.x, lightColor.y, lightColor.z, lightColor.w);
     shaderProgram.Activate();
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram.ID, "model"), 1, GL_FALSE, glm::value_ptr(pyramidModel));
-    glUniform4f(glGetUniformLocation(shaderProgram.ID, "lightColor"), lightColor.x, lightColor.y, lightColor.z, lightColor.w);
-    glUniform3f(glGetUniformLocation(shaderProgram.ID, "lightPos"), lightPos.x, lightPos.y, lightPos.z);
+    glUniformMatrix4fv(shaderProgram.Uniform("model"), 1, GL_FALSE, glm::value_ptr(pyramidModel));
+    glUniform4f(shaderProgram.Uniform("lightColor"), lightColor.x, lightColor.y, lightColor.z, lightColor.w);
+    glUniform3f(shaderProgram.Uniform("lightPos"), lightPos.x, lightPos.y, lightPos.z);
+    // Only the programs that were built
+    if (renderMode == BAKED_MESH) {
+        bakedShader.Activate();
+        glUniformMatrix4fv(bakedShader.Uniform("model"), 1, GL_FALSE, glm::value_ptr(pyramidModel));
+        glUniform4f(bakedShader.Uniform("lightColor"), lightColor.x, lightColor.y, lightColor.z, lightColor.w);
+        glUniform3f(bakedShader.Uniform("lightPos"), lightPos.x, lightPos.y, lightPos.z);
+        glUniform1f(bakedShader.Uniform("positionScale"), COMPACT_POSITION_SCALE);
+        glUniform1f(bakedShader.Uniform("opacity"), sphereOpacity);
+    }
+    if (renderMode == INSTANCED) {
+        instancedShader.Activate();
+        glUniformMatrix4fv(instancedShader.Uniform("model"), 1, GL_FALSE, glm::value_ptr(pyramidModel));
+        glUniform4f(instancedShader.Uniform("lightColor"), lightColor.x, lightColor.y, lightColor.z, lightColor.w);
+        glUniform3f(instancedShader.Uniform("lightPos"), lightPos.x, lightPos.y, lightPos.z);
+        glUniform1f(instancedShader.Uniform("opacity"), sphereOpacity);
+    }
+    if (renderMode == IMPOSTOR) {
+        impostorShader.Activate();
+        glUniformMatrix4fv(impostorShader.Uniform("model"), 1, GL_FALSE, glm::value_ptr(pyramidModel));
+        glUniform4f(impostorShader.Uniform("lightColor"), lightColor.x, lightColor.y, lightColor.z, lightColor.w);
+        glUniform3f(impostorShader.Uniform("lightPos"), lightPos.x, lightPos.y, lightPos.z);
+    }
+    if (renderMode == GPU_DENSITY) {
+        gpuDensityShader.Activate();
+        glUniformMatrix4fv(gpuDensityShader.Uniform("model"), 1, GL_FALSE, glm::value_ptr(pyramidModel));
+        glUniform4f(gpuDensityShader.Uniform("lightColor"), lightColor.x, lightColor.y, lightColor.z, lightColor.w);
+        glUniform3f(gpuDensityShader.Uniform("lightPos"), lightPos.x, lightPos.y, lightPos.z);
+        glUniform1f(gpuDensityShader.Uniform("opacity"), sphereOpacity);
+    }
+    if (renderMode == SUPERPOSITION) {
+        superpositionShader.Activate();
+        glUniformMatrix4fv(superpositionShader.Uniform("model"), 1, GL_FALSE, glm::value_ptr(pyramidModel));
+        glUniform4f(superpositionShader.Uniform("lightColor"), lightColor.x, lightColor.y, lightColor.z, lightColor.w);
+        glUniform3f(superpositionShader.Uniform("lightPos"), lightPos.x, lightPos.y, lightPos.z);
+        // Same maximum radius as setSphereDensity
+        glUniform1f(superpositionShader.Uniform("maxRadius"), 2 * GRID_HALF_EXTENT / (numSpheres_per_side - 1) / 1.5f);
+        glUniform1f(superpositionShader.Uniform("peakDensity"), superposition.peakDensity);
+        glUniform1f(superpositionShader.Uniform("opacity"), sphereOpacity);
+    }
+    if (renderMode == ELECTRON_CLOUD) {
+        electronShader.Activate();
+        glUniformMatrix4fv(electronShader.Uniform("model"), 1, GL_FALSE, glm::value_ptr(pyramidModel));
+        glUniform1f(electronShader.Uniform("positionScale"), COMPACT_POSITION_SCALE);
+        // The light color dimmed to what a single electron position adds
+        glUniform3f(electronShader.Uniform("electronColor"), 0.4f * electronBrightness, 0.7f * electronBrightness, electronBrightness);
+    }
+    if (showIsosurfaces) {
+        isosurfaceShader.Activate();
+        glUniformMatrix4fv(isosurfaceShader.Uniform("model"), 1, GL_FALSE, glm::value_ptr(pyramidModel));
+        glUniform4f(isosurfaceShader.Uniform("lightColor"), lightColor.x, lightColor.y, lightColor.z, lightColor.w);
+        glUniform3f(isosurfaceShader.Uniform("lightPos"), lightPos.x, lightPos.y, lightPos.z);
+    }
     // ------------ END LIGHT -----------------------//
     
     // ------------ TEXTURE -----------------------//
@@ -1763,20 +1046,61 @@ int main()
      */
         
     /* ANOTHER NOTE: Yes, brick.png is in the debug folder. Yes, the reason is because I suck at programming. */
-    std::string texPath = parentDir + "/Debug/brick.png";
-
-    Texture brickTex(texPath, GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    /* (It is created right after the window, so that it decodes while the grid is evaluated.) */
     brickTex.texUnit(shaderProgram, "tex0", 0);
+    // (and the sphere program of renderMode)
+    Shader& sphereShader = (renderMode == BAKED_MESH) ? bakedShader : (renderMode == INSTANCED) ? instancedShader
+                         : (renderMode == GPU_DENSITY) ? gpuDensityShader : (renderMode == IMPOSTOR) ? impostorShader
+                         : superpositionShader;
+    if (sphereShader.ID != 0) {
+        brickTex.texUnit(sphereShader, "tex0", 0);
+    }
+
+    // The density grid of VOLUME mode on texture unit 1 (empty in the other modes)
+    const GLsizei volumeSize = (renderMode == VOLUME) ? numSpheres_per_side : 0;
+    Texture volumeTex(densityVolume.data(), volumeSize, volumeSize, volumeSize, GL_TEXTURE1);
+    if (renderMode == VOLUME) {
+        volumeTex.texUnit(volumeShader, "volume", 1);
+    }
     // ------------ END TEXTURE --------------------//
 
     // Enables the Depth Buffer
     glEnable(GL_DEPTH_TEST);
+    // Offscreen targets of the translucent spheres (only with translucentSpheres)
+    OITBuffer oitBuffer(translucentSpheres ? WIDTH : 1, translucentSpheres ? HEIGHT : 1);
     // Creates camera object
-    Camera camera(WIDTH, HEIGHT, glm::vec3(0.0f, 0.0f, 6.0f));
+    Camera camera(WIDTH, HEIGHT, glm::vec3(0.0f, 0.0f, compareShell ? comparisonCameraDistance(n, FOV) : 6.0f));
+    // Far enough to see the far side of every orbital from the starting point of the camera
+    const float farPlane = compareShell ? 2 * comparisonCameraDistance(n, FOV) : 100.0f;
+    // Centers of the axes: the origin, or every orbital of the shell with compareShell
+    std::vector<glm::vec3> axesOffsets(1, glm::vec3(0.0f));
+    if (compareShell) {
+        axesOffsets.clear();
+        for (const Orbital& compared : comparedOrbitals) {
+            axesOffsets.push_back(comparisonOffset(compared, n));
+        }
+    }
+    // Electron positions of ELECTRON_CLOUD mode (an empty buffer in the other modes)
+    ElectronCloud electronCloud(renderMode == ELECTRON_CLOUD ? MAX_ELECTRONS : 0);
+    if (renderMode == ELECTRON_CLOUD) {
+        electronCloud.SetOrbital(orbital);
+    }
+    // Sorts the opaque draws of every frame by state
+    RenderQueue renderQueue;
+    // Creates the orbital hotkeys, starting from the quantum numbers that were entered
+    OrbitalSelector orbitalSelector(n, l, ml);
+
+    // Uploads the brick texture before the first frame, since every sphere shader samples texture unit 0
+    brickTex.Bind();
 
     // Main while loop
     while (!glfwWindowShouldClose(window))
     {
+        profiler.BeginFrame();
+        // With translucentSpheres everything opaque is drawn offscreen first
+        if (translucentSpheres) {
+            oitBuffer.BeginOpaque();
+        }
         // Specify the color of the background
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
         // Clean the back buffer and depth buffer
@@ -1784,87 +1108,356 @@ int main()
 
         // Handles camera inputs
         camera.Inputs(window);
+
+        // Handles orbital inputs; only the sphere data is regenerated and the existing buffers are overwritten in place
+        // (they are only reallocated when adaptiveSampling changes the number of spheres)
+        // (SUPERPOSITION mode always shows superposedStates and compareShell the whole shell)
+        if (renderMode != SUPERPOSITION && !compareShell && orbitalSelector.Inputs(window)) {
+            n = orbitalSelector.n;
+            l = orbitalSelector.l;
+            ml = orbitalSelector.ml;
+            orbital = findOrbital(n, l, ml);
+            title = "Hydrogen Atom Sim - n = " + std::to_string(n) + ", l = " + std::to_string(l) + ", ml = " + std::to_string(ml);
+            glfwSetWindowTitle(window, title.c_str());
+            std::cout << "n = " << n << ", l = " << l << ", ml = " << ml << ". Scale factor: axes extend to " << orbital.extentBohr << " Bohr (" << orbital.extentBohr / 2 << " A).\n";
+            // Evaluation and upload of the new orbital
+            CpuScope switchScope(profiler, "Orbital switch");
+
+            if (renderMode == GPU_DENSITY) {
+                setDensityUniforms(gpuDensityShader, orbital, numSpheres_per_side);
+            } else if (renderMode == ELECTRON_CLOUD) {
+                // The cloud of the new orbital starts over and fills in over the next frames
+                electronCloud.SetOrbital(orbital);
+            } else if (renderMode == VOLUME) {
+                evaluateDensityVolume(orbital, numSpheres_per_side, densityVolume.data());
+                volumeTex.Update(densityVolume.data(), volumeSize, volumeSize, volumeSize);
+                if (showIsosurfaces) {
+                    isosurfaces.SetVolumeGrid(isoGridKey(numSpheres_per_side), densityVolume.data(), numSpheres_per_side);
+                    isoGridChanged = true;
+                }
+            } else if (asyncGeneration) {
+                // The current spheres stay until the coarse grid of the new orbital is in
+                gridWorker.Start(orbital, numSpheres_per_side);
+                // Nothing of the new job has replaced them yet
+                refinedSpheres = 0;
+            } else {
+                const size_t previousNumSpheres = numSpheres;
+                spheres = loadSpheres();
+                if (showIsosurfaces) {
+                    isosurfaces.SetSphereGrid(isoGridKey(numSpheres_per_side), spheres, numSpheres_per_side);
+                    isoGridChanged = true;
+                }
+                if (renderMode == INSTANCED && useSphereLODs) {
+                    spheresChanged = true;
+                } else if (usesSphereChunks) {
+                    sphereChunks.Build(spheres, numSpheres, instanceVBO);
+                } else if (renderMode == INSTANCED || renderMode == IMPOSTOR) {
+                    if (numSpheres == previousNumSpheres) {
+                        instanceVBO.Update((const GLfloat*)spheres, numSpheres * sizeof(SphereInstance));
+                    } else {
+                        instanceVBO.Resize((const GLfloat*)spheres, numSpheres * sizeof(SphereInstance));
+                    }
+                } else {
+                    GLfloat* meshVertices;
+                    GLsizeiptr meshSize;
+                    if (compactVertices) {
+                        compactMesh_Vertices.resize(numSpheres * NUM_VERTICES_PER_SPHERE);
+                        writeCompactSphereMeshVertices(spheres, numSpheres, compactMesh_Vertices.data());
+                        meshVertices = (GLfloat*)compactMesh_Vertices.data();
+                        meshSize = compactMesh_Vertices.size() * sizeof(CompactVertex);
+                    } else {
+                        sphereMesh_Vertices.resize(numSpheres * NUM_VERTICES_PER_SPHERE * NUM_FLOATS_PER_VERTEX);
+                        writeSphereMeshVertices(spheres, numSpheres, sphereMesh_Vertices.data());
+                        meshVertices = sphereMesh_Vertices.data();
+                        meshSize = sphereMesh_Vertices.size() * sizeof(GLfloat);
+                    }
+                    if (numSpheres == previousNumSpheres) {
+                        VBO4.Update(meshVertices, meshSize);
+                    } else {
+                        VBO4.Resize(meshVertices, meshSize);
+                        sphereMesh_Indices.resize(numSpheres * singleSphere_IndicesVec.size());
+                        writeSphereMeshIndices(singleSphere_IndicesVec, numSpheres, sphereMesh_Indices.data());
+                        // The EBO is part of VAO4, so it is bound while the indices are replaced
+                        VAO4.Bind();
+                        EBO4.Resize(sphereMesh_Indices.data(), sphereMesh_Indices.size() * sizeof(GLuint));
+                        VAO4.Unbind();
+                    }
+                }
+                VBO4.Unbind();
+                orbitalCache.Unmap();
+            }
+        }
         // Updates and exports the camera matrix to the Vertex Shader
-        camera.updateMatrix(45.0f, 0.1f, 100.0f);
+        camera.updateMatrix(FOV, 0.1f, farPlane);
 
 
-        // Tells OpenGL which Shader Program we want to use
-        shaderProgram.Activate();
-        // Exports the camera Position to the Fragment Shader for specular lighting
-        glUniform3f(glGetUniformLocation(shaderProgram.ID, "camPos"), camera.Position.x, camera.Position.y, camera.Position.z);
-        // Export the camMatrix to the Vertex Shader
-        camera.Matrix(shaderProgram, "camMatrix");
-        // Binds texture so that it appears in rendering
-        brickTex.Bind();
-        
-        
-        // Bind VAO1 (bind x axis)
-        VAO1.Bind();
-        // Draw primitives, number of indices, datatype of indices, index of indices
-        glDrawElements(GL_TRIANGLES, sizeof(xAxisIndices) / sizeof(int), GL_UNSIGNED_INT, 0);
-
-        // Bind VAO2 (bind y axis)
-        VAO2.Bind();
-        // Draw primitives, number of indices, datatype of indices, index of indices
-        glDrawElements(GL_TRIANGLES, sizeof(yAxisIndices) / sizeof(int), GL_UNSIGNED_INT, 0);
-        
-        // Bind VAO3 (bind z axis)
-        VAO3.Bind();
-        // Draw primitives, number of indices, datatype of indices, index of indices
-        glDrawElements(GL_TRIANGLES, sizeof(zAxisIndices) / sizeof(int), GL_UNSIGNED_INT, 0);
+        // The axes and the light are opaque, so they are drawn before the spheres (which may be translucent)
+        // The queue binds each program, vertex array and texture once and exports the camera once per program
+        profiler.BeginGpu("axes and light");
+        // One set of axes per orbital, moved there by the model matrix
+        for (const glm::vec3& axesOffset : axesOffsets) {
+            renderQueue.Submit({ &shaderProgram, axesVAO.ID, &brickTex, glm::translate(pyramidModel, axesOffset), (GLsizei)axesIndices.size() });
+        }
+        renderQueue.Submit({ &lightShader, lightVAO.ID, NULL, lightModel, (GLsizei)std::size(lightIndices) });
+        renderQueue.Flush(camera, profiler);
+        profiler.EndGpu();
+
+        // Uploads the slabs gridWorker finished since the last frame. The coarse level is switched to once it is
+        // complete, then the requested grid replaces it slab by slab (progressive refinement): the spheres that are
+        // drawn are the slabs of the requested grid that are in, followed by the coarse spheres beyond them
+        GridSlab slab;
+        // Spheres at the front of the requested grid that are in (slabs come in order)
+        size_t receivedSpheres = refinedSpheres;
+        while (asyncGeneration && gridWorker.Poll(slab)) {
+            const std::vector<SphereInstance>& level = gridWorker.levels[slab.level];
+            // The requested grid fills the front of instanceVBO and the coarse one follows it, so a level is never
+            // uploaded over the one that is drawn
+            const bool requestedLevel = slab.level == (int)gridWorker.levels.size() - 1;
+            // A cached requested grid comes in whole and replaces the drawn spheres at once, like a coarse level
+            const bool refining = requestedLevel && slab.level > 0 && !slab.cached;
+            const GLintptr levelOffset = requestedLevel ? 0 : numGridSpheres * sizeof(SphereInstance);
+            if (usesInstanceVBO && !usesSphereChunks && !refining) {
+                instanceVBO.Update((const GLfloat*)&level[slab.first], slab.count * sizeof(SphereInstance), levelOffset + slab.first * sizeof(SphereInstance));
+                instanceVBO.Unbind();
+            }
+            if (refining) {
+                receivedSpheres = slab.first + slab.count;
+            }
+            if (slab.levelDone) {
+                profiler.RecordCpu("Grid evaluation " + std::to_string(gridWorker.levelSides[slab.level]) + "^3 (background)", slab.levelMs);
+                // The coarse grid has its own surfaces until the requested one is done
+                if (showIsosurfaces) {
+                    isosurfaces.SetSphereGrid(isoGridKey(gridWorker.levelSides[slab.level]), level.data(), gridWorker.levelSides[slab.level]);
+                    isoGridChanged = true;
+                }
+                if (!refining) {
+                    sphereInstances.assign(level.begin(), level.end());
+                    spheres = sphereInstances.data();
+                    numSpheres = sphereInstances.size();
+                    // The requested grid of this job starts replacing it with its next slabs (unless this is the requested grid)
+                    refinedSpheres = receivedSpheres = 0;
+                    if (useSphereLODs) {
+                        spheresChanged = true;
+                    } else if (usesSphereChunks) {
+                        // With room for the requested grid, which replaces this one in place
+                        sphereChunks.Build(spheres, numSpheres, instanceVBO, instanceCapacity);
+                    } else {
+                        linkInstanceAttribs(levelOffset);
+                    }
+                }
+            }
+        }
+        if (receivedSpheres > refinedSpheres) {
+            const std::vector<SphereInstance>& coarse = gridWorker.levels[0];
+            const std::vector<SphereInstance>& requested = gridWorker.levels.back();
+            // The coarse spheres are in order of x too, so the ones beyond the last slab that is in are their back
+            const GLfloat refinedX = requested[receivedSpheres - 1].x;
+            std::vector<SphereInstance>::const_iterator coarseRest = std::partition_point(coarse.begin(), coarse.end(),
+                [&](const SphereInstance& sphere) { return sphere.x <= refinedX; });
+            // Everything up to the first slab that came in this frame is drawn as it was
+            const size_t firstChanged = refinedSpheres;
+            sphereInstances.resize(firstChanged);
+            sphereInstances.insert(sphereInstances.end(), requested.begin() + firstChanged, requested.begin() + receivedSpheres);
+            sphereInstances.insert(sphereInstances.end(), coarseRest, coarse.end());
+            spheres = sphereInstances.data();
+            numSpheres = sphereInstances.size();
+            if (useSphereLODs) {
+                spheresChanged = true;
+            } else if (usesSphereChunks) {
+                sphereChunks.Refresh(spheres, numSpheres, firstChanged, instanceVBO);
+            } else if (usesInstanceVBO) {
+                // The front of instanceVBO, which the coarse level was not drawn from
+                instanceVBO.Update((const GLfloat*)&sphereInstances[firstChanged], (numSpheres - firstChanged) * sizeof(SphereInstance), firstChanged * sizeof(SphereInstance));
+                instanceVBO.Unbind();
+                if (firstChanged == 0) {
+                    linkInstanceAttribs(0);
+                }
+            }
+            refinedSpheres = receivedSpheres;
+        }
 
-        // Bind VAO4 (bind all spheres)
-        VAO4.Bind();
-        // Draw primitives, number of indices, datatype of indices, index of indices
-        glDrawElements(GL_TRIANGLES, sizeof(allSpheres_IndicesArr) / sizeof(int), GL_UNSIGNED_INT, 0);
+        // Extracts the isosurfaces again when the grid or the levels changed (. and , are read every frame)
+        if (showIsosurfaces && (isoLevelSelector.Inputs(window) || isoGridChanged) && isosurfaces.side > 0) {
+            updateIsosurfaces();
+            isoGridChanged = false;
+        }
 
+        // Adds the next batch of electron positions until the cloud is complete
+        if (renderMode == ELECTRON_CLOUD) {
+            electronCloud.Accumulate();
+        }
 
-        
-        // Tells OpenGL which Shader Program we want to use
-        lightShader.Activate();
-        // Export the camMatrix to the Vertex Shader of the light cube
-        camera.Matrix(lightShader, "camMatrix");
-        // Bind the VAO so OpenGL knows to use it
-        lightVAO.Bind();
-        // Draw primitives, number of indices, datatype of indices, index of indices
-        glDrawElements(GL_TRIANGLES, sizeof(lightIndices) / sizeof(int), GL_UNSIGNED_INT, 0);
+        // Keep only the chunks inside the view in instanceVBO
+        size_t numDrawnSpheres = numSpheres;
+        if (usesSphereChunks) {
+            sphereChunks.Cull(camera, instanceVBO);
+            numDrawnSpheres = sphereChunks.visibleCount;
+        }
+
+        // With translucentSpheres the isosurfaces are part of the opaque pass, so the spheres are accumulated over them
+        if (showIsosurfaces && translucentSpheres) {
+            drawIsosurfaces(camera);
+        }
+        profiler.BeginGpu("spheres");
+        // The translucent spheres are accumulated in any order, tested against the depth of the axes and the light
+        if (translucentSpheres) {
+            oitBuffer.BeginTransparent();
+        }
+        // Bind VAO4 (bind all spheres)
+        VAO4.Bind();
+        if (renderMode == INSTANCED) {
+            // Tells OpenGL which Shader Program we want to use
+            instancedShader.Activate();
+            // Exports the camera Position and camMatrix to the instanced shaders
+            glUniform3f(instancedShader.Uniform("camPos"), camera.Position.x, camera.Position.y, camera.Position.z);
+            camera.Matrix(instancedShader, "camMatrix");
+            if (useSphereLODs) {
+                // Regroup the spheres by size on screen if needed and draw each group with its own unit sphere
+                sphereLODs.Update(spheres, numSpheres, camera, FOV, spheresChanged);
+                spheresChanged = false;
+                sphereLODs.Draw();
+                profiler.CountDraw(sphereLODs.lodCounts[0] + sphereLODs.lodCounts[1] + sphereLODs.lodCounts[2], sphereLODs.DrawnTriangles());
+            } else {
+                // Draw the unit sphere once per sphere instance
+                glDrawElementsInstanced(GL_TRIANGLES, sphereMesh_Indices.size(), GL_UNSIGNED_INT, 0, numDrawnSpheres);
+                profiler.CountDraw(numDrawnSpheres, numDrawnSpheres * (sphereMesh_Indices.size() / 3));
+            }
+        } else if (renderMode == IMPOSTOR) {
+            // Tells OpenGL which Shader Program we want to use
+            impostorShader.Activate();
+            // Exports the camera Position and camMatrix to the impostor shaders (the quads face the camera)
+            glUniform3f(impostorShader.Uniform("camPos"), camera.Position.x, camera.Position.y, camera.Position.z);
+            camera.Matrix(impostorShader, "camMatrix");
+            // Draw the quad once per sphere instance
+            glDrawElementsInstanced(GL_TRIANGLES, sphereMesh_Indices.size(), GL_UNSIGNED_INT, 0, numDrawnSpheres);
+            profiler.CountDraw(numDrawnSpheres, numDrawnSpheres * (sphereMesh_Indices.size() / 3));
+        } else if (renderMode == GPU_DENSITY) {
+            // Tells OpenGL which Shader Program we want to use
+            gpuDensityShader.Activate();
+            // Exports the camera Position and camMatrix to the GPU density shaders
+            glUniform3f(gpuDensityShader.Uniform("camPos"), camera.Position.x, camera.Position.y, camera.Position.z);
+            camera.Matrix(gpuDensityShader, "camMatrix");
+            // Draw the unit sphere once per grid point, the shader finds its grid point from gl_InstanceID
+            glDrawElementsInstanced(GL_TRIANGLES, sphereMesh_Indices.size(), GL_UNSIGNED_INT, 0, numSpheres);
+            profiler.CountDraw(numSpheres, numSpheres * (sphereMesh_Indices.size() / 3));
+        } else if (renderMode == VOLUME) {
+            // Tells OpenGL which Shader Program we want to use
+            volumeShader.Activate();
+            // Exports the camera Position and camMatrix to the volume shaders (the rays start at the camera)
+            glUniform3f(volumeShader.Uniform("camPos"), camera.Position.x, camera.Position.y, camera.Position.z);
+            camera.Matrix(volumeShader, "camMatrix");
+            volumeTex.Bind();
+            // Only the back faces, so every ray is marched once and also when the camera is inside the box
+            glEnable(GL_CULL_FACE);
+            glCullFace(GL_FRONT);
+            // The volume is composited over the axes (premultiplied alpha) and does not hide them in its depth
+            glDisable(GL_DEPTH_TEST);
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            glDrawElements(GL_TRIANGLES, sphereMesh_Indices.size(), GL_UNSIGNED_INT, 0);
+            profiler.CountDraw(1, sphereMesh_Indices.size() / 3);
+            glDisable(GL_BLEND);
+            glEnable(GL_DEPTH_TEST);
+            glDisable(GL_CULL_FACE);
+        } else if (renderMode == ELECTRON_CLOUD) {
+            // Tells OpenGL which Shader Program we want to use
+            electronShader.Activate();
+            // Export the camMatrix to the Vertex Shader of the electron positions
+            camera.Matrix(electronShader, "camMatrix");
+            // The positions add up in any order and are hidden by the axes, but do not hide each other
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_ONE, GL_ONE);
+            glDepthMask(GL_FALSE);
+            glPointSize(electronPointSize);
+            electronCloud.Draw();
+            profiler.CountDraw(electronCloud.count, 0);
+            glDepthMask(GL_TRUE);
+            glDisable(GL_BLEND);
+        } else if (renderMode == SUPERPOSITION) {
+            // Tells OpenGL which Shader Program we want to use
+            superpositionShader.Activate();
+            // Exports the camera Position and camMatrix to the superposition shaders
+            glUniform3f(superpositionShader.Uniform("camPos"), camera.Position.x, camera.Position.y, camera.Position.z);
+            camera.Matrix(superpositionShader, "camMatrix");
+            // Only the phases c_s e^(-i E_s t) change over time, everything per sphere is already on the GPU
+            GLfloat phases[2 * MAX_SUPERPOSED_STATES];
+            superpositionPhases(superposition, glfwGetTime() * atomicTimeUnitsPerSecond, phases);
+            glUniform2fv(superpositionShader.Uniform("phases"), MAX_SUPERPOSED_STATES, phases);
+            // Draw the unit sphere once per grid point
+            glDrawElementsInstanced(GL_TRIANGLES, sphereMesh_Indices.size(), GL_UNSIGNED_INT, 0, numSpheres);
+            profiler.CountDraw(numSpheres, numSpheres * (sphereMesh_Indices.size() / 3));
+        } else {
+            // Tells OpenGL which Shader Program we want to use
+            bakedShader.Activate();
+            // Exports the camera Position and camMatrix to the baked sphere shaders
+            glUniform3f(bakedShader.Uniform("camPos"), camera.Position.x, camera.Position.y, camera.Position.z);
+            camera.Matrix(bakedShader, "camMatrix");
+            // Draw primitives, number of indices, datatype of indices, index of indices
+            glDrawElements(GL_TRIANGLES, sphereMesh_Indices.size(), GL_UNSIGNED_INT, 0);
+            profiler.CountDraw(numSpheres, sphereMesh_Indices.size() / 3);
+        }
+        // Resolves the translucent spheres over the axes and the light
+        if (translucentSpheres) {
+            oitBuffer.Composite(oitCompositeShader);
+        }
+        profiler.EndGpu();
+        // The isosurfaces are blended over the opaque spheres (and the volume), which still show through them
+        if (showIsosurfaces && !translucentSpheres) {
+            drawIsosurfaces(camera);
+        }
 
         // Swap the back buffer with the front buffer
         glfwSwapBuffers(window);
         // Take care of all GLFW events
         glfwPollEvents();
+
+        // Shows the averaged stats next to the orbital in the window title
+        if (profiler.EndFrame() && showStats) {
+            std::string statsTitle = title + " | " + profiler.Summary();
+            glfwSetWindowTitle(window, statsTitle.c_str());
+        }
     }
 
 
 
     // ----- Delete all the objects we've created ------- //
+    gridWorker.Stop();
     
-    // x axis
-    VAO1.Delete();
-    VBO1.Delete();
-    EBO1.Delete();
-    
-    // y axis
-    VAO2.Delete();
-    VBO2.Delete();
-    EBO2.Delete();
-    
-    // z axis
-    VAO3.Delete();
-    VBO3.Delete();
-    EBO3.Delete();
+    // axes
+    axesVAO.Delete();
+    axesVBO.Delete();
+    axesEBO.Delete();
     
     // SPHERES
     VAO4.Delete();
     VBO4.Delete();
     EBO4.Delete();
+    instanceVBO.Delete();
+    superpositionVBO.Delete();
+    sphereLODs.Delete();
+    sphereChunks.Delete();
     
     brickTex.Delete();
+    volumeTex.Delete();
+    oitBuffer.Delete();
+    profiler.Delete();
     shaderProgram.Delete();
+    bakedShader.Delete();
+    instancedShader.Delete();
+    impostorShader.Delete();
+    gpuDensityShader.Delete();
+    volumeShader.Delete();
+    superpositionShader.Delete();
+    oitCompositeShader.Delete();
+    electronCloud.Delete();
+    electronShader.Delete();
     lightVAO.Delete();
     lightVBO.Delete();
     lightEBO.Delete();
     lightShader.Delete();
+    isoVAO.Delete();
+    isoVBO.Delete();
+    isosurfaceShader.Delete();
     
     // Delete window before ending the program
     glfwDestroyWindow(window);
@@ -1872,100 +1465,3 @@ int main()
     glfwTerminate();
     return 0;
 }
-
-
-
-
-
-//------------------------------------FUNCTIONS----------------------------------------------------//
-
-GLfloat r_of (GLfloat x, GLfloat y, GLfloat z) {
-    return sqrt(x*x + y*y + z*z);
-}
-GLfloat theta_of (GLfloat x, GLfloat y, GLfloat z) {
-    GLfloat r = sqrt(x*x + y*y + z*z);
-    return acos(z / r);
-}
-GLfloat phi_of (GLfloat x, GLfloat y, GLfloat z) {
-    return atan2(y, x);
-}
-
-//-----------------------------------EQUATIONS-----------------------------------------------------//
-// r -> distance from origin, theta -> polar angle, phi -> azimuthal angle
-// All return the probability DENSITY (wavefunction squared) as GLfloat
-
-// (n=1,l=0,ml=0)
-GLfloat _100_eq(GLfloat r, GLfloat theta, GLfloat phi) {
-    const GLfloat max_prob_amp = 1.0f * std::pow(10, 0); // Calculate manually
-
-    GLfloat wavefunction = 1 / max_prob_amp * exp(-r) / sqrt(PI);
-    return pow(wavefunction, 2);
-}
-
-// (n=2,l=0,ml=0)
-GLfloat _200_eq(GLfloat r, GLfloat theta, GLfloat phi) {
-    const GLfloat max_prob_amp = 1.0f * std::pow(10, -1); // Calculate manually
-    
-    GLfloat wavefunction = 1 / max_prob_amp * 1/8 / pow(2.0*PI, 0.5) * (2-r) * exp(-r/2);
-    return pow(wavefunction, 2);
-}
-
-// (n=2,l=1,ml=0)
-GLfloat _210_eq(GLfloat r, GLfloat theta, GLfloat phi) {
-    const GLfloat max_prob_amp = 8.7f * std::pow(10, -1); // Calculate manually
-
-    GLfloat wavefunction = 1 / max_prob_amp * r * exp(-r/2) * cos(theta);
-    return pow(wavefunction, 2);
-}
-
-// (n=2,l=1,ml=+/-1)
-GLfloat _211_eq(GLfloat r, GLfloat theta, GLfloat phi) {
-    const GLfloat max_prob_amp = 7.5 * std::pow(10, -1); // Calculate manually
-
-    // The imaginary portion is not included here because in the probability density the conplex conjugate cancels it out.
-    GLfloat wavefunction = 1 / max_prob_amp * r * exp(-r/2) * sin(theta);
-    return pow(wavefunction, 2);
-}
-
-GLfloat _300_eq(GLfloat r, GLfloat theta, GLfloat phi) {
-    const GLfloat max_prob_amp = 25 * std::pow(10, -1); // Calculate manually
-
-    GLfloat wavefunction = 1 / max_prob_amp * (27 - 18*r + 2*r*r) * exp(-r/2);
-    return pow(wavefunction, 2);
-}
-
-GLfloat _310_eq(GLfloat r, GLfloat theta, GLfloat phi) {
-    const GLfloat max_prob_amp = 4 * std::pow(10, 0); // Calculate manually
-
-    GLfloat wavefunction = 1 / max_prob_amp * (6 - r) * r * exp(-r/3) * cos(theta);
-    return pow(wavefunction, 2);
-}
-
-GLfloat _311_eq(GLfloat r, GLfloat theta, GLfloat phi) {
-    const GLfloat max_prob_amp = 4.5 * std::pow(10, 0); // Calculate manually
-
-    GLfloat wavefunction = 1 / max_prob_amp * (6 - r) * r * exp(-r/3) * sin(theta);
-    return pow(wavefunction, 2);
-}
-
-GLfloat _320_eq(GLfloat r, GLfloat theta, GLfloat phi) {
-    const GLfloat max_prob_amp = 92.f * std::pow(10, -1); // Calculate manually
-
-    GLfloat wavefunction = 1 / max_prob_amp * pow(r,2) * exp(-r/3) * (3 * pow(cos(theta) , 2) - 1);
-    return pow(wavefunction, 2);
-}
-
-GLfloat _321_eq(GLfloat r, GLfloat theta, GLfloat phi) {
-    const GLfloat max_prob_amp = 25.f * std::pow(10, -1); // Calculate manually
-
-    GLfloat wavefunction = 1 / max_prob_amp * pow(r,2) * exp(-r/3) * sin(theta) * cos(theta);
-    return pow(wavefunction, 2);
-}
-
-GLfloat _322_eq(GLfloat r, GLfloat theta, GLfloat phi) {
-    const GLfloat max_prob_amp = 48.f * std::pow(10, -1); // Calculate manually
-
-    GLfloat wavefunction = 1 / max_prob_amp * pow(r,2) * exp(-r/3) * pow(sin(theta) , 2);
-    return pow(wavefunction, 2);
-}
-//-------------------------------END EQUATIONS-----------------------------------------------------//